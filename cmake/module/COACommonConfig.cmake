@@ -16,6 +16,15 @@ if(NOT CMAKE_BUILD_TYPE)
   set(CMAKE_BUILD_TYPE "RelWithDebInfo")
 endif()
 
+# -----------------------------------------------------------------------------
+# Sanitizers
+# -----------------------------------------------------------------------------
+if(COA_SANITIZE)
+  message(STATUS "Enabling address and undefined behavior sanitizers")
+  add_compile_options(-fsanitize=address,undefined -fno-omit-frame-pointer)
+  add_link_options(-fsanitize=address,undefined)
+endif()
+
 # -----------------------------------------------------------------------------
 # Variables
 # -----------------------------------------------------------------------------
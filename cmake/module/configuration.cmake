@@ -9,3 +9,4 @@ include(COASetupCodacEnvironment)
 # Dependencies
 # -----------------------------------------------------------------------------
 find_package(LibXml2 REQUIRED)
+find_package(Threads REQUIRED)
@@ -0,0 +1,387 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "flat_tree_data.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <algorithm>
+#include <stack>
+#include <string>
+#include <utility>
+
+namespace
+{
+using sup::xml::FlatTreeData;
+bool EqualFlatAttributes(const FlatTreeData& left, FlatTreeData::NodeIndex left_node,
+                         const FlatTreeData& right, FlatTreeData::NodeIndex right_node);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+FlatTreeData::FlatTreeData(std::string_view root_name)
+  : m_nodes{}
+  , m_attributes{}
+  , m_strings{}
+{
+  (void)m_nodes.push_back({ AddString(root_name), {0, 0}, kInvalidNode, kInvalidNode,
+                            kInvalidNode, kInvalidNode, 0, 0, 0 });
+}
+
+FlatTreeData::~FlatTreeData() = default;
+
+FlatTreeData::FlatTreeData(const FlatTreeData& other) = default;
+FlatTreeData::FlatTreeData(FlatTreeData&& other) noexcept = default;
+
+FlatTreeData& FlatTreeData::operator=(const FlatTreeData& other) & = default;
+FlatTreeData& FlatTreeData::operator=(FlatTreeData&& other) & noexcept = default;
+
+void FlatTreeData::Reserve(std::size_t n_nodes, std::size_t n_attributes, std::size_t n_chars)
+{
+  m_nodes.reserve(n_nodes);
+  m_attributes.reserve(n_attributes);
+  m_strings.reserve(n_chars);
+}
+
+std::size_t FlatTreeData::GetNumberOfNodes() const
+{
+  return m_nodes.size();
+}
+
+FlatTreeData::NodeIndex FlatTreeData::Root() const
+{
+  return 0;
+}
+
+FlatTreeData::NodeIndex FlatTreeData::AddChild(NodeIndex parent, std::string_view node_name)
+{
+  if (parent >= m_nodes.size())
+  {
+    std::string message = "FlatTreeData::AddChild(): parent index [" + std::to_string(parent) +
+      "] out of range";
+    throw InvalidOperationException(message);
+  }
+  const NodeIndex index = m_nodes.size();
+  auto name_ref = AddString(node_name);
+  (void)m_nodes.push_back({ name_ref, {0, 0}, parent, kInvalidNode, kInvalidNode, kInvalidNode,
+                            m_attributes.size(), 0, 0 });
+  auto& parent_node = m_nodes[parent];
+  if (parent_node.last_child == kInvalidNode)
+  {
+    parent_node.first_child = index;
+  }
+  else
+  {
+    m_nodes[parent_node.last_child].next_sibling = index;
+  }
+  parent_node.last_child = index;
+  ++parent_node.n_children;
+  return index;
+}
+
+void FlatTreeData::AddAttribute(NodeIndex node, std::string_view name, std::string_view value)
+{
+  if (node + 1 != m_nodes.size())
+  {
+    std::string message = "FlatTreeData::AddAttribute(): attributes can only be added to the last "
+      "added node";
+    throw InvalidOperationException(message);
+  }
+  if (HasAttribute(node, name))
+  {
+    std::string message = "FlatTreeData::AddAttribute(): attribute with name [" +
+      std::string(name) + "] already exists";
+    throw InvalidOperationException(message);
+  }
+  auto name_ref = AddString(name);
+  auto value_ref = AddString(value);
+  (void)m_attributes.push_back({ name_ref, value_ref });
+  ++m_nodes[node].n_attributes;
+}
+
+void FlatTreeData::SetContent(NodeIndex node, std::string_view content)
+{
+  (void)GetNode(node);
+  auto& content_ref = m_nodes[node].content;
+  if (content.size() > content_ref.size)
+  {
+    content_ref = AddString(content);
+    return;
+  }
+  // Reuse the previous slot; the content may alias it, hence move instead of copy.
+  if (!content.empty())
+  {
+    (void)std::char_traits<char>::move(&m_strings[content_ref.offset], content.data(),
+                                       content.size());
+  }
+  content_ref.size = content.size();
+}
+
+std::string_view FlatTreeData::GetNodeName(NodeIndex node) const
+{
+  return GetString(GetNode(node).name);
+}
+
+std::string_view FlatTreeData::GetContent(NodeIndex node) const
+{
+  return GetString(GetNode(node).content);
+}
+
+std::size_t FlatTreeData::GetNumberOfAttributes(NodeIndex node) const
+{
+  return GetNode(node).n_attributes;
+}
+
+std::string_view FlatTreeData::GetAttributeName(NodeIndex node, std::size_t attr_idx) const
+{
+  return GetString(GetAttributeEntry(node, attr_idx).name);
+}
+
+std::string_view FlatTreeData::GetAttributeValue(NodeIndex node, std::size_t attr_idx) const
+{
+  return GetString(GetAttributeEntry(node, attr_idx).value);
+}
+
+bool FlatTreeData::HasAttribute(NodeIndex node, std::string_view name) const
+{
+  const auto n_attributes = GetNumberOfAttributes(node);
+  for (std::size_t idx = 0; idx < n_attributes; ++idx)
+  {
+    if (GetAttributeName(node, idx) == name)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string_view FlatTreeData::GetAttribute(NodeIndex node, std::string_view name) const
+{
+  const auto n_attributes = GetNumberOfAttributes(node);
+  for (std::size_t idx = 0; idx < n_attributes; ++idx)
+  {
+    if (GetAttributeName(node, idx) == name)
+    {
+      return GetAttributeValue(node, idx);
+    }
+  }
+  std::string message = "FlatTreeData::GetAttribute(): attribute with name [" +
+    std::string(name) + "] does not exist";
+  throw InvalidOperationException(message);
+}
+
+std::size_t FlatTreeData::GetNumberOfChildren(NodeIndex node) const
+{
+  return GetNode(node).n_children;
+}
+
+FlatTreeData::NodeIndex FlatTreeData::Parent(NodeIndex node) const
+{
+  return GetNode(node).parent;
+}
+
+FlatTreeData::NodeIndex FlatTreeData::FirstChild(NodeIndex node) const
+{
+  return GetNode(node).first_child;
+}
+
+FlatTreeData::NodeIndex FlatTreeData::NextSibling(NodeIndex node) const
+{
+  return GetNode(node).next_sibling;
+}
+
+FlatTreeData::StringRef FlatTreeData::AddString(std::string_view str)
+{
+  StringRef result{ m_strings.size(), str.size() };
+  (void)m_strings.append(str.data(), str.size());
+  return result;
+}
+
+std::string_view FlatTreeData::GetString(const StringRef& ref) const
+{
+  return std::string_view{m_strings}.substr(ref.offset, ref.size);
+}
+
+const FlatTreeData::Node& FlatTreeData::GetNode(NodeIndex node) const
+{
+  if (node >= m_nodes.size())
+  {
+    std::string message = "FlatTreeData::GetNode(): node index [" + std::to_string(node) +
+      "] out of range";
+    throw InvalidOperationException(message);
+  }
+  return m_nodes[node];
+}
+
+const FlatTreeData::Attribute& FlatTreeData::GetAttributeEntry(NodeIndex node,
+                                                               std::size_t attr_idx) const
+{
+  const auto& node_entry = GetNode(node);
+  if (attr_idx >= node_entry.n_attributes)
+  {
+    std::string message = "FlatTreeData::GetAttributeEntry(): attribute index [" +
+      std::to_string(attr_idx) + "] out of range";
+    throw InvalidOperationException(message);
+  }
+  return m_attributes[node_entry.first_attribute + attr_idx];
+}
+
+bool operator==(const FlatTreeData& left, const FlatTreeData& right)
+{
+  if (left.GetNumberOfNodes() != right.GetNumberOfNodes())
+  {
+    return false;
+  }
+  // Simultaneous pre-order traversal, so trees built in a different order still compare equal.
+  std::stack<std::pair<FlatTreeData::NodeIndex, FlatTreeData::NodeIndex>> stack;
+  stack.push({left.Root(), right.Root()});
+  while (!stack.empty())
+  {
+    const auto [left_node, right_node] = stack.top();
+    stack.pop();
+    if (left.GetNodeName(left_node) != right.GetNodeName(right_node) ||
+        left.GetContent(left_node) != right.GetContent(right_node) ||
+        left.GetNumberOfChildren(left_node) != right.GetNumberOfChildren(right_node) ||
+        !EqualFlatAttributes(left, left_node, right, right_node))
+    {
+      return false;
+    }
+    auto left_child = left.FirstChild(left_node);
+    auto right_child = right.FirstChild(right_node);
+    while (left_child != FlatTreeData::kInvalidNode)
+    {
+      stack.push({left_child, right_child});
+      left_child = left.NextSibling(left_child);
+      right_child = right.NextSibling(right_child);
+    }
+  }
+  return true;
+}
+
+bool operator!=(const FlatTreeData& left, const FlatTreeData& right)
+{
+  return !(left == right);
+}
+
+FlatTreeData FlatTreeDataFromTreeData(const TreeData& tree)
+{
+  FlatTreeData result{tree.NodeName()};
+  std::stack<std::pair<const TreeData*, FlatTreeData::NodeIndex>> stack;
+  stack.push({&tree, FlatTreeData::kInvalidNode});
+  while (!stack.empty())
+  {
+    const auto [current, parent] = stack.top();
+    stack.pop();
+    const auto index = parent == FlatTreeData::kInvalidNode
+                         ? result.Root()
+                         : result.AddChild(parent, current->NodeName());
+    for (const auto& attr : current->Attributes())
+    {
+      result.AddAttribute(index, attr.first, attr.second);
+    }
+    if (!current->Content().empty())
+    {
+      result.SetContent(index, current->Content());
+    }
+    // Push children in reverse order, so they are added depth-first in document order.
+    const auto& children = current->Children();
+    for (auto it = children.rbegin(); it != children.rend(); ++it)
+    {
+      stack.push({&*it, index});
+    }
+  }
+  return result;
+}
+
+TreeData TreeDataFromFlatTreeData(const FlatTreeData& flat_tree)
+{
+  struct StackNode
+  {
+    TreeData* tree;
+    FlatTreeData::NodeIndex next_child;
+  };
+  auto populate = [&flat_tree](TreeData& tree, FlatTreeData::NodeIndex node)
+  {
+    const auto n_attributes = flat_tree.GetNumberOfAttributes(node);
+    for (std::size_t idx = 0; idx < n_attributes; ++idx)
+    {
+      tree.AddAttribute(std::string(flat_tree.GetAttributeName(node, idx)),
+                        std::string(flat_tree.GetAttributeValue(node, idx)));
+    }
+    tree.SetContent(std::string(flat_tree.GetContent(node)));
+  };
+  const auto root = flat_tree.Root();
+  TreeData result{InternedString{flat_tree.GetNodeName(root)}};
+  populate(result, root);
+  // Children are constructed in place, see BuildTree in tree_data_parser_utils.cpp for why the
+  // pointers stay valid.
+  std::stack<StackNode> stack;
+  stack.push({&result, flat_tree.FirstChild(root)});
+  while (!stack.empty())
+  {
+    auto& top_node = stack.top();
+    const auto child = top_node.next_child;
+    if (child != FlatTreeData::kInvalidNode)
+    {
+      top_node.next_child = flat_tree.NextSibling(child);
+      auto& child_tree =
+        top_node.tree->EmplaceChild(InternedString{flat_tree.GetNodeName(child)});
+      populate(child_tree, child);
+      stack.push({&child_tree, flat_tree.FirstChild(child)});
+    }
+    else
+    {
+      stack.pop();
+    }
+  }
+  return result;
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+bool EqualFlatAttributes(const FlatTreeData& left, FlatTreeData::NodeIndex left_node,
+                         const FlatTreeData& right, FlatTreeData::NodeIndex right_node)
+{
+  const auto n_attributes = left.GetNumberOfAttributes(left_node);
+  if (n_attributes != right.GetNumberOfAttributes(right_node))
+  {
+    return false;
+  }
+  for (std::size_t idx = 0; idx < n_attributes; ++idx)
+  {
+    const auto name = left.GetAttributeName(left_node, idx);
+    if (!right.HasAttribute(right_node, name) ||
+        right.GetAttribute(right_node, name) != left.GetAttributeValue(left_node, idx))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}  // unnamed namespace
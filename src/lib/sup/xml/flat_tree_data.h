@@ -0,0 +1,251 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_FLAT_TREE_DATA_H_
+#define SUP_XML_FLAT_TREE_DATA_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Flat, index-based in-memory representation of an XML tree.
+ *
+ * @details All nodes are stored in a single contiguous table in the order they were added, the
+ * root node having index zero. For trees created by parsing or conversion, this is document order
+ * (pre-order); trees built with AddChild keep insertion order instead. Nodes refer to each other by index (parent, first child and next
+ * sibling) and all strings (names, attribute names/values and content) are stored in a single
+ * character arena. This allows large documents to be represented with only a handful of heap
+ * allocations.
+ *
+ * Attributes of a node are stored contiguously, so they can only be added to the last node that
+ * was added to the tree.
+ *
+ * String views returned by the accessors point into the character arena and are invalidated by
+ * any subsequent modification of the tree.
+ */
+class FlatTreeData
+{
+public:
+  using NodeIndex = std::size_t;
+
+  /**
+   * @brief Index value that indicates the absence of a node (e.g. parent of the root node).
+   */
+  static constexpr NodeIndex kInvalidNode = std::numeric_limits<NodeIndex>::max();
+
+  /**
+   * @brief Constructor.
+   *
+   * @param root_name Name of the root node.
+   */
+  explicit FlatTreeData(std::string_view root_name);
+
+  ~FlatTreeData();
+
+  /**
+   * @brief Copy/move Constructor.
+   */
+  FlatTreeData(const FlatTreeData& other);
+  FlatTreeData(FlatTreeData&& other) noexcept;
+
+  /**
+   * @brief Copy/move Assignment.
+   */
+  FlatTreeData& operator=(const FlatTreeData& other) &;
+  FlatTreeData& operator=(FlatTreeData&& other) & noexcept;
+
+  /**
+   * @brief Reserve storage to avoid reallocations while building the tree.
+   *
+   * @param n_nodes Total number of nodes.
+   * @param n_attributes Total number of attributes.
+   * @param n_chars Total number of characters of all strings.
+   */
+  void Reserve(std::size_t n_nodes, std::size_t n_attributes, std::size_t n_chars);
+
+  /**
+   * @brief Get total number of nodes in the tree.
+   *
+   * @return Number of nodes.
+   */
+  std::size_t GetNumberOfNodes() const;
+
+  /**
+   * @brief Get index of the root node.
+   *
+   * @return Index of the root node.
+   */
+  NodeIndex Root() const;
+
+  /**
+   * @brief Add a node as the last child of the given parent node.
+   *
+   * @param parent Index of the parent node.
+   * @param node_name Name of the new node.
+   *
+   * @return Index of the new node.
+   *
+   * @throw InvalidOperationException when the parent index is out of range.
+   */
+  NodeIndex AddChild(NodeIndex parent, std::string_view node_name);
+
+  /**
+   * @brief Add attribute with given name and value to the last added node.
+   *
+   * @param node Index of the node, which needs to be the last added node.
+   * @param name Attribute name.
+   * @param value Attribute value.
+   *
+   * @throw InvalidOperationException when the node is not the last added node or when an
+   * attribute with the given name already exists.
+   */
+  void AddAttribute(NodeIndex node, std::string_view name, std::string_view value);
+
+  /**
+   * @brief Set element content string.
+   *
+   * @param node Index of the node.
+   * @param content Content string.
+   *
+   * @details Overwrites if already present. Content that fits into the space of the previous
+   * content reuses it; longer content is appended to the character arena and the previous space is
+   * not reclaimed, so repeatedly growing the content of a node grows the arena.
+   *
+   * @throw InvalidOperationException when the node index is out of range.
+   */
+  void SetContent(NodeIndex node, std::string_view content);
+
+  /**
+   * @brief Retrieve the name of a node.
+   */
+  std::string_view GetNodeName(NodeIndex node) const;
+
+  /**
+   * @brief Retrieve the content string of a node.
+   */
+  std::string_view GetContent(NodeIndex node) const;
+
+  /**
+   * @brief Get number of attributes of a node.
+   */
+  std::size_t GetNumberOfAttributes(NodeIndex node) const;
+
+  /**
+   * @brief Retrieve the name of the attribute with the given position.
+   *
+   * @throw InvalidOperationException when the attribute index is out of range.
+   */
+  std::string_view GetAttributeName(NodeIndex node, std::size_t attr_idx) const;
+
+  /**
+   * @brief Retrieve the value of the attribute with the given position.
+   *
+   * @throw InvalidOperationException when the attribute index is out of range.
+   */
+  std::string_view GetAttributeValue(NodeIndex node, std::size_t attr_idx) const;
+
+  /**
+   * @brief Indicate presence of attribute with given name.
+   */
+  bool HasAttribute(NodeIndex node, std::string_view name) const;
+
+  /**
+   * @brief Get attribute value with given name.
+   *
+   * @throw InvalidOperationException when no attribute with the given name exists.
+   */
+  std::string_view GetAttribute(NodeIndex node, std::string_view name) const;
+
+  /**
+   * @brief Get number of children of a node.
+   */
+  std::size_t GetNumberOfChildren(NodeIndex node) const;
+
+  /**
+   * @brief Navigation: parent, first child and next sibling of a node.
+   *
+   * @return Index of the requested node or kInvalidNode if there is none.
+   */
+  NodeIndex Parent(NodeIndex node) const;
+  NodeIndex FirstChild(NodeIndex node) const;
+  NodeIndex NextSibling(NodeIndex node) const;
+
+private:
+  struct StringRef
+  {
+    std::size_t offset;
+    std::size_t size;
+  };
+  struct Attribute
+  {
+    StringRef name;
+    StringRef value;
+  };
+  struct Node
+  {
+    StringRef name;
+    StringRef content;
+    NodeIndex parent;
+    NodeIndex first_child;
+    NodeIndex last_child;
+    NodeIndex next_sibling;
+    std::size_t first_attribute;
+    std::size_t n_attributes;
+    std::size_t n_children;
+  };
+  StringRef AddString(std::string_view str);
+  std::string_view GetString(const StringRef& ref) const;
+  const Node& GetNode(NodeIndex node) const;
+  const Attribute& GetAttributeEntry(NodeIndex node, std::size_t attr_idx) const;
+
+  std::vector<Node> m_nodes;
+  std::vector<Attribute> m_attributes;
+  std::string m_strings;
+};
+
+bool operator==(const FlatTreeData& left, const FlatTreeData& right);
+bool operator!=(const FlatTreeData& left, const FlatTreeData& right);
+
+/**
+ * @brief Convert a TreeData to its flat representation.
+ */
+FlatTreeData FlatTreeDataFromTreeData(const TreeData& tree);
+
+/**
+ * @brief Convert a flat tree representation to TreeData.
+ */
+TreeData TreeDataFromFlatTreeData(const FlatTreeData& flat_tree);
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_FLAT_TREE_DATA_H_
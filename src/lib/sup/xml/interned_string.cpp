@@ -0,0 +1,461 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "interned_string.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+/**
+ * @brief Process-wide table of interned strings. Strings are stored in a deque, so their
+ * addresses (and the character buffers the lookup keys refer to) remain stable.
+ *
+ * @details The memory used by the table only grows, so a string that is rejected because it does
+ * not fit anymore will never be interned later. This guarantees that all handles to equal strings
+ * are either interned or owned.
+ */
+class InternTable
+{
+public:
+  InternTable();
+  ~InternTable() = default;
+
+  InternTable(const InternTable&) = delete;
+  InternTable& operator=(const InternTable&) = delete;
+
+  //! Intern the string, or return nullptr when it is not present and does not fit.
+  const std::string* Intern(std::string_view str);
+
+  const std::string* Find(std::string_view str) const;
+
+  //! Check if the string, when not present, would still be interned.
+  bool Fits(std::string_view str) const;
+
+private:
+  //! Approximate memory needed for storing and indexing the string.
+  static std::size_t EntrySize(std::string_view str);
+
+  mutable std::shared_mutex m_mtx;
+  std::deque<std::string> m_strings;
+  std::unordered_map<std::string_view, const std::string*> m_index;
+  std::size_t m_size;
+};
+
+const std::uintptr_t kOwnedTag = 1;
+
+InternTable& GetInternTable();
+
+/**
+ * @brief Per-thread cache in front of the shared table. It only refers to strings of that table,
+ * which are never released, and is cleared when it reaches kMaxThreadCacheEntries.
+ */
+using ThreadCache = std::unordered_map<std::string_view, const std::string*>;
+
+const std::size_t kMaxThreadCacheEntries = 4096;
+
+ThreadCache& GetThreadCache();
+
+void AddToThreadCache(const std::string* interned);
+
+const std::string* EmptyString();
+
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+const std::size_t InternedString::kMaxInternedBytes = std::size_t{8} << 20;
+
+struct InternedString::OwnedString
+{
+  explicit OwnedString(std::string_view str_)
+    : ref_count{1}
+    , str{str_}
+  {}
+
+  std::atomic<std::size_t> ref_count;
+  const std::string str;
+};
+
+InternedString::InternedString()
+  : InternedString{EmptyString()}
+{}
+
+InternedString::InternedString(std::string_view str)
+  : m_handle{0}
+{
+  auto& cache = GetThreadCache();
+  auto it = cache.find(str);
+  if (it != cache.end())
+  {
+    m_handle = reinterpret_cast<std::uintptr_t>(it->second);
+    return;
+  }
+  auto interned = GetInternTable().Intern(str);
+  if (interned == nullptr)
+  {
+    // The table is full: this handle owns its copy of the string
+    m_handle = reinterpret_cast<std::uintptr_t>(new OwnedString{str}) | kOwnedTag;
+    return;
+  }
+  m_handle = reinterpret_cast<std::uintptr_t>(interned);
+  AddToThreadCache(interned);
+}
+
+InternedString::InternedString(const std::string& str)
+  : InternedString{std::string_view{str}}
+{}
+
+InternedString::InternedString(const char* str)
+  : InternedString{std::string_view{str}}
+{}
+
+InternedString::InternedString(const std::string* str)
+  : m_handle{reinterpret_cast<std::uintptr_t>(str)}
+{}
+
+InternedString::~InternedString()
+{
+  Release();
+}
+
+InternedString::InternedString(const InternedString& other)
+  : m_handle{other.m_handle}
+{
+  if ((m_handle & kOwnedTag) != 0)
+  {
+    auto owned = reinterpret_cast<OwnedString*>(m_handle & ~kOwnedTag);
+    (void)owned->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+InternedString::InternedString(InternedString&& other) noexcept
+  : m_handle{other.m_handle}
+{
+  other.m_handle = reinterpret_cast<std::uintptr_t>(EmptyString());
+}
+
+InternedString& InternedString::operator=(const InternedString& other) &
+{
+  InternedString copy{other};
+  std::swap(m_handle, copy.m_handle);
+  return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) & noexcept
+{
+  std::swap(m_handle, other.m_handle);
+  return *this;
+}
+
+bool InternedString::Find(std::string_view str, InternedString& result)
+{
+  auto& cache = GetThreadCache();
+  auto it = cache.find(str);
+  if (it != cache.end())
+  {
+    result = InternedString{it->second};
+    return true;
+  }
+  auto& table = GetInternTable();
+  auto interned = table.Find(str);
+  if (interned == nullptr)
+  {
+    if (table.Fits(str))
+    {
+      return false;
+    }
+    // Handles for this string own a copy of it
+    result = InternedString{str};
+    return true;
+  }
+  AddToThreadCache(interned);
+  result = InternedString{interned};
+  return true;
+}
+
+const std::string& InternedString::Str() const
+{
+  if ((m_handle & kOwnedTag) != 0)
+  {
+    return reinterpret_cast<const OwnedString*>(m_handle & ~kOwnedTag)->str;
+  }
+  return *reinterpret_cast<const std::string*>(m_handle);
+}
+
+InternedString::operator const std::string&() const
+{
+  return Str();
+}
+
+InternedString::operator std::string_view() const
+{
+  return Str();
+}
+
+const char* InternedString::c_str() const
+{
+  return Str().c_str();
+}
+
+std::size_t InternedString::size() const
+{
+  return Str().size();
+}
+
+bool InternedString::empty() const
+{
+  return Str().empty();
+}
+
+bool InternedString::IsInterned() const
+{
+  return (m_handle & kOwnedTag) == 0;
+}
+
+const std::string* InternedString::Handle() const
+{
+  return &Str();
+}
+
+std::size_t InternedString::Hash() const
+{
+  if (IsInterned())
+  {
+    return std::hash<const std::string*>{}(Handle());
+  }
+  return std::hash<std::string>{}(Str());
+}
+
+void InternedString::Release()
+{
+  if ((m_handle & kOwnedTag) == 0)
+  {
+    return;
+  }
+  auto owned = reinterpret_cast<OwnedString*>(m_handle & ~kOwnedTag);
+  if (owned->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    delete owned;
+  }
+}
+
+bool InternedStringOrder::operator()(const InternedString& left,
+                                     const InternedString& right) const
+{
+  if (left.IsInterned() != right.IsInterned())
+  {
+    return left.IsInterned();
+  }
+  if (left.IsInterned())
+  {
+    return left.Handle() < right.Handle();
+  }
+  return left.Str() < right.Str();
+}
+
+bool operator==(const InternedString& left, const InternedString& right)
+{
+  if (left.Handle() == right.Handle())
+  {
+    return true;
+  }
+  // Equal strings are either all interned or all owned
+  return !left.IsInterned() && !right.IsInterned() && left.Str() == right.Str();
+}
+
+bool operator!=(const InternedString& left, const InternedString& right)
+{
+  return !(left == right);
+}
+
+bool operator==(const InternedString& left, const std::string& right)
+{
+  return left.Str() == right;
+}
+
+bool operator!=(const InternedString& left, const std::string& right)
+{
+  return !(left == right);
+}
+
+bool operator==(const std::string& left, const InternedString& right)
+{
+  return right == left;
+}
+
+bool operator!=(const std::string& left, const InternedString& right)
+{
+  return !(right == left);
+}
+
+bool operator==(const InternedString& left, const char* right)
+{
+  return left.Str() == right;
+}
+
+bool operator!=(const InternedString& left, const char* right)
+{
+  return !(left == right);
+}
+
+bool operator==(const char* left, const InternedString& right)
+{
+  return right == left;
+}
+
+bool operator!=(const char* left, const InternedString& right)
+{
+  return !(right == left);
+}
+
+std::string operator+(const InternedString& left, const InternedString& right)
+{
+  return left.Str() + right.Str();
+}
+
+std::string operator+(const InternedString& left, const std::string& right)
+{
+  return left.Str() + right;
+}
+
+std::string operator+(const std::string& left, const InternedString& right)
+{
+  return left + right.Str();
+}
+
+std::string operator+(const InternedString& left, const char* right)
+{
+  return left.Str() + right;
+}
+
+std::string operator+(const char* left, const InternedString& right)
+{
+  return left + right.Str();
+}
+
+std::ostream& operator<<(std::ostream& stream, const InternedString& str)
+{
+  return stream << str.Str();
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+InternTable::InternTable()
+  : m_mtx{}
+  , m_strings{}
+  , m_index{}
+  , m_size{0}
+{}
+
+const std::string* InternTable::Intern(std::string_view str)
+{
+  {
+    std::shared_lock<std::shared_mutex> lk{m_mtx};
+    auto it = m_index.find(str);
+    if (it != m_index.end())
+    {
+      return it->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lk{m_mtx};
+  // Another thread may have interned the string in the meantime
+  auto it = m_index.find(str);
+  if (it != m_index.end())
+  {
+    return it->second;
+  }
+  const auto entry_size = EntrySize(str);
+  if (m_size + entry_size > sup::xml::InternedString::kMaxInternedBytes)
+  {
+    return nullptr;
+  }
+  const auto& stored = m_strings.emplace_back(str);
+  (void)m_index.emplace(std::string_view{stored}, &stored);
+  m_size += entry_size;
+  return &stored;
+}
+
+const std::string* InternTable::Find(std::string_view str) const
+{
+  std::shared_lock<std::shared_mutex> lk{m_mtx};
+  auto it = m_index.find(str);
+  return it == m_index.end() ? nullptr : it->second;
+}
+
+bool InternTable::Fits(std::string_view str) const
+{
+  std::shared_lock<std::shared_mutex> lk{m_mtx};
+  return m_size + EntrySize(str) <= sup::xml::InternedString::kMaxInternedBytes;
+}
+
+std::size_t InternTable::EntrySize(std::string_view str)
+{
+  // The string object, its heap buffer when not stored inline, and a node of the index
+  const std::size_t kIndexNodeSize = 48;
+  const std::size_t kInlineCapacity = 15;
+  const auto buffer_size = str.size() > kInlineCapacity ? str.size() + 1 : 0;
+  return sizeof(std::string) + buffer_size + kIndexNodeSize;
+}
+
+InternTable& GetInternTable()
+{
+  // Intentionally leaked, so interned strings stay valid during static destruction.
+  static InternTable* table = new InternTable();
+  return *table;
+}
+
+ThreadCache& GetThreadCache()
+{
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+void AddToThreadCache(const std::string* interned)
+{
+  auto& cache = GetThreadCache();
+  if (cache.size() >= kMaxThreadCacheEntries)
+  {
+    cache.clear();
+  }
+  (void)cache.emplace(std::string_view{*interned}, interned);
+}
+
+const std::string* EmptyString()
+{
+  static const std::string* empty = GetInternTable().Intern("");
+  return empty;
+}
+
+}  // unnamed namespace
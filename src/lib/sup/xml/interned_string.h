@@ -0,0 +1,172 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_INTERNED_STRING_H_
+#define SUP_XML_INTERNED_STRING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Handle to a string stored once in a process-wide interning table.
+ *
+ * @details Equal strings share the same handle, so comparing two interned strings reduces to a
+ * pointer comparison. This is used for the small vocabulary of element and attribute names that
+ * is repeated throughout XML documents. Interned strings are never released, so the table is
+ * limited to kMaxInternedBytes. Once a string no longer fits, each handle constructed for it owns
+ * a reference-counted copy instead, which is released with the last handle referring to it. A
+ * process that parses an open-ended set of names, e.g. from untrusted input, therefore only grows
+ * with the names of the trees it keeps. Such handles compare by content and are slightly more
+ * expensive to copy, but behave the same otherwise.
+ *
+ * The interning table is safe to use from multiple threads. Each thread keeps a small cache of the
+ * strings it looked up, so interning a known string does not lock the shared table.
+ */
+class InternedString
+{
+public:
+  //! Upper bound for the memory used by the interning table, including bookkeeping.
+  static const std::size_t kMaxInternedBytes;
+
+  /**
+   * @brief Construct a handle to the empty string.
+   */
+  InternedString();
+
+  /**
+   * @brief Construct a handle to the given string, interning it when not yet present.
+   */
+  explicit InternedString(std::string_view str);
+  explicit InternedString(const std::string& str);
+  explicit InternedString(const char* str);
+
+  ~InternedString();
+
+  InternedString(const InternedString& other);
+  InternedString(InternedString&& other) noexcept;
+  InternedString& operator=(const InternedString& other) &;
+  InternedString& operator=(InternedString&& other) & noexcept;
+
+  /**
+   * @brief Find the handle of a string without interning it.
+   *
+   * @param str String to look up.
+   * @param result Receives the handle when found.
+   *
+   * @return false when no handle equal to the string can exist, i.e. it was never interned and
+   * would still fit into the table.
+   */
+  static bool Find(std::string_view str, InternedString& result);
+
+  /**
+   * @brief Access the interned string.
+   */
+  const std::string& Str() const;
+  operator const std::string&() const;
+  operator std::string_view() const;
+
+  const char* c_str() const;
+  std::size_t size() const;
+  bool empty() const;
+
+  /**
+   * @brief Check if the string is stored in the interning table, rather than owned by the handle.
+   */
+  bool IsInterned() const;
+
+  /**
+   * @brief Address of the string. It uniquely identifies interned strings.
+   */
+  const std::string* Handle() const;
+
+  /**
+   * @brief Hash consistent with operator==.
+   */
+  std::size_t Hash() const;
+
+private:
+  struct OwnedString;
+  explicit InternedString(const std::string* str);
+  void Release();
+
+  // Address of the interned string or, with the lowest bit set, of an OwnedString
+  std::uintptr_t m_handle;
+};
+
+/**
+ * @brief Strict weak ordering consistent with operator==. It is cheap to evaluate, but does not
+ * order strings alphabetically.
+ */
+struct InternedStringOrder
+{
+  bool operator()(const InternedString& left, const InternedString& right) const;
+};
+
+bool operator==(const InternedString& left, const InternedString& right);
+bool operator!=(const InternedString& left, const InternedString& right);
+
+bool operator==(const InternedString& left, const std::string& right);
+bool operator!=(const InternedString& left, const std::string& right);
+bool operator==(const std::string& left, const InternedString& right);
+bool operator!=(const std::string& left, const InternedString& right);
+
+bool operator==(const InternedString& left, const char* right);
+bool operator!=(const InternedString& left, const char* right);
+bool operator==(const char* left, const InternedString& right);
+bool operator!=(const char* left, const InternedString& right);
+
+/**
+ * @brief Concatenation, as for the std::string the handle refers to.
+ */
+std::string operator+(const InternedString& left, const InternedString& right);
+std::string operator+(const InternedString& left, const std::string& right);
+std::string operator+(const std::string& left, const InternedString& right);
+std::string operator+(const InternedString& left, const char* right);
+std::string operator+(const char* left, const InternedString& right);
+
+std::ostream& operator<<(std::ostream& stream, const InternedString& str);
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace std
+{
+template <>
+struct hash<sup::xml::InternedString>
+{
+  std::size_t operator()(const sup::xml::InternedString& str) const noexcept
+  {
+    return str.Hash();
+  }
+};
+}  // namespace std
+
+#endif  // SUP_XML_INTERNED_STRING_H_
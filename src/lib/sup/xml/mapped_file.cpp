@@ -0,0 +1,94 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "mapped_file.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sup
+{
+namespace xml
+{
+
+MappedFile::MappedFile(const std::string& filename)
+  : m_data{nullptr}
+  , m_size{0}
+{
+  const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    std::string message = "sup::xml::MappedFile(): file not found [" + filename + "]";
+    throw ParseException(message);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0)
+  {
+    (void)close(fd);
+    std::string message = "sup::xml::MappedFile(): could not retrieve size of file [" +
+      filename + "]";
+    throw ParseException(message);
+  }
+  m_size = static_cast<std::size_t>(file_stat.st_size);
+  if (m_size > 0)
+  {
+    m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after closing the descriptor
+  (void)close(fd);
+  if (m_data == MAP_FAILED)
+  {
+    m_data = nullptr;
+    std::string message = "sup::xml::MappedFile(): could not map file [" + filename + "]";
+    throw ParseException(message);
+  }
+  if (m_data != nullptr)
+  {
+    (void)madvise(m_data, m_size, MADV_SEQUENTIAL);
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  if (m_data != nullptr)
+  {
+    (void)munmap(m_data, m_size);
+  }
+}
+
+const char* MappedFile::Data() const
+{
+  return static_cast<const char*>(m_data);
+}
+
+std::size_t MappedFile::Size() const
+{
+  return m_size;
+}
+
+}  // namespace xml
+
+}  // namespace sup
@@ -0,0 +1,75 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_MAPPED_FILE_H_
+#define SUP_XML_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Read-only memory mapping of a complete file.
+ *
+ * @details The mapping is advised for sequential access. The file should not be modified while
+ * it is mapped, since truncating it would make accesses to the mapped region fail.
+ */
+class MappedFile
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param filename Name of the file to map.
+   *
+   * @throw ParseException when the file could not be opened or mapped.
+   */
+  explicit MappedFile(const std::string& filename);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * @brief Start of the mapped region, or nullptr for an empty file.
+   */
+  const char* Data() const;
+
+  /**
+   * @brief Size of the mapped region.
+   */
+  std::size_t Size() const;
+
+private:
+  void* m_data;
+  std::size_t m_size;
+};
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_MAPPED_FILE_H_
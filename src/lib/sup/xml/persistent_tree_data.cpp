@@ -0,0 +1,571 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "persistent_tree_data.h"
+
+#include "tree_data_utils.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace sup
+{
+namespace xml
+{
+
+struct PersistentTreeData::Node
+{
+  explicit Node(InternedString node_name);
+  ~Node();
+
+  // Copies are shallow: the children of the copy are shared with the original
+  Node(const Node& other) = default;
+  Node& operator=(const Node& other) = delete;
+
+  InternedString m_node_name;
+  std::string m_content;
+  std::vector<Attribute> m_attributes;
+  std::vector<PersistentTreeData> m_children;
+};
+
+/**
+ * @brief Table of shared nodes, used to build trees in which identical subtrees are stored once.
+ */
+class PersistentTreeData::SubtreeTable
+{
+public:
+  SubtreeTable();
+
+  //! Build a shared copy of the given tree, reusing identical subtrees seen before.
+  template <typename Tree>
+  PersistentTreeData Share(const Tree& tree);
+
+private:
+  //! Stored node of an already shared input subtree, or nullptr for TreeData.
+  static const Node* SourceNode(const PersistentTreeData& tree);
+  static const Node* SourceNode(const TreeData& tree);
+
+  //! Look up or create the node with the given data and shared children.
+  template <typename Tree>
+  PersistentTreeData Intern(const Tree& source, std::vector<PersistentTreeData> children);
+
+  std::unordered_map<std::size_t, std::vector<std::shared_ptr<Node>>> m_nodes;
+  std::unordered_map<const Node*, PersistentTreeData> m_shared_sources;
+};
+
+PersistentTreeData::PersistentTreeData(std::string node_name)
+  : m_node{std::make_shared<Node>(InternedString{node_name})}
+{}
+
+PersistentTreeData::PersistentTreeData(InternedString node_name)
+  : m_node{std::make_shared<Node>(node_name)}
+{}
+
+PersistentTreeData::PersistentTreeData(const TreeData& tree)
+  : m_node{std::make_shared<Node>(tree.GetInternedNodeName())}
+{
+  std::vector<std::pair<const TreeData*, Node*>> stack{{&tree, m_node.get()}};
+  while (!stack.empty())
+  {
+    const auto [source, target] = stack.back();
+    stack.pop_back();
+    target->m_content = source->GetContent();
+    target->m_attributes = source->Attributes();
+    target->m_children.reserve(source->GetNumberOfChildren());
+    for (const auto& child : source->Children())
+    {
+      auto& copy = target->m_children.emplace_back(child.GetInternedNodeName());
+      stack.emplace_back(&child, copy.m_node.get());
+    }
+  }
+}
+
+PersistentTreeData::PersistentTreeData(std::shared_ptr<Node> node)
+  : m_node{std::move(node)}
+{}
+
+PersistentTreeData::~PersistentTreeData() = default;
+
+PersistentTreeData::PersistentTreeData(const PersistentTreeData& other) = default;
+
+PersistentTreeData::PersistentTreeData(PersistentTreeData&& other) noexcept = default;
+
+PersistentTreeData& PersistentTreeData::operator=(const PersistentTreeData& other) & = default;
+
+PersistentTreeData& PersistentTreeData::operator=(PersistentTreeData&& other) & noexcept = default;
+
+std::string PersistentTreeData::GetNodeName() const
+{
+  return m_node->m_node_name;
+}
+
+const InternedString& PersistentTreeData::GetInternedNodeName() const &
+{
+  return m_node->m_node_name;
+}
+
+std::string_view PersistentTreeData::NodeName() const &
+{
+  return m_node->m_node_name;
+}
+
+std::size_t PersistentTreeData::GetNumberOfAttributes() const
+{
+  return m_node->m_attributes.size();
+}
+
+bool PersistentTreeData::HasAttribute(const std::string& name) const
+{
+  return FindAttribute(name) != nullptr;
+}
+
+bool PersistentTreeData::HasAttribute(const InternedString& name) const
+{
+  const auto& attributes = m_node->m_attributes;
+  return std::any_of(attributes.begin(), attributes.end(),
+                     [&name](const Attribute& attr) { return attr.first == name; });
+}
+
+std::string PersistentTreeData::GetAttribute(const std::string& name) const
+{
+  auto value = FindAttribute(name);
+  if (value == nullptr)
+  {
+    std::string message = "PersistentTreeData::GetAttribute(): attribute with name [" +
+      name + "] does not exist";
+    throw InvalidOperationException(message);
+  }
+  return *value;
+}
+
+const std::string* PersistentTreeData::FindAttribute(std::string_view name) const &
+{
+  for (const auto& attr : m_node->m_attributes)
+  {
+    if (std::string_view{attr.first} == name)
+    {
+      return &attr.second;
+    }
+  }
+  return nullptr;
+}
+
+const std::vector<PersistentTreeData::Attribute>& PersistentTreeData::Attributes() const &
+{
+  return m_node->m_attributes;
+}
+
+void PersistentTreeData::AddAttribute(std::string name, std::string value)
+{
+  const InternedString interned_name{name};
+  if (HasAttribute(interned_name))
+  {
+    std::string message = "PersistentTreeData::AddAttribute(): attribute with name [" +
+      name + "] already exists";
+    throw InvalidOperationException(message);
+  }
+  (void)MutableNode().m_attributes.emplace_back(interned_name, std::move(value));
+}
+
+void PersistentTreeData::SetAttribute(const std::string& name, std::string value)
+{
+  const InternedString interned_name{name};
+  auto& attributes = MutableNode().m_attributes;
+  auto it = std::find_if(attributes.begin(), attributes.end(),
+                         [&interned_name](const Attribute& attr)
+                         { return attr.first == interned_name; });
+  if (it == attributes.end())
+  {
+    (void)attributes.emplace_back(interned_name, std::move(value));
+  }
+  else
+  {
+    it->second = std::move(value);
+  }
+}
+
+std::size_t PersistentTreeData::GetNumberOfChildren() const
+{
+  return m_node->m_children.size();
+}
+
+const std::vector<PersistentTreeData>& PersistentTreeData::Children() const &
+{
+  return m_node->m_children;
+}
+
+void PersistentTreeData::AddChild(PersistentTreeData child)
+{
+  MutableNode().m_children.push_back(std::move(child));
+}
+
+void PersistentTreeData::EmplaceChild(std::string node_name)
+{
+  (void)MutableNode().m_children.emplace_back(std::move(node_name));
+}
+
+void PersistentTreeData::UpdateChild(std::size_t idx,
+                                     const std::function<void(PersistentTreeData&)>& update)
+{
+  if (idx >= GetNumberOfChildren())
+  {
+    std::string message = "PersistentTreeData::UpdateChild(): child index [" +
+      std::to_string(idx) + "] out of range";
+    throw InvalidOperationException(message);
+  }
+  update(MutableNode().m_children[idx]);
+}
+
+void PersistentTreeData::UpdateNode(const std::vector<std::size_t>& path,
+                                    const std::function<void(PersistentTreeData&)>& update)
+{
+  PersistentTreeData* current = this;
+  for (const auto idx : path)
+  {
+    if (idx >= current->GetNumberOfChildren())
+    {
+      std::string message = "PersistentTreeData::UpdateNode(): child index [" +
+        std::to_string(idx) + "] out of range";
+      throw InvalidOperationException(message);
+    }
+    current = &current->MutableNode().m_children[idx];
+  }
+  update(*current);
+}
+
+void PersistentTreeData::RemoveChild(std::size_t idx)
+{
+  if (idx >= GetNumberOfChildren())
+  {
+    std::string message = "PersistentTreeData::RemoveChild(): child index [" +
+      std::to_string(idx) + "] out of range";
+    throw InvalidOperationException(message);
+  }
+  auto& children = MutableNode().m_children;
+  (void)children.erase(children.begin() + static_cast<std::ptrdiff_t>(idx));
+}
+
+void PersistentTreeData::SetContent(std::string content)
+{
+  MutableNode().m_content = std::move(content);
+}
+
+std::string PersistentTreeData::GetContent() const
+{
+  return m_node->m_content;
+}
+
+std::string_view PersistentTreeData::Content() const &
+{
+  return m_node->m_content;
+}
+
+bool PersistentTreeData::SharesNodeWith(const PersistentTreeData& other) const
+{
+  return m_node == other.m_node;
+}
+
+TreeData PersistentTreeData::ToTreeData() const
+{
+  // Children are completed before they are moved into their parent, so no references into child
+  // lists are kept while these lists grow.
+  struct ConvertStackNode
+  {
+    const Node* source;
+    TreeData target;
+    std::size_t next_child;
+  };
+  auto open_node = [](const Node& source)
+  {
+    TreeData target{source.m_node_name};
+    target.SetContent(source.m_content);
+    for (const auto& [name, value] : source.m_attributes)
+    {
+      target.AddAttribute(name, value);
+    }
+    return ConvertStackNode{&source, std::move(target), 0};
+  };
+  std::vector<ConvertStackNode> stack;
+  stack.push_back(open_node(*m_node));
+  while (true)
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.source->m_children;
+    if (top_node.next_child < children.size())
+    {
+      const auto& child = *children[top_node.next_child].m_node;
+      ++top_node.next_child;
+      stack.push_back(open_node(child));
+      continue;
+    }
+    if (stack.size() == 1)
+    {
+      break;
+    }
+    auto completed = std::move(top_node.target);
+    stack.pop_back();
+    stack.back().target.AddChild(std::move(completed));
+  }
+  return std::move(stack.back().target);
+}
+
+std::size_t PersistentTreeData::CountNodes() const
+{
+  // Subtree sizes are remembered per stored node, so shared subtrees are only visited once
+  std::unordered_map<const Node*, std::size_t> sizes;
+  std::vector<std::pair<const Node*, bool>> stack{{m_node.get(), false}};
+  while (!stack.empty())
+  {
+    const auto [node, children_done] = stack.back();
+    stack.pop_back();
+    if (sizes.count(node) > 0)
+    {
+      continue;
+    }
+    if (!children_done)
+    {
+      stack.emplace_back(node, true);
+      for (const auto& child : node->m_children)
+      {
+        stack.emplace_back(child.m_node.get(), false);
+      }
+      continue;
+    }
+    std::size_t size = 1;
+    for (const auto& child : node->m_children)
+    {
+      size += sizes[child.m_node.get()];
+    }
+    sizes[node] = size;
+  }
+  return sizes[m_node.get()];
+}
+
+std::size_t PersistentTreeData::CountDistinctNodes() const
+{
+  std::unordered_set<const Node*> visited{m_node.get()};
+  std::vector<const Node*> stack{m_node.get()};
+  while (!stack.empty())
+  {
+    const auto* node = stack.back();
+    stack.pop_back();
+    for (const auto& child : node->m_children)
+    {
+      if (visited.insert(child.m_node.get()).second)
+      {
+        stack.push_back(child.m_node.get());
+      }
+    }
+  }
+  return visited.size();
+}
+
+PersistentTreeData::Node& PersistentTreeData::MutableNode()
+{
+  if (m_node.use_count() != 1)
+  {
+    m_node = std::make_shared<Node>(*m_node);
+  }
+  return *m_node;
+}
+
+PersistentTreeData::Node::Node(InternedString node_name)
+  : m_node_name{node_name}
+  , m_content{}
+  , m_attributes{}
+  , m_children{}
+{}
+
+PersistentTreeData::Node::~Node()
+{
+  // Detach the children of nodes that are only owned by this subtree first, so every node is
+  // destroyed without children and destruction does not recurse. Nodes shared with other trees
+  // are left alone.
+  std::vector<PersistentTreeData> pending = std::move(m_children);
+  while (!pending.empty())
+  {
+    auto handle = std::move(pending.back());
+    pending.pop_back();
+    if (handle.m_node != nullptr && handle.m_node.use_count() == 1)
+    {
+      auto& children = handle.m_node->m_children;
+      std::move(children.begin(), children.end(), std::back_inserter(pending));
+      children.clear();
+    }
+  }
+}
+
+PersistentTreeData::SubtreeTable::SubtreeTable()
+  : m_nodes{}
+  , m_shared_sources{}
+{}
+
+template <typename Tree>
+PersistentTreeData PersistentTreeData::SubtreeTable::Share(const Tree& tree)
+{
+  // Post-order: a node is looked up once all of its children have been shared
+  struct ShareStackNode
+  {
+    const Tree* source;
+    std::size_t next_child;
+    std::vector<PersistentTreeData> children;
+  };
+  std::vector<ShareStackNode> stack;
+  stack.push_back({&tree, 0, {}});
+  while (true)
+  {
+    auto& top_node = stack.back();
+    const auto& source_children = top_node.source->Children();
+    if (top_node.next_child == 0)
+    {
+      top_node.children.reserve(source_children.size());
+    }
+    if (top_node.next_child < source_children.size())
+    {
+      const auto& child = source_children[top_node.next_child];
+      ++top_node.next_child;
+      const auto* source_node = SourceNode(child);
+      auto it = m_shared_sources.find(source_node);
+      if (source_node != nullptr && it != m_shared_sources.end())
+      {
+        top_node.children.push_back(it->second);
+        continue;
+      }
+      stack.push_back({&child, 0, {}});
+      continue;
+    }
+    auto shared = Intern(*top_node.source, std::move(top_node.children));
+    if (const auto* source_node = SourceNode(*top_node.source))
+    {
+      (void)m_shared_sources.emplace(source_node, shared);
+    }
+    stack.pop_back();
+    if (stack.empty())
+    {
+      return shared;
+    }
+    stack.back().children.push_back(std::move(shared));
+  }
+}
+
+const PersistentTreeData::Node* PersistentTreeData::SubtreeTable::SourceNode(
+  const PersistentTreeData& tree)
+{
+  return tree.m_node.get();
+}
+
+const PersistentTreeData::Node* PersistentTreeData::SubtreeTable::SourceNode(const TreeData&)
+{
+  return nullptr;
+}
+
+template <typename Tree>
+PersistentTreeData PersistentTreeData::SubtreeTable::Intern(
+  const Tree& source, std::vector<PersistentTreeData> children)
+{
+  // Children are already shared, so identical children are the same stored node
+  const auto& attributes = source.Attributes();
+  auto hash = HashCombine(std::hash<InternedString>{}(source.GetInternedNodeName()),
+                          std::hash<std::string_view>{}(source.Content()));
+  for (const auto& [name, value] : attributes)
+  {
+    hash = HashCombine(hash, std::hash<InternedString>{}(name));
+    hash = HashCombine(hash, std::hash<std::string>{}(value));
+  }
+  for (const auto& child : children)
+  {
+    hash = HashCombine(hash, std::hash<const Node*>{}(child.m_node.get()));
+  }
+  auto& candidates = m_nodes[hash];
+  for (const auto& candidate : candidates)
+  {
+    if (candidate->m_node_name == source.GetInternedNodeName() &&
+        candidate->m_content == source.Content() && candidate->m_attributes == attributes &&
+        std::equal(candidate->m_children.begin(), candidate->m_children.end(),
+                   children.begin(), children.end(),
+                   [](const PersistentTreeData& lhs, const PersistentTreeData& rhs)
+                   { return lhs.SharesNodeWith(rhs); }))
+    {
+      return PersistentTreeData{candidate};
+    }
+  }
+  auto node = std::make_shared<Node>(source.GetInternedNodeName());
+  node->m_content = std::string{source.Content()};
+  node->m_attributes = attributes;
+  node->m_children = std::move(children);
+  candidates.push_back(node);
+  return PersistentTreeData{std::move(node)};
+}
+
+bool operator==(const PersistentTreeData& left, const PersistentTreeData& right)
+{
+  std::vector<std::pair<const PersistentTreeData*, const PersistentTreeData*>> stack{
+    {&left, &right}};
+  while (!stack.empty())
+  {
+    const auto [lhs, rhs] = stack.back();
+    stack.pop_back();
+    if (lhs->SharesNodeWith(*rhs))
+    {
+      continue;
+    }
+    if (lhs->GetInternedNodeName() != rhs->GetInternedNodeName() ||
+        lhs->Content() != rhs->Content() ||
+        lhs->GetNumberOfChildren() != rhs->GetNumberOfChildren() ||
+        !EqualAttributes(lhs->Attributes(), rhs->Attributes()))
+    {
+      return false;
+    }
+    const auto& left_children = lhs->Children();
+    const auto& right_children = rhs->Children();
+    for (std::size_t idx = left_children.size(); idx > 0; --idx)
+    {
+      stack.emplace_back(&left_children[idx - 1], &right_children[idx - 1]);
+    }
+  }
+  return true;
+}
+
+bool operator!=(const PersistentTreeData& left, const PersistentTreeData& right)
+{
+  return !(left == right);
+}
+
+PersistentTreeData ShareIdenticalSubtrees(const TreeData& tree)
+{
+  return PersistentTreeData::SubtreeTable{}.Share(tree);
+}
+
+PersistentTreeData ShareIdenticalSubtrees(const PersistentTreeData& tree)
+{
+  return PersistentTreeData::SubtreeTable{}.Share(tree);
+}
+
+}  // namespace xml
+
+}  // namespace sup
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_PERSISTENT_TREE_DATA_H_
+#define SUP_XML_PERSISTENT_TREE_DATA_H_
+
+#include <sup/xml/interned_string.h>
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief XML tree with structural sharing and copy-on-write, for keeping many versions of a tree.
+ *
+ * @details A PersistentTreeData is a handle to an immutable node that may be shared with other
+ * handles. Copying a handle takes constant time. A modification first gives the handle a private
+ * copy of its node if it is shared. This copy has the same children, which remain shared. So
+ * modifying a node through UpdateChild or UpdateNode copies only the nodes on the path from the
+ * root, and all other versions of the tree stay unchanged. No references to child handles are
+ * handed out for modification, since a copy of the tree taken later would see changes made through
+ * such a reference.
+ *
+ * Handles that share nodes can be used from different threads. A single handle cannot be used
+ * from multiple threads while it is modified. Like TreeData, copying, destruction and comparison
+ * do not recurse.
+ */
+class PersistentTreeData
+{
+public:
+  using Attribute = TreeData::Attribute;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param node_name Name of the current node.
+   */
+  explicit PersistentTreeData(std::string node_name);
+  explicit PersistentTreeData(InternedString node_name);
+
+  /**
+   * @brief Construct from a TreeData, copying all of its nodes.
+   */
+  explicit PersistentTreeData(const TreeData& tree);
+
+  ~PersistentTreeData();
+
+  /**
+   * @brief Copy/move Constructor. Copies share all nodes; a moved-from handle can only be assigned
+   * to or destroyed.
+   */
+  PersistentTreeData(const PersistentTreeData& other);
+  PersistentTreeData(PersistentTreeData&& other) noexcept;
+
+  /**
+   * @brief Copy/move Assignment.
+   */
+  PersistentTreeData& operator=(const PersistentTreeData& other) &;
+  PersistentTreeData& operator=(PersistentTreeData&& other) & noexcept;
+
+  /**
+   * @brief Retrieve the name of the current node.
+   */
+  std::string GetNodeName() const;
+  const InternedString& GetInternedNodeName() const &;
+  std::string_view NodeName() const &;
+
+  /**
+   * @brief Attribute access, with the same semantics as for TreeData.
+   *
+   * @throw InvalidOperationException by GetAttribute when no attribute with the given name exists.
+   */
+  std::size_t GetNumberOfAttributes() const;
+  bool HasAttribute(const std::string& name) const;
+  bool HasAttribute(const InternedString& name) const;
+  std::string GetAttribute(const std::string& name) const;
+  const std::string* FindAttribute(std::string_view name) const &;
+  const std::vector<Attribute>& Attributes() const &;
+
+  /**
+   * @brief Add attribute with given name and value.
+   *
+   * @throw InvalidOperationException when an attribute with the given name already exists.
+   */
+  void AddAttribute(std::string name, std::string value);
+
+  /**
+   * @brief Set the value of an attribute, adding it when not yet present.
+   */
+  void SetAttribute(const std::string& name, std::string value);
+
+  /**
+   * @brief Child access.
+   */
+  std::size_t GetNumberOfChildren() const;
+  const std::vector<PersistentTreeData>& Children() const &;
+
+  /**
+   * @brief Add a child element, sharing its nodes.
+   */
+  void AddChild(PersistentTreeData child);
+
+  /**
+   * @brief Construct a new child element in place.
+   */
+  void EmplaceChild(std::string node_name);
+
+  /**
+   * @brief Modify a child element.
+   *
+   * @details The nodes on the path to the child are made private to this handle before the update
+   * function is called. The reference passed to it is only valid during the call; assigning to it
+   * replaces the child. The update function must not copy or otherwise access the tree that
+   * contains this node.
+   *
+   * @param idx Index of the child element.
+   * @param update Function that modifies the child element.
+   *
+   * @throw InvalidOperationException when the index is out of range.
+   */
+  void UpdateChild(std::size_t idx, const std::function<void(PersistentTreeData&)>& update);
+
+  /**
+   * @brief Modify a descendant element, with the same semantics as UpdateChild.
+   *
+   * @param path Child indices leading from this node to the descendant. An empty path refers to
+   * this node.
+   * @param update Function that modifies the descendant element.
+   *
+   * @throw InvalidOperationException when an index on the path is out of range.
+   */
+  void UpdateNode(const std::vector<std::size_t>& path,
+                  const std::function<void(PersistentTreeData&)>& update);
+
+  /**
+   * @brief Remove a child element.
+   *
+   * @throw InvalidOperationException when the index is out of range.
+   */
+  void RemoveChild(std::size_t idx);
+
+  /**
+   * @brief Element content.
+   */
+  void SetContent(std::string content);
+  std::string GetContent() const;
+  std::string_view Content() const &;
+
+  /**
+   * @brief Indicate that both handles refer to the same node, e.g. because one is an unmodified
+   * copy of the other. Such trees are equal.
+   */
+  bool SharesNodeWith(const PersistentTreeData& other) const;
+
+  /**
+   * @brief Convert to TreeData, copying all nodes.
+   */
+  TreeData ToTreeData() const;
+
+  /**
+   * @brief Count the nodes of the tree, where a shared subtree counts each time it appears.
+   */
+  std::size_t CountNodes() const;
+
+  /**
+   * @brief Count the nodes that are actually stored, i.e. each shared node only once.
+   */
+  std::size_t CountDistinctNodes() const;
+
+private:
+  struct Node;
+  class SubtreeTable;
+
+  friend PersistentTreeData ShareIdenticalSubtrees(const TreeData& tree);
+  friend PersistentTreeData ShareIdenticalSubtrees(const PersistentTreeData& tree);
+
+  explicit PersistentTreeData(std::shared_ptr<Node> node);
+
+  //! Give this handle a private copy of its node when it is shared.
+  Node& MutableNode();
+
+  std::shared_ptr<Node> m_node;
+};
+
+/**
+ * @brief Structural comparison. Shared nodes are recognized without visiting them.
+ */
+bool operator==(const PersistentTreeData& left, const PersistentTreeData& right);
+bool operator!=(const PersistentTreeData& left, const PersistentTreeData& right);
+
+/**
+ * @brief Build a tree in which structurally identical subtrees are stored only once.
+ *
+ * @details Subtrees are identical when they have the same names, content, attributes in the same
+ * order and identical children. They are detected bottom-up by hashing each node together with
+ * its (already shared) children, so the pass takes linear time. The result is equal to the input
+ * and can be modified as usual: shared subtrees are copied on write. The gain can be measured by
+ * comparing CountNodes() with CountDistinctNodes().
+ */
+PersistentTreeData ShareIdenticalSubtrees(const TreeData& tree);
+PersistentTreeData ShareIdenticalSubtrees(const PersistentTreeData& tree);
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_PERSISTENT_TREE_DATA_H_
@@ -0,0 +1,335 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "pmr_tree_data.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <algorithm>
+
+namespace sup
+{
+namespace xml
+{
+
+PmrTreeData::PmrTreeData(std::string_view node_name, allocator_type alloc)
+  : PmrTreeData{InternedString{node_name}, alloc}
+{}
+
+PmrTreeData::PmrTreeData(InternedString node_name, allocator_type alloc)
+  : m_node_name{node_name}
+  , m_content{alloc}
+  , m_attributes{alloc}
+  , m_children{alloc}
+{}
+
+PmrTreeData::PmrTreeData(const TreeData& tree, allocator_type alloc)
+  : PmrTreeData{tree.GetInternedNodeName(), alloc}
+{
+  // Child lists are reserved up front, so the new children stay in place while their own children
+  // are added later.
+  std::vector<std::pair<const TreeData*, PmrTreeData*>> stack{{&tree, this}};
+  while (!stack.empty())
+  {
+    const auto [source, target] = stack.back();
+    stack.pop_back();
+    target->SetContent(source->Content());
+    for (const auto& [name, value] : source->Attributes())
+    {
+      (void)target->m_attributes.emplace_back(name, value);
+    }
+    target->m_children.reserve(source->GetNumberOfChildren());
+    for (const auto& child : source->Children())
+    {
+      stack.emplace_back(&child, &target->m_children.emplace_back(child.GetInternedNodeName()));
+    }
+  }
+}
+
+PmrTreeData::~PmrTreeData()
+{
+  if (m_children.empty())
+  {
+    return;
+  }
+  // Detach the child lists of all descendants first, so every node is destroyed without children
+  // and destruction does not recurse.
+  std::vector<std::pmr::vector<PmrTreeData>> pending;
+  pending.push_back(std::move(m_children));
+  while (!pending.empty())
+  {
+    auto children = std::move(pending.back());
+    pending.pop_back();
+    for (auto& child : children)
+    {
+      if (!child.m_children.empty())
+      {
+        pending.push_back(std::move(child.m_children));
+      }
+    }
+  }
+}
+
+PmrTreeData::PmrTreeData(const PmrTreeData& other, allocator_type alloc)
+  : m_node_name{other.m_node_name}
+  , m_content{other.m_content, alloc}
+  , m_attributes{other.m_attributes, alloc}
+  , m_children{alloc}
+{
+  std::vector<std::pair<const PmrTreeData*, PmrTreeData*>> stack{{&other, this}};
+  while (!stack.empty())
+  {
+    const auto [source, target] = stack.back();
+    stack.pop_back();
+    target->m_children.reserve(source->m_children.size());
+    for (const auto& child : source->m_children)
+    {
+      auto& copy = target->m_children.emplace_back(child.m_node_name);
+      copy.m_content = child.m_content;
+      copy.m_attributes = child.m_attributes;
+      if (!child.m_children.empty())
+      {
+        stack.emplace_back(&child, &copy);
+      }
+    }
+  }
+}
+
+PmrTreeData::PmrTreeData(PmrTreeData&& other) noexcept
+  : m_node_name{other.m_node_name}
+  , m_content{std::move(other.m_content)}
+  , m_attributes{std::move(other.m_attributes)}
+  , m_children{std::move(other.m_children)}
+{}
+
+PmrTreeData::PmrTreeData(PmrTreeData&& other, allocator_type alloc)
+  : m_node_name{other.m_node_name}
+  , m_content{std::move(other.m_content), alloc}
+  , m_attributes{std::move(other.m_attributes), alloc}
+  , m_children{alloc}
+{
+  if (other.m_children.get_allocator() == m_children.get_allocator())
+  {
+    m_children = std::move(other.m_children);
+    return;
+  }
+  // Another resource: the children need to be copied, which is done without recursion
+  PmrTreeData copy{other, alloc};
+  m_children = std::move(copy.m_children);
+}
+
+PmrTreeData& PmrTreeData::operator=(const PmrTreeData& other) &
+{
+  if (this != &other)
+  {
+    *this = PmrTreeData{other, get_allocator()};
+  }
+  return *this;
+}
+
+PmrTreeData& PmrTreeData::operator=(PmrTreeData&& other) &
+{
+  if (this != &other)
+  {
+    // Move out first: other may be one of the descendants that are destroyed below
+    PmrTreeData moved{std::move(other), get_allocator()};
+    m_node_name = moved.m_node_name;
+    m_content = std::move(moved.m_content);
+    m_attributes = std::move(moved.m_attributes);
+    m_children = std::move(moved.m_children);
+  }
+  return *this;
+}
+
+PmrTreeData::allocator_type PmrTreeData::get_allocator() const
+{
+  return m_children.get_allocator();
+}
+
+std::string PmrTreeData::GetNodeName() const
+{
+  return m_node_name;
+}
+
+const InternedString& PmrTreeData::GetInternedNodeName() const &
+{
+  return m_node_name;
+}
+
+std::string_view PmrTreeData::NodeName() const &
+{
+  return m_node_name;
+}
+
+std::size_t PmrTreeData::GetNumberOfAttributes() const
+{
+  return m_attributes.size();
+}
+
+bool PmrTreeData::HasAttribute(std::string_view name) const
+{
+  return FindAttribute(name) != nullptr;
+}
+
+bool PmrTreeData::HasAttribute(const InternedString& name) const
+{
+  return std::any_of(m_attributes.begin(), m_attributes.end(),
+                     [&name](const Attribute& attr) { return attr.first == name; });
+}
+
+std::string_view PmrTreeData::GetAttribute(std::string_view name) const &
+{
+  auto value = FindAttribute(name);
+  if (value == nullptr)
+  {
+    std::string message = "PmrTreeData::GetAttribute(): attribute with name [" +
+      std::string(name) + "] does not exist";
+    throw InvalidOperationException(message);
+  }
+  return *value;
+}
+
+const std::pmr::string* PmrTreeData::FindAttribute(std::string_view name) const &
+{
+  for (const auto& attr : m_attributes)
+  {
+    if (std::string_view{attr.first} == name)
+    {
+      return &attr.second;
+    }
+  }
+  return nullptr;
+}
+
+const std::pmr::vector<PmrTreeData::Attribute>& PmrTreeData::Attributes() const &
+{
+  return m_attributes;
+}
+
+void PmrTreeData::AddAttribute(std::string_view name, std::string_view value)
+{
+  AddAttribute(InternedString{name}, value);
+}
+
+void PmrTreeData::AddAttribute(const InternedString& name, std::string_view value)
+{
+  if (HasAttribute(name))
+  {
+    std::string message = "PmrTreeData::AddAttribute(): attribute with name [" +
+      std::string(name) + "] already exists";
+    throw InvalidOperationException(message);
+  }
+  (void)m_attributes.emplace_back(name, value);
+}
+
+void PmrTreeData::ReserveAttributes(std::size_t n_attributes)
+{
+  m_attributes.reserve(n_attributes);
+}
+
+std::size_t PmrTreeData::GetNumberOfChildren() const
+{
+  return m_children.size();
+}
+
+void PmrTreeData::AddChild(const PmrTreeData& child)
+{
+  m_children.push_back(child);
+}
+
+void PmrTreeData::AddChild(PmrTreeData&& child)
+{
+  m_children.push_back(std::move(child));
+}
+
+PmrTreeData& PmrTreeData::EmplaceChild(std::string_view node_name)
+{
+  return m_children.emplace_back(InternedString{node_name});
+}
+
+PmrTreeData& PmrTreeData::EmplaceChild(const InternedString& node_name)
+{
+  return m_children.emplace_back(node_name);
+}
+
+const std::pmr::vector<PmrTreeData>& PmrTreeData::Children() const &
+{
+  return m_children;
+}
+
+void PmrTreeData::SetContent(std::string_view content)
+{
+  m_content.assign(content.data(), content.size());
+}
+
+std::string_view PmrTreeData::Content() const &
+{
+  return m_content;
+}
+
+TreeData PmrTreeData::ToTreeData() const
+{
+  // Children are completed before they are moved into their parent, so no references into child
+  // lists are kept while these lists grow.
+  struct ConvertStackNode
+  {
+    const PmrTreeData* source;
+    TreeData target;
+    std::size_t next_child;
+  };
+  auto open_node = [](const PmrTreeData& source)
+  {
+    TreeData target{source.m_node_name};
+    target.SetContent(std::string{source.m_content});
+    for (const auto& [name, value] : source.m_attributes)
+    {
+      target.AddAttribute(name, std::string{value});
+    }
+    return ConvertStackNode{&source, std::move(target), 0};
+  };
+  std::vector<ConvertStackNode> stack;
+  stack.push_back(open_node(*this));
+  while (true)
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.source->m_children;
+    if (top_node.next_child < children.size())
+    {
+      const auto& child = children[top_node.next_child];
+      ++top_node.next_child;
+      stack.push_back(open_node(child));
+      continue;
+    }
+    if (stack.size() == 1)
+    {
+      break;
+    }
+    auto completed = std::move(top_node.target);
+    stack.pop_back();
+    stack.back().target.AddChild(std::move(completed));
+  }
+  return std::move(stack.back().target);
+}
+
+}  // namespace xml
+
+}  // namespace sup
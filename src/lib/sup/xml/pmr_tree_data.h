@@ -0,0 +1,191 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_PMR_TREE_DATA_H_
+#define SUP_XML_PMR_TREE_DATA_H_
+
+#include <sup/xml/interned_string.h>
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Variant of TreeData whose strings and lists are allocated from a
+ * std::pmr::memory_resource.
+ *
+ * @details All children and attributes use the allocator of the node they are added to, so a tree
+ * lives entirely in the resource of its root. This follows the usual rules for allocator-aware
+ * types, so a tree can also be stored in std::pmr containers. With a
+ * std::pmr::monotonic_buffer_resource, a tree can be parsed, used and dropped, and its memory is
+ * returned in one go when the resource is released. The tree is still destroyed node by node, but
+ * this does not free any memory. Node and attribute names are interned (see InternedString) and
+ * are not allocated from the resource.
+ *
+ * Like TreeData, copying and destruction do not recurse. Copies made without an explicit
+ * allocator use the default resource.
+ */
+class PmrTreeData
+{
+public:
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+  using Attribute = std::pair<InternedString, std::pmr::string>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param node_name Name of the current node.
+   * @param alloc Allocator for this node and all nodes added to it.
+   */
+  explicit PmrTreeData(std::string_view node_name, allocator_type alloc = {});
+  explicit PmrTreeData(InternedString node_name, allocator_type alloc = {});
+
+  /**
+   * @brief Construct from a TreeData, copying all of its nodes.
+   */
+  explicit PmrTreeData(const TreeData& tree, allocator_type alloc = {});
+
+  ~PmrTreeData();
+
+  /**
+   * @brief Copy/move Constructor, optionally with another allocator.
+   */
+  PmrTreeData(const PmrTreeData& other, allocator_type alloc = {});
+  PmrTreeData(PmrTreeData&& other) noexcept;
+  PmrTreeData(PmrTreeData&& other, allocator_type alloc);
+
+  /**
+   * @brief Copy/move Assignment. The allocator of this tree is kept.
+   */
+  PmrTreeData& operator=(const PmrTreeData& other) &;
+  PmrTreeData& operator=(PmrTreeData&& other) &;
+
+  allocator_type get_allocator() const;
+
+  /**
+   * @brief Retrieve the name of the current node.
+   */
+  std::string GetNodeName() const;
+  const InternedString& GetInternedNodeName() const &;
+  std::string_view NodeName() const &;
+
+  /**
+   * @brief Get number of attributes.
+   */
+  std::size_t GetNumberOfAttributes() const;
+
+  /**
+   * @brief Indicate presence of attribute with given name.
+   */
+  bool HasAttribute(std::string_view name) const;
+  bool HasAttribute(const InternedString& name) const;
+
+  /**
+   * @brief Get attribute with given name.
+   *
+   * @return View of the attribute value, valid as long as this node is not modified.
+   *
+   * @throw InvalidOperationException when no attribute with the given name exists.
+   */
+  std::string_view GetAttribute(std::string_view name) const &;
+
+  /**
+   * @brief Look up an attribute value without throwing.
+   *
+   * @return Pointer to the value or nullptr when the attribute does not exist.
+   */
+  const std::pmr::string* FindAttribute(std::string_view name) const &;
+
+  /**
+   * @brief Retrieve all attributes, in the order they were added.
+   */
+  const std::pmr::vector<Attribute>& Attributes() const &;
+
+  /**
+   * @brief Add attribute with given name and value.
+   *
+   * @throw InvalidOperationException when an attribute with the given name already exists.
+   */
+  void AddAttribute(std::string_view name, std::string_view value);
+  void AddAttribute(const InternedString& name, std::string_view value);
+
+  /**
+   * @brief Reserve room for the given total number of attributes.
+   */
+  void ReserveAttributes(std::size_t n_attributes);
+
+  /**
+   * @brief Get number of children.
+   */
+  std::size_t GetNumberOfChildren() const;
+
+  /**
+   * @brief Add a child element, copied or moved into the allocator of this node.
+   */
+  void AddChild(const PmrTreeData& child);
+  void AddChild(PmrTreeData&& child);
+
+  /**
+   * @brief Construct a new child element in place.
+   *
+   * @return Reference to the new child element, invalidated when another child is added to this
+   * element.
+   */
+  PmrTreeData& EmplaceChild(std::string_view node_name);
+  PmrTreeData& EmplaceChild(const InternedString& node_name);
+
+  /**
+   * @brief Retrieve all child data elements.
+   */
+  const std::pmr::vector<PmrTreeData>& Children() const &;
+
+  /**
+   * @brief Element content.
+   */
+  void SetContent(std::string_view content);
+  std::string_view Content() const &;
+
+  /**
+   * @brief Convert to TreeData, copying all nodes.
+   */
+  TreeData ToTreeData() const;
+
+private:
+  InternedString m_node_name;
+  std::pmr::string m_content;
+  std::pmr::vector<Attribute> m_attributes;
+  std::pmr::vector<PmrTreeData> m_children;
+};
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_PMR_TREE_DATA_H_
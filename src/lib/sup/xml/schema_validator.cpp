@@ -0,0 +1,494 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "schema_validator.h"
+
+#include "xml_utils.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <libxml/parser.h>
+#include <libxml/relaxng.h>
+#include <libxml/tree.h>
+#include <libxml/xmlschemas.h>
+#include <libxml/xmlversion.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+using sup::xml::XMLDocPointer;
+
+// Structured error handlers receive a pointer to const since libxml2 2.12
+#if LIBXML_VERSION >= 21200
+using XMLErrorPointer = const xmlError*;
+#else
+using XMLErrorPointer = xmlErrorPtr;
+#endif
+
+/**
+ * @brief Validation context for one of the supported schema types.
+ */
+class ValidationContext
+{
+public:
+  ValidationContext(xmlSchemaPtr xml_schema, xmlRelaxNGPtr relax_ng);
+  ~ValidationContext();
+
+  ValidationContext(const ValidationContext&) = delete;
+  ValidationContext& operator=(const ValidationContext&) = delete;
+
+  //! Validate the document and append all errors to the given list.
+  void ValidateDoc(xmlDocPtr doc, std::vector<std::string>& errors);
+
+private:
+  xmlSchemaValidCtxtPtr m_xml_schema_ctxt;
+  xmlRelaxNGValidCtxtPtr m_relax_ng_ctxt;
+};
+
+void CollectError(void* user_data, XMLErrorPointer error);
+
+XMLDocPointer ReadXMLDoc(const char* data, std::size_t size, const char* url,
+                         const std::string& caller);
+
+XMLDocPointer CreateXMLDoc(const sup::xml::TreeData& tree);
+
+xmlNodePtr CreateXMLNode(xmlDocPtr doc, xmlNodePtr parent, const sup::xml::TreeData& tree_data);
+
+std::string ReadFile(const std::string& filename);
+
+/**
+ * @brief Process-wide cache of compiled schemas, keyed by path, type and content hash. When it
+ * holds more than kMaxCachedSchemas entries, the least recently used one is dropped.
+ */
+struct SchemaCache
+{
+  using Key = std::tuple<std::string, sup::xml::SchemaType, std::size_t>;
+  struct Entry
+  {
+    std::string schema{};
+    std::shared_ptr<const sup::xml::SchemaValidator> validator{};
+    std::uint64_t last_use = 0;
+  };
+  std::mutex mutex{};
+  std::map<Key, Entry> entries{};
+  std::uint64_t use_counter = 0;
+};
+
+const std::size_t kMaxCachedSchemas = 64;
+
+SchemaCache& GetSchemaCache();
+
+std::shared_ptr<const sup::xml::SchemaValidator> GetCachedSchemaValidator(
+  const std::string& schema, sup::xml::SchemaType type, const std::string& path);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+struct SchemaValidator::SchemaValidatorImpl
+{
+  SchemaType m_type = SchemaType::kXmlSchema;
+  XMLDocPointer m_schema_doc{};
+  xmlSchemaPtr m_xml_schema = nullptr;
+  xmlRelaxNGPtr m_relax_ng = nullptr;
+  std::mutex m_mutex{};
+  std::vector<std::unique_ptr<ValidationContext>> m_free_contexts{};
+
+  SchemaValidatorImpl() = default;
+  ~SchemaValidatorImpl();
+
+  SchemaValidatorImpl(const SchemaValidatorImpl&) = delete;
+  SchemaValidatorImpl& operator=(const SchemaValidatorImpl&) = delete;
+
+  //! Validate the document with a context from the pool
+  std::vector<std::string> ValidateDoc(xmlDocPtr doc);
+};
+
+SchemaValidator::SchemaValidator(const std::string& schema, SchemaType type,
+                                 const std::string& base_url)
+  : p_impl(std::make_unique<SchemaValidatorImpl>())
+{
+  xmlInitParser();
+  p_impl->m_type = type;
+  p_impl->m_schema_doc = ReadXMLDoc(schema.data(), schema.size(),
+                                    base_url.empty() ? nullptr : base_url.c_str(),
+                                    "sup::xml::SchemaValidator()");
+  std::vector<std::string> errors;
+  if (type == SchemaType::kRelaxNG)
+  {
+    auto parser_ctxt = xmlRelaxNGNewDocParserCtxt(p_impl->m_schema_doc.get());
+    if (parser_ctxt != nullptr)
+    {
+      xmlRelaxNGSetParserStructuredErrors(parser_ctxt, CollectError, &errors);
+      p_impl->m_relax_ng = xmlRelaxNGParse(parser_ctxt);
+      xmlRelaxNGFreeParserCtxt(parser_ctxt);
+    }
+  }
+  else
+  {
+    auto parser_ctxt = xmlSchemaNewDocParserCtxt(p_impl->m_schema_doc.get());
+    if (parser_ctxt != nullptr)
+    {
+      xmlSchemaSetParserStructuredErrors(parser_ctxt, CollectError, &errors);
+      p_impl->m_xml_schema = xmlSchemaParse(parser_ctxt);
+      xmlSchemaFreeParserCtxt(parser_ctxt);
+    }
+  }
+  if (p_impl->m_xml_schema == nullptr && p_impl->m_relax_ng == nullptr)
+  {
+    std::string message = "sup::xml::SchemaValidator(): could not compile schema";
+    for (const auto& error : errors)
+    {
+      message += "\n  " + error;
+    }
+    throw ParseException(message);
+  }
+}
+
+SchemaValidator::~SchemaValidator() = default;
+
+SchemaType SchemaValidator::GetType() const
+{
+  return p_impl->m_type;
+}
+
+std::vector<std::string> SchemaValidator::Validate(const TreeData& tree) const
+{
+  const auto doc = CreateXMLDoc(tree);
+  return p_impl->ValidateDoc(doc.get());
+}
+
+std::vector<std::string> SchemaValidator::Validate(const std::string& xml_str) const
+{
+  return Validate(xml_str.data(), xml_str.size());
+}
+
+std::vector<std::string> SchemaValidator::Validate(const char* data, std::size_t size) const
+{
+  const auto doc = ReadXMLDoc(data, size, nullptr, "sup::xml::SchemaValidator::Validate()");
+  return p_impl->ValidateDoc(doc.get());
+}
+
+SchemaValidator::SchemaValidatorImpl::~SchemaValidatorImpl()
+{
+  // Contexts refer to the compiled schema, which refers to the schema document
+  m_free_contexts.clear();
+  if (m_xml_schema != nullptr)
+  {
+    xmlSchemaFree(m_xml_schema);
+  }
+  if (m_relax_ng != nullptr)
+  {
+    xmlRelaxNGFree(m_relax_ng);
+  }
+}
+
+std::vector<std::string> SchemaValidator::SchemaValidatorImpl::ValidateDoc(xmlDocPtr doc)
+{
+  std::unique_ptr<ValidationContext> ctxt;
+  {
+    std::lock_guard<std::mutex> lk{m_mutex};
+    if (!m_free_contexts.empty())
+    {
+      ctxt = std::move(m_free_contexts.back());
+      m_free_contexts.pop_back();
+    }
+  }
+  if (!ctxt)
+  {
+    ctxt = std::make_unique<ValidationContext>(m_xml_schema, m_relax_ng);
+  }
+  std::vector<std::string> errors;
+  ctxt->ValidateDoc(doc, errors);
+  std::lock_guard<std::mutex> lk{m_mutex};
+  m_free_contexts.push_back(std::move(ctxt));
+  return errors;
+}
+
+std::shared_ptr<const SchemaValidator> SchemaValidatorFromFile(const std::string& filename,
+                                                               SchemaType type)
+{
+  return GetCachedSchemaValidator(ReadFile(filename), type, filename);
+}
+
+std::shared_ptr<const SchemaValidator> SchemaValidatorFromString(const std::string& schema,
+                                                                 SchemaType type)
+{
+  return GetCachedSchemaValidator(schema, type, {});
+}
+
+void ClearSchemaValidatorCache()
+{
+  auto& cache = GetSchemaCache();
+  std::lock_guard<std::mutex> lk{cache.mutex};
+  cache.entries.clear();
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+using sup::xml::ParseException;
+
+ValidationContext::ValidationContext(xmlSchemaPtr xml_schema, xmlRelaxNGPtr relax_ng)
+  : m_xml_schema_ctxt{xml_schema != nullptr ? xmlSchemaNewValidCtxt(xml_schema) : nullptr}
+  , m_relax_ng_ctxt{relax_ng != nullptr ? xmlRelaxNGNewValidCtxt(relax_ng) : nullptr}
+{
+  if (m_xml_schema_ctxt == nullptr && m_relax_ng_ctxt == nullptr)
+  {
+    std::string message = "sup::xml::SchemaValidator::Validate(): could not create validation "
+      "context";
+    throw sup::xml::ValidationException(message);
+  }
+}
+
+ValidationContext::~ValidationContext()
+{
+  if (m_xml_schema_ctxt != nullptr)
+  {
+    xmlSchemaFreeValidCtxt(m_xml_schema_ctxt);
+  }
+  if (m_relax_ng_ctxt != nullptr)
+  {
+    xmlRelaxNGFreeValidCtxt(m_relax_ng_ctxt);
+  }
+}
+
+void ValidationContext::ValidateDoc(xmlDocPtr doc, std::vector<std::string>& errors)
+{
+  int result = 0;
+  if (m_xml_schema_ctxt != nullptr)
+  {
+    xmlSchemaSetValidStructuredErrors(m_xml_schema_ctxt, CollectError, &errors);
+    result = xmlSchemaValidateDoc(m_xml_schema_ctxt, doc);
+    xmlSchemaSetValidStructuredErrors(m_xml_schema_ctxt, nullptr, nullptr);
+  }
+  else
+  {
+    xmlRelaxNGSetValidStructuredErrors(m_relax_ng_ctxt, CollectError, &errors);
+    result = xmlRelaxNGValidateDoc(m_relax_ng_ctxt, doc);
+    xmlRelaxNGSetValidStructuredErrors(m_relax_ng_ctxt, nullptr, nullptr);
+  }
+  if (result != 0 && errors.empty())
+  {
+    errors.push_back("validation failed with code " + std::to_string(result));
+  }
+}
+
+void CollectError(void* user_data, XMLErrorPointer error)
+{
+  if (user_data == nullptr || error == nullptr)
+  {
+    return;
+  }
+  auto& errors = *static_cast<std::vector<std::string>*>(user_data);
+  std::string message = error->message != nullptr ? error->message : "unknown error";
+  while (!message.empty() && message.back() == '\n')
+  {
+    message.pop_back();
+  }
+  if (error->line > 0)
+  {
+    message = "line " + std::to_string(error->line) + ": " + message;
+  }
+  errors.push_back(std::move(message));
+}
+
+XMLDocPointer ReadXMLDoc(const char* data, std::size_t size, const char* url,
+                         const std::string& caller)
+{
+  if (data == nullptr || size == 0 || size > static_cast<std::size_t>(INT_MAX))
+  {
+    std::string message = caller + ": used xml library could not parse empty or oversized input";
+    throw ParseException(message);
+  }
+  XMLDocPointer doc{xmlReadMemory(data, static_cast<int>(size), url, nullptr,
+                                  XML_PARSE_NOBLANKS | XML_PARSE_NOERROR | XML_PARSE_NOWARNING)};
+  if (!doc)
+  {
+    auto error = xmlGetLastError();
+    std::string message = caller + ": used xml library could not parse input";
+    if (error != nullptr && error->message != nullptr)
+    {
+      message += ": " + std::string(error->message);
+      while (message.back() == '\n')
+      {
+        message.pop_back();
+      }
+    }
+    throw ParseException(message);
+  }
+  return doc;
+}
+
+XMLDocPointer CreateXMLDoc(const sup::xml::TreeData& tree)
+{
+  XMLDocPointer doc{xmlNewDoc(sup::xml::FromStringView("1.0"))};
+  // Pre-order: each node is attached before its children, so their namespace prefixes resolve
+  std::vector<std::pair<const sup::xml::TreeData*, xmlNodePtr>> stack{
+    {&tree, CreateXMLNode(doc.get(), nullptr, tree)}};
+  while (!stack.empty())
+  {
+    const auto [tree_data, node] = stack.back();
+    stack.pop_back();
+    for (const auto& child : tree_data->Children())
+    {
+      stack.emplace_back(&child, CreateXMLNode(doc.get(), node, child));
+    }
+  }
+  return doc;
+}
+
+xmlNodePtr CreateXMLNode(xmlDocPtr doc, xmlNodePtr parent, const sup::xml::TreeData& tree_data)
+{
+  using sup::xml::FromString;
+  using sup::xml::FromStringView;
+  // Split a qualified name into prefix and local name; the prefix is empty when there is none
+  auto split_name = [](std::string_view name)
+  {
+    const auto pos = name.find(':');
+    return pos == std::string_view::npos
+      ? std::make_pair(std::string{}, std::string{name})
+      : std::make_pair(std::string{name.substr(0, pos)}, std::string{name.substr(pos + 1)});
+  };
+  auto node = xmlNewDocNode(doc, nullptr, FromStringView(tree_data.NodeName()), nullptr);
+  if (parent == nullptr)
+  {
+    (void)xmlDocSetRootElement(doc, node);
+  }
+  else
+  {
+    node = xmlAddChild(parent, node);
+  }
+  // Namespace declarations first, since the names of the node and its attributes may use them
+  for (const auto& [name, value] : tree_data.Attributes())
+  {
+    if (name.Str() == "xmlns")
+    {
+      (void)xmlNewNs(node, FromString(value), nullptr);
+    }
+    else if (name.Str().compare(0, 6, "xmlns:") == 0)
+    {
+      (void)xmlNewNs(node, FromString(value), FromString(name.Str().substr(6)));
+    }
+  }
+  const auto [prefix, local_name] = split_name(tree_data.NodeName());
+  auto ns = xmlSearchNs(doc, node, prefix.empty() ? nullptr : FromString(prefix));
+  if (ns != nullptr)
+  {
+    xmlSetNs(node, ns);
+    xmlNodeSetName(node, FromString(local_name));
+  }
+  for (const auto& [name, value] : tree_data.Attributes())
+  {
+    if (name.Str() == "xmlns" || name.Str().compare(0, 6, "xmlns:") == 0)
+    {
+      continue;
+    }
+    // Unprefixed attributes are not in the default namespace
+    const auto [attr_prefix, attr_local_name] = split_name(name.Str());
+    auto attr_ns = attr_prefix.empty() ? nullptr : xmlSearchNs(doc, node, FromString(attr_prefix));
+    if (attr_ns != nullptr)
+    {
+      (void)xmlNewNsProp(node, attr_ns, FromString(attr_local_name), FromString(value));
+    }
+    else
+    {
+      (void)xmlNewProp(node, FromStringView(name), FromString(value));
+    }
+  }
+  const auto content = tree_data.Content();
+  if (!content.empty())
+  {
+    (void)xmlAddChild(node, xmlNewDocTextLen(doc, FromStringView(content),
+                                             static_cast<int>(content.size())));
+  }
+  return node;
+}
+
+std::string ReadFile(const std::string& filename)
+{
+  std::ifstream file{filename, std::ios::binary};
+  if (!file)
+  {
+    std::string message = "sup::xml::SchemaValidatorFromFile(): could not open file [" + filename +
+      "]";
+    throw ParseException(message);
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+SchemaCache& GetSchemaCache()
+{
+  static SchemaCache cache;
+  return cache;
+}
+
+std::shared_ptr<const sup::xml::SchemaValidator> GetCachedSchemaValidator(
+  const std::string& schema, sup::xml::SchemaType type, const std::string& path)
+{
+  // The full content is kept to rule out hash collisions. Only the latest version of each file is
+  // kept. Compiling under the lock makes concurrent requests for a new schema compile it once.
+  auto& cache = GetSchemaCache();
+  std::lock_guard<std::mutex> lk{cache.mutex};
+  const SchemaCache::Key key{path, type, std::hash<std::string>{}(schema)};
+  auto it = cache.entries.find(key);
+  if (it != cache.entries.end() && it->second.schema == schema)
+  {
+    it->second.last_use = ++cache.use_counter;
+    return it->second.validator;
+  }
+  auto validator = std::make_shared<const sup::xml::SchemaValidator>(schema, type, path);
+  if (!path.empty())
+  {
+    auto first = cache.entries.lower_bound(SchemaCache::Key{path, type, 0});
+    auto last = cache.entries.upper_bound(
+      SchemaCache::Key{path, type, std::numeric_limits<std::size_t>::max()});
+    (void)cache.entries.erase(first, last);
+  }
+  cache.entries[key] = SchemaCache::Entry{schema, validator, ++cache.use_counter};
+  if (cache.entries.size() > kMaxCachedSchemas)
+  {
+    auto oldest = std::min_element(cache.entries.begin(), cache.entries.end(),
+                                   [](const auto& left, const auto& right)
+                                   { return left.second.last_use < right.second.last_use; });
+    (void)cache.entries.erase(oldest);
+  }
+  return validator;
+}
+}  // unnamed namespace
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_SCHEMA_VALIDATOR_H_
+#define SUP_XML_SCHEMA_VALIDATOR_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Supported schema languages.
+ */
+enum class SchemaType
+{
+  kXmlSchema = 0,   //!< W3C XML Schema (XSD).
+  kRelaxNG          //!< RELAX NG in XML syntax.
+};
+
+/**
+ * @brief Compiled XSD or RELAX NG schema.
+ *
+ * @details The schema is compiled once on construction. Validation contexts are kept in a pool
+ * and each call to Validate takes one out for its own use, so a SchemaValidator can be shared
+ * between threads, with each validating thread effectively owning a context.
+ */
+class SchemaValidator
+{
+public:
+  /**
+   * @brief Compile a schema.
+   *
+   * @param schema Schema document.
+   * @param type Language of the schema.
+   * @param base_url URL used to resolve includes and imports (relative to the working directory
+   * when empty).
+   *
+   * @throw ParseException when the schema could not be parsed or compiled.
+   */
+  SchemaValidator(const std::string& schema, SchemaType type, const std::string& base_url = {});
+  ~SchemaValidator();
+
+  SchemaValidator(const SchemaValidator&) = delete;
+  SchemaValidator& operator=(const SchemaValidator&) = delete;
+
+  /**
+   * @brief Retrieve the language of the schema.
+   */
+  SchemaType GetType() const;
+
+  /**
+   * @brief Validate a tree.
+   *
+   * @details Attributes named xmlns or xmlns:prefix declare namespaces, which apply to the node
+   * and attribute names of the tree as in an XML document.
+   *
+   * @return All validation errors, empty when the tree is valid.
+   */
+  std::vector<std::string> Validate(const TreeData& tree) const;
+
+  /**
+   * @brief Validate an XML document held in memory.
+   *
+   * @return All validation errors, empty when the document is valid.
+   *
+   * @throw ParseException when the document is not well-formed.
+   */
+  std::vector<std::string> Validate(const std::string& xml_str) const;
+  std::vector<std::string> Validate(const char* data, std::size_t size) const;
+
+private:
+  struct SchemaValidatorImpl;
+  std::unique_ptr<SchemaValidatorImpl> p_impl;
+};
+
+/**
+ * @brief Get the compiled schema for the given file.
+ *
+ * @details Compiled schemas are cached by path, schema type and a hash of the file contents. The
+ * file is read on every call, but it is only compiled again when its contents changed. Includes
+ * are resolved relative to the file.
+ *
+ * @throw ParseException when the file could not be read, parsed or compiled.
+ */
+std::shared_ptr<const SchemaValidator> SchemaValidatorFromFile(const std::string& filename,
+                                                               SchemaType type);
+
+/**
+ * @brief Get the compiled schema for the given schema document, cached by its contents.
+ *
+ * @details The cache holds a limited number of schemas, shared with SchemaValidatorFromFile. The
+ * least recently used schema is dropped first.
+ *
+ * @throw ParseException when the schema could not be parsed or compiled.
+ */
+std::shared_ptr<const SchemaValidator> SchemaValidatorFromString(const std::string& schema,
+                                                                 SchemaType type);
+
+/**
+ * @brief Drop all cached schemas. Schemas still referenced by callers stay alive.
+ */
+void ClearSchemaValidatorCache();
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_SCHEMA_VALIDATOR_H_
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "serialize_sink.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+namespace sup
+{
+namespace xml
+{
+
+SerializeSink::~SerializeSink() = default;
+
+FileDescriptorSink::FileDescriptorSink(int fd)
+  : m_fd{fd}
+{}
+
+FileDescriptorSink::~FileDescriptorSink() = default;
+
+void FileDescriptorSink::Write(const char* data, std::size_t size)
+{
+  // A single call may write only part of the data, e.g. for pipes and sockets
+  while (size > 0)
+  {
+    const auto written = write(m_fd, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      std::string message = "sup::xml::FileDescriptorSink::Write(): could not write to file "
+                            "descriptor: " + std::string(std::strerror(errno));
+      throw SerializeException(message);
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+OStreamSink::OStreamSink(std::ostream& stream)
+  : m_stream{stream}
+{}
+
+OStreamSink::~OStreamSink() = default;
+
+void OStreamSink::Write(const char* data, std::size_t size)
+{
+  (void)m_stream.write(data, static_cast<std::streamsize>(size));
+  if (!m_stream)
+  {
+    std::string message = "sup::xml::OStreamSink::Write(): could not write to output stream";
+    throw SerializeException(message);
+  }
+}
+
+CallbackSink::CallbackSink(Callback callback)
+  : m_callback{std::move(callback)}
+{}
+
+CallbackSink::~CallbackSink() = default;
+
+void CallbackSink::Write(const char* data, std::size_t size)
+{
+  m_callback(data, size);
+}
+
+}  // namespace xml
+
+}  // namespace sup
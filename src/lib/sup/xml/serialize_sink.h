@@ -0,0 +1,105 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_SERIALIZE_SINK_H_
+#define SUP_XML_SERIALIZE_SINK_H_
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Destination for serialized XML, which receives the output in consecutive chunks.
+ */
+class SerializeSink
+{
+public:
+  virtual ~SerializeSink();
+
+  /**
+   * @brief Write the next chunk of output.
+   *
+   * @throw SerializeException when the chunk could not be written.
+   */
+  virtual void Write(const char* data, std::size_t size) = 0;
+};
+
+/**
+ * @brief Sink writing to an open file descriptor, e.g. a file, pipe or socket. The descriptor is
+ * not closed by the sink.
+ */
+class FileDescriptorSink : public SerializeSink
+{
+public:
+  explicit FileDescriptorSink(int fd);
+  ~FileDescriptorSink() override;
+
+  void Write(const char* data, std::size_t size) override;
+
+private:
+  int m_fd;
+};
+
+/**
+ * @brief Sink writing to a standard output stream.
+ */
+class OStreamSink : public SerializeSink
+{
+public:
+  explicit OStreamSink(std::ostream& stream);
+  ~OStreamSink() override;
+
+  OStreamSink(const OStreamSink&) = delete;
+  OStreamSink& operator=(const OStreamSink&) = delete;
+
+  void Write(const char* data, std::size_t size) override;
+
+private:
+  std::ostream& m_stream;
+};
+
+/**
+ * @brief Sink passing each chunk to a user provided function.
+ */
+class CallbackSink : public SerializeSink
+{
+public:
+  using Callback = std::function<void(const char*, std::size_t)>;
+
+  explicit CallbackSink(Callback callback);
+  ~CallbackSink() override;
+
+  void Write(const char* data, std::size_t size) override;
+
+private:
+  Callback m_callback;
+};
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_SERIALIZE_SINK_H_
@@ -22,14 +22,22 @@
 
 #include "tree_data.h"
 
+#include "tree_data_utils.h"
+
 #include <sup/xml/exceptions.h>
 
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
 
 namespace
 {
-bool EqualAttributes(const std::vector<sup::xml::TreeData::Attribute>& left,
-                     const std::vector<sup::xml::TreeData::Attribute>& right);
+bool EqualNodes(const sup::xml::TreeData& left, const sup::xml::TreeData& right);
+
+std::size_t NodeHash(const sup::xml::TreeData& tree_data);
+
+// Below this number of children, a linear scan is cheaper than building and consulting an index.
+const std::size_t kMinIndexedChildren = 16;
 }  // unnamed namespace
 
 namespace sup
@@ -37,35 +45,148 @@ namespace sup
 namespace xml
 {
 
-TreeData::TreeData(const std::string& node_name)
+struct TreeData::ChildIndex
+{
+  std::unordered_map<InternedString, std::vector<std::size_t>> positions{};
+  // Children from this position on are not indexed and are always checked directly
+  std::size_t n_indexed = 0;
+};
+
+TreeData::TreeData(std::string node_name)
   : m_node_name{node_name}
   , m_content{}
   , m_attributes{}
   , m_children{}
+  , m_child_index{nullptr}
 {}
 
-TreeData::~TreeData() = default;
+TreeData::TreeData(InternedString node_name)
+  : m_node_name{node_name}
+  , m_content{}
+  , m_attributes{}
+  , m_children{}
+  , m_child_index{nullptr}
+{}
 
-TreeData::TreeData(const TreeData& other) = default;
-TreeData::TreeData(TreeData&& other) noexcept = default;
+TreeData::~TreeData()
+{
+  ResetChildIndex();
+  if (m_children.empty())
+  {
+    return;
+  }
+  // Detach the child lists of all descendants first, so every node is destroyed without children
+  // and destruction does not recurse.
+  std::vector<std::vector<TreeData>> pending;
+  pending.push_back(std::move(m_children));
+  while (!pending.empty())
+  {
+    auto children = std::move(pending.back());
+    pending.pop_back();
+    for (auto& child : children)
+    {
+      if (!child.m_children.empty())
+      {
+        pending.push_back(std::move(child.m_children));
+      }
+    }
+  }
+}
 
-TreeData& TreeData::operator=(const TreeData& other) & = default;
-TreeData& TreeData::operator=(TreeData&& other) & noexcept = default;
+TreeData::TreeData(const TreeData& other)
+  : m_node_name{other.m_node_name}
+  , m_content{other.m_content}
+  , m_attributes{other.m_attributes}
+  , m_children{}
+  , m_child_index{nullptr}
+{
+  if (other.m_children.empty())
+  {
+    return;
+  }
+  // Copy level by level: child lists are reserved up front, so the copies stay in place while
+  // their own children are added later.
+  std::vector<std::pair<const TreeData*, TreeData*>> stack{{&other, this}};
+  while (!stack.empty())
+  {
+    const auto [source, target] = stack.back();
+    stack.pop_back();
+    target->m_children.reserve(source->m_children.size());
+    for (const auto& child : source->m_children)
+    {
+      auto& copy = target->m_children.emplace_back(child.m_node_name);
+      copy.m_content = child.m_content;
+      copy.m_attributes = child.m_attributes;
+      if (!child.m_children.empty())
+      {
+        stack.emplace_back(&child, &copy);
+      }
+    }
+  }
+}
+
+TreeData::TreeData(TreeData&& other) noexcept
+  : m_node_name{other.m_node_name}
+  , m_content{std::move(other.m_content)}
+  , m_attributes{std::move(other.m_attributes)}
+  , m_children{std::move(other.m_children)}
+  , m_child_index{other.m_child_index.exchange(nullptr)}
+{}
+
+TreeData& TreeData::operator=(const TreeData& other) &
+{
+  if (this != &other)
+  {
+    *this = TreeData{other};
+  }
+  return *this;
+}
+
+TreeData& TreeData::operator=(TreeData&& other) & noexcept
+{
+  if (this != &other)
+  {
+    // Move out first: other may be one of the descendants that are destroyed below.
+    TreeData moved{std::move(other)};
+    m_node_name = moved.m_node_name;
+    m_content = std::move(moved.m_content);
+    m_attributes = std::move(moved.m_attributes);
+    m_children = std::move(moved.m_children);
+    ResetChildIndex();
+    m_child_index.store(moved.m_child_index.exchange(nullptr));
+  }
+  return *this;
+}
 
 std::string TreeData::GetNodeName() const
 {
   return m_node_name;
 }
 
+const InternedString& TreeData::GetInternedNodeName() const &
+{
+  return m_node_name;
+}
+
+std::string_view TreeData::NodeName() const &
+{
+  return m_node_name;
+}
+
 size_t TreeData::GetNumberOfAttributes() const
 {
   return m_attributes.size();
 }
 
 bool TreeData::HasAttribute(const std::string& name) const
+{
+  return FindAttribute(name) != nullptr;
+}
+
+bool TreeData::HasAttribute(const InternedString& name) const
 {
   auto it = std::find_if(m_attributes.begin(), m_attributes.end(),
-                         [name](const Attribute& attr)
+                         [&name](const Attribute& attr)
                          {
                            return attr.first == name;
                          });
@@ -74,18 +195,26 @@ bool TreeData::HasAttribute(const std::string& name) const
 
 std::string TreeData::GetAttribute(const std::string& name) const
 {
-  auto it = std::find_if(m_attributes.begin(), m_attributes.end(),
-                         [name](const Attribute& attr)
-                         {
-                           return attr.first == name;
-                         });
-  if (it == m_attributes.end())
+  auto value = FindAttribute(name);
+  if (value == nullptr)
   {
     std::string message = "TreeData::GetAttribute(): attribute with name [" +
       name + "] does not exist";
     throw InvalidOperationException(message);
   }
-  return it->second;
+  return *value;
+}
+
+const std::string* TreeData::FindAttribute(std::string_view name) const &
+{
+  for (const auto& attr : m_attributes)
+  {
+    if (std::string_view{attr.first} == name)
+    {
+      return &attr.second;
+    }
+  }
+  return nullptr;
 }
 
 const std::vector<TreeData::Attribute>& TreeData::Attributes() const &
@@ -93,15 +222,32 @@ const std::vector<TreeData::Attribute>& TreeData::Attributes() const &
   return m_attributes;
 }
 
-void TreeData::AddAttribute(const std::string& name, const std::string& value)
+void TreeData::AddAttribute(std::string name, std::string value)
 {
-  if (HasAttribute(name))
+  const InternedString interned_name{name};
+  if (HasAttribute(interned_name))
   {
     std::string message = "TreeData::AddAttribute(): attribute with name [" +
       name + "] already exists";
     throw InvalidOperationException(message);
   }
-  (void)m_attributes.emplace_back(name, value);
+  (void)m_attributes.emplace_back(interned_name, std::move(value));
+}
+
+void TreeData::AddAttribute(InternedString name, std::string value)
+{
+  if (HasAttribute(name))
+  {
+    std::string message = "TreeData::AddAttribute(): attribute with name [" +
+      std::string(name) + "] already exists";
+    throw InvalidOperationException(message);
+  }
+  (void)m_attributes.emplace_back(name, std::move(value));
+}
+
+void TreeData::ReserveAttributes(std::size_t n_attributes)
+{
+  m_attributes.reserve(n_attributes);
 }
 
 size_t TreeData::GetNumberOfChildren() const
@@ -111,39 +257,225 @@ size_t TreeData::GetNumberOfChildren() const
 
 void TreeData::AddChild(const TreeData& child)
 {
+  ResetChildIndex();
   m_children.push_back(child);
 }
 
+void TreeData::AddChild(TreeData&& child)
+{
+  ResetChildIndex();
+  m_children.push_back(std::move(child));
+}
+
+TreeData& TreeData::EmplaceChild(std::string node_name)
+{
+  ResetChildIndex();
+  return m_children.emplace_back(std::move(node_name));
+}
+
+TreeData& TreeData::EmplaceChild(InternedString node_name)
+{
+  ResetChildIndex();
+  return m_children.emplace_back(node_name);
+}
+
 const std::vector<TreeData>& TreeData::Children() const &
 {
   return m_children;
 }
 
+const TreeData* TreeData::FindChild(std::string_view tag) const &
+{
+  InternedString interned_tag;
+  if (!InternedString::Find(tag, interned_tag))
+  {
+    return nullptr;
+  }
+  return FindChild(interned_tag);
+}
+
+const TreeData* TreeData::FindChild(const InternedString& tag) const &
+{
+  std::size_t first_unindexed = 0;
+  if (const auto* index = GetChildIndex())
+  {
+    auto it = index->positions.find(tag);
+    if (it != index->positions.end())
+    {
+      return &m_children[it->second.front()];
+    }
+    first_unindexed = index->n_indexed;
+  }
+  for (std::size_t idx = first_unindexed; idx < m_children.size(); ++idx)
+  {
+    if (m_children[idx].m_node_name == tag)
+    {
+      return &m_children[idx];
+    }
+  }
+  return nullptr;
+}
+
+std::vector<const TreeData*> TreeData::FindChildren(std::string_view tag) const &
+{
+  InternedString interned_tag;
+  if (!InternedString::Find(tag, interned_tag))
+  {
+    return {};
+  }
+  return FindChildren(interned_tag);
+}
+
+std::vector<const TreeData*> TreeData::FindChildren(const InternedString& tag) const &
+{
+  std::vector<const TreeData*> result;
+  ForEachChildWithTag(tag, [this, &result](std::size_t idx) {
+    result.push_back(&m_children[idx]);
+  });
+  return result;
+}
+
+std::size_t TreeData::CountChildren(std::string_view tag) const
+{
+  InternedString interned_tag;
+  if (!InternedString::Find(tag, interned_tag))
+  {
+    return 0;
+  }
+  return CountChildren(interned_tag);
+}
+
+std::size_t TreeData::CountChildren(const InternedString& tag) const
+{
+  std::size_t count = 0;
+  ForEachChildWithTag(tag, [&count](std::size_t) { ++count; });
+  return count;
+}
+
+template <typename F>
+void TreeData::ForEachChildWithTag(const InternedString& tag, F&& func) const
+{
+  std::size_t first_unindexed = 0;
+  if (const auto* index = GetChildIndex())
+  {
+    auto it = index->positions.find(tag);
+    if (it != index->positions.end())
+    {
+      for (auto idx : it->second)
+      {
+        func(idx);
+      }
+    }
+    first_unindexed = index->n_indexed;
+  }
+  for (std::size_t idx = first_unindexed; idx < m_children.size(); ++idx)
+  {
+    if (m_children[idx].m_node_name == tag)
+    {
+      func(idx);
+    }
+  }
+}
+
+const TreeData::ChildIndex* TreeData::GetChildIndex() const
+{
+  if (m_children.size() < kMinIndexedChildren)
+  {
+    return nullptr;
+  }
+  if (const auto* index = m_child_index.load(std::memory_order_acquire))
+  {
+    return index;
+  }
+  // Concurrent readers may each build an index: the first one to publish it wins. The last child
+  // is left out, since it may still be replaced through the reference returned by EmplaceChild.
+  auto index = std::make_unique<ChildIndex>();
+  index->n_indexed = m_children.size() - 1;
+  for (std::size_t idx = 0; idx < index->n_indexed; ++idx)
+  {
+    index->positions[m_children[idx].m_node_name].push_back(idx);
+  }
+  const ChildIndex* expected = nullptr;
+  if (m_child_index.compare_exchange_strong(expected, index.get(), std::memory_order_acq_rel))
+  {
+    return index.release();
+  }
+  return expected;
+}
+
+void TreeData::ResetChildIndex()
+{
+  delete m_child_index.exchange(nullptr);
+}
+
 void TreeData::SetContent(const std::string& content)
 {
   m_content = content;
 }
 
+void TreeData::SetContent(std::string&& content)
+{
+  m_content = std::move(content);
+}
+
 std::string TreeData::GetContent() const
 {
   return m_content;
 }
 
+std::string_view TreeData::Content() const &
+{
+  return m_content;
+}
+
 bool operator==(const TreeData& left, const TreeData& right)
 {
-  if (left.GetNodeName() != right.GetNodeName())
+  // Compare node by node in pre-order, keeping a cursor into the children of each pair of opened
+  // nodes, so a difference close to the root is found without descending into any subtree.
+  if (!EqualNodes(left, right))
   {
     return false;
   }
-  if (left.GetContent() != right.GetContent())
+  struct CompareStackNode
   {
-    return false;
-  }
-  if (!EqualAttributes(left.Attributes(), right.Attributes()))
+    const TreeData* left;
+    const TreeData* right;
+    std::size_t next_child;
+  };
+  std::vector<CompareStackNode> stack{{&left, &right, 0}};
+  while (!stack.empty())
   {
-    return false;
+    auto& top_node = stack.back();
+    const auto& left_children = top_node.left->Children();
+    const auto& right_children = top_node.right->Children();
+    const TreeData* left_parent = nullptr;
+    const TreeData* right_parent = nullptr;
+    // Leaves are handled here, the first child that has children of its own is opened next
+    while (top_node.next_child < left_children.size() && left_parent == nullptr)
+    {
+      const auto& left_child = left_children[top_node.next_child];
+      const auto& right_child = right_children[top_node.next_child];
+      ++top_node.next_child;
+      if (!EqualNodes(left_child, right_child))
+      {
+        return false;
+      }
+      if (left_child.GetNumberOfChildren() > 0)
+      {
+        left_parent = &left_child;
+        right_parent = &right_child;
+      }
+    }
+    if (left_parent != nullptr)
+    {
+      stack.push_back({left_parent, right_parent, 0});
+    }
+    else
+    {
+      stack.pop_back();
+    }
   }
-  return left.Children() == right.Children();
+  return true;
 }
 
 bool operator!=(const TreeData& left, const TreeData& right)
@@ -151,19 +483,62 @@ bool operator!=(const TreeData& left, const TreeData& right)
   return !(left == right);
 }
 
+std::size_t Hash(const TreeData& tree_data)
+{
+  // Post-order: the hash of a node is completed when all its children were combined into it
+  struct HashStackNode
+  {
+    const TreeData* tree;
+    std::size_t next_child;
+    std::size_t hash;
+  };
+  std::vector<HashStackNode> stack{{&tree_data, 0, NodeHash(tree_data)}};
+  while (true)
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.tree->Children();
+    if (top_node.next_child < children.size())
+    {
+      const auto& child = children[top_node.next_child++];
+      stack.push_back({&child, 0, NodeHash(child)});
+      continue;
+    }
+    const auto hash = top_node.hash;
+    stack.pop_back();
+    if (stack.empty())
+    {
+      return hash;
+    }
+    stack.back().hash = HashCombine(stack.back().hash, hash);
+  }
+}
+
 }  // namespace xml
 
 }  // namespace sup
 
 namespace
 {
-bool EqualAttributes(const std::vector<sup::xml::TreeData::Attribute>& left,
-                     const std::vector<sup::xml::TreeData::Attribute>& right)
+bool EqualNodes(const sup::xml::TreeData& left, const sup::xml::TreeData& right)
 {
-  if (left.size() != right.size())
+  // Interned names compare by handle, so a different tag is rejected first
+  return left.GetInternedNodeName() == right.GetInternedNodeName() &&
+         left.Content() == right.Content() &&
+         sup::xml::EqualAttributes(left.Attributes(), right.Attributes()) &&
+         left.GetNumberOfChildren() == right.GetNumberOfChildren();
+}
+
+std::size_t NodeHash(const sup::xml::TreeData& tree_data)
+{
+  const std::hash<std::string_view> hasher;
+  auto result = sup::xml::HashCombine(hasher(tree_data.NodeName()), hasher(tree_data.Content()));
+  // Summing the attribute hashes makes the result independent of their order
+  std::size_t attributes_hash = 0;
+  for (const auto& attr : tree_data.Attributes())
   {
-    return false;
+    attributes_hash += sup::xml::HashCombine(hasher(attr.first), hasher(attr.second));
   }
-  return std::is_permutation(left.begin(), left.end(), right.begin());
+  result = sup::xml::HashCombine(result, attributes_hash);
+  return sup::xml::HashCombine(result, tree_data.GetNumberOfChildren());
 }
 }  // unnamed namespace
@@ -23,7 +23,13 @@
 #ifndef SUP_XML_TREE_DATA_H_
 #define SUP_XML_TREE_DATA_H_
 
+#include <sup/xml/interned_string.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -31,20 +37,27 @@ namespace sup
 {
 namespace xml
 {
+struct TreeDataEdit;
+
 /**
  * @brief In-memory representation of an XML tree.
+ *
+ * @details Node names and attribute names are interned, so comparing them reduces to a pointer
+ * comparison. Copying, destruction and comparison do not recurse, so trees of any depth can be
+ * handled.
  */
 class TreeData
 {
 public:
-  using Attribute = std::pair<std::string, std::string>;
+  using Attribute = std::pair<InternedString, std::string>;
 
   /**
    * @brief Constructor.
    *
    * @param node_name Name of the current node.
    */
-  explicit TreeData(const std::string& node_name);
+  explicit TreeData(std::string node_name);
+  explicit TreeData(InternedString node_name);
 
   ~TreeData();
 
@@ -67,6 +80,20 @@ public:
    */
   std::string GetNodeName() const;
 
+  /**
+   * @brief Retrieve the interned name of the current node.
+   *
+   * @return Interned name of the current node.
+   */
+  const InternedString& GetInternedNodeName() const &;
+
+  /**
+   * @brief View the name of the current node without copying.
+   *
+   * @return View of the (null-terminated) name, valid as long as this node is not modified.
+   */
+  std::string_view NodeName() const &;
+
   /**
    * @brief Get number of attributes.
    *
@@ -82,6 +109,7 @@ public:
    * @return true when present.
    */
   bool HasAttribute(const std::string& name) const;
+  bool HasAttribute(const InternedString& name) const;
 
   /**
    * @brief Get attribute with given name.
@@ -94,6 +122,16 @@ public:
    */
   std::string GetAttribute(const std::string& name) const;
 
+  /**
+   * @brief Find attribute with given name without copying.
+   *
+   * @param name Attribute name.
+   *
+   * @return Pointer to the attribute value or nullptr when no attribute with the given name
+   * exists. The pointer is valid as long as this node is not modified.
+   */
+  const std::string* FindAttribute(std::string_view name) const &;
+
   /**
    * @brief Retrieve a list of all attributes.
    *
@@ -111,7 +149,14 @@ public:
    *
    * @throw InvalidOperationException when an attribute with the given name already exists.
    */
-  void AddAttribute(const std::string& name, const std::string& value);
+  void AddAttribute(std::string name, std::string value);
+  void AddAttribute(InternedString name, std::string value);
+
+  /**
+   * @brief Reserve room for the given total number of attributes, e.g. when it is known before
+   * they are added. This avoids repeated reallocation of the attribute list.
+   */
+  void ReserveAttributes(std::size_t n_attributes);
 
   /**
    * @brief Get number of children.
@@ -126,6 +171,19 @@ public:
    * @param child Data representation of child element.
    */
   void AddChild(const TreeData& child);
+  void AddChild(TreeData&& child);
+
+  /**
+   * @brief Construct a new child element in place.
+   *
+   * @param node_name Name of the new child element.
+   *
+   * @return Reference to the newly created child element.
+   *
+   * @note The returned reference is invalidated when another child is added to this element.
+   */
+  TreeData& EmplaceChild(std::string node_name);
+  TreeData& EmplaceChild(InternedString node_name);
 
   /**
    * @brief Retrieve all child data elements.
@@ -134,6 +192,33 @@ public:
    */
   const std::vector<TreeData>& Children() const &;
 
+  /**
+   * @brief Find the first child element with the given tag.
+   *
+   * @param tag Tag of the child element.
+   *
+   * @return Pointer to the child element or nullptr when there is none. The pointer is valid as
+   * long as this node is not modified.
+   *
+   * @details Elements with many children build an index from tag to child positions on the first
+   * lookup, so further lookups take constant time until a child is added. Lookups can be done
+   * concurrently from multiple threads.
+   */
+  const TreeData* FindChild(std::string_view tag) const &;
+  const TreeData* FindChild(const InternedString& tag) const &;
+
+  /**
+   * @brief Find all child elements with the given tag, in order.
+   */
+  std::vector<const TreeData*> FindChildren(std::string_view tag) const &;
+  std::vector<const TreeData*> FindChildren(const InternedString& tag) const &;
+
+  /**
+   * @brief Count the child elements with the given tag.
+   */
+  std::size_t CountChildren(std::string_view tag) const;
+  std::size_t CountChildren(const InternedString& tag) const;
+
   /**
    * @brief Set element content string.
    *
@@ -142,6 +227,7 @@ public:
    * @details Overwrites if already present.
    */
   void SetContent(const std::string& content);
+  void SetContent(std::string&& content);
 
   /**
    * @brief Retrieve element content string.
@@ -150,18 +236,65 @@ public:
    */
   std::string GetContent() const;
 
+  /**
+   * @brief View the element content string without copying.
+   *
+   * @return View of the (null-terminated) content, valid as long as this node is not modified.
+   */
+  std::string_view Content() const &;
+
 private:
-  std::string m_node_name;
+  friend void ApplyPatch(TreeData& tree_data, const std::vector<TreeDataEdit>& patch);
+
+  struct ChildIndex;
+
+  //! Positions of the children with the given tag, using (and building) the index when worthwhile.
+  template <typename F>
+  void ForEachChildWithTag(const InternedString& tag, F&& func) const;
+
+  //! Retrieve the child index, building it when needed. Returns nullptr for few children.
+  const ChildIndex* GetChildIndex() const;
+
+  //! Drop the child index after the list of children changed.
+  void ResetChildIndex();
+
+  InternedString m_node_name;
   std::string m_content;
   std::vector<Attribute> m_attributes;
   std::vector<TreeData> m_children;
+  mutable std::atomic<const ChildIndex*> m_child_index;
 };
 
+/**
+ * @brief Compare two trees structurally. The order of attributes is not significant, the order of
+ * children is.
+ */
 bool operator==(const TreeData& left, const TreeData& right);
 bool operator!=(const TreeData& left, const TreeData& right);
 
+/**
+ * @brief Structural hash of a tree, consistent with operator==: equal trees have equal hashes,
+ * independent of the order of their attributes.
+ *
+ * @details The hash is computed in a single pass over the tree, without recursion. It is stable
+ * within a process, but not across different standard library implementations.
+ */
+std::size_t Hash(const TreeData& tree_data);
+
 }  // namespace xml
 
 }  // namespace sup
 
+namespace std
+{
+template <>
+struct hash<sup::xml::TreeData>
+{
+  std::size_t operator()(const sup::xml::TreeData& tree_data) const
+  {
+    return sup::xml::Hash(tree_data);
+  }
+};
+}  // namespace std
+
 #endif  // SUP_XML_TREE_DATA_H_
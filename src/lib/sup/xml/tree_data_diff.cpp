@@ -0,0 +1,386 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_diff.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+using Path = std::vector<std::size_t>;
+
+/**
+ * @brief Pair of nodes with the same name whose content, attributes and children still need to be
+ * compared.
+ */
+struct DiffTask
+{
+  const sup::xml::TreeData* old_node;
+  const sup::xml::TreeData* new_node;
+  Path path;
+};
+
+void DiffNodeValues(const sup::xml::TreeData& old_node, const sup::xml::TreeData& new_node,
+                    const Path& path, sup::xml::TreeDataPatch& patch);
+
+void DiffChildren(const sup::xml::TreeData& old_node, const sup::xml::TreeData& new_node,
+                  const Path& path, sup::xml::TreeDataPatch& patch, std::vector<DiffTask>& tasks);
+
+std::vector<std::pair<std::size_t, std::size_t>> MatchUnchangedChildren(
+  const std::vector<sup::xml::TreeData>& old_children, std::size_t old_begin, std::size_t old_end,
+  const std::vector<sup::xml::TreeData>& new_children, std::size_t new_begin, std::size_t new_end);
+
+sup::xml::TreeDataEdit CreateEdit(sup::xml::TreeDataEdit::Kind kind, Path path);
+
+Path ChildPath(const Path& path, std::size_t idx);
+
+std::string PathToString(const Path& path);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+TreeDataPatch Diff(const TreeData& old_tree, const TreeData& new_tree)
+{
+  TreeDataPatch patch;
+  if (old_tree.GetInternedNodeName() != new_tree.GetInternedNodeName())
+  {
+    auto edit = CreateEdit(TreeDataEdit::Kind::kReplaceNode, {});
+    edit.node = new_tree;
+    patch.push_back(std::move(edit));
+    return patch;
+  }
+  // A node's own edits and the edits to its child list are all emitted before any of its children
+  // is visited, so the paths of the remaining tasks are already valid when they are emitted.
+  std::vector<DiffTask> tasks{{&old_tree, &new_tree, {}}};
+  while (!tasks.empty())
+  {
+    const auto task = std::move(tasks.back());
+    tasks.pop_back();
+    DiffNodeValues(*task.old_node, *task.new_node, task.path, patch);
+    DiffChildren(*task.old_node, *task.new_node, task.path, patch, tasks);
+  }
+  return patch;
+}
+
+void ApplyPatch(TreeData& tree_data, const TreeDataPatch& patch)
+{
+  for (const auto& edit : patch)
+  {
+    const bool child_list_edit = edit.kind == TreeDataEdit::Kind::kInsertNode ||
+                                 edit.kind == TreeDataEdit::Kind::kRemoveNode;
+    if (child_list_edit && edit.path.empty())
+    {
+      std::string message = "ApplyPatch(): cannot insert or remove the root node";
+      throw InvalidOperationException(message);
+    }
+    // Child list edits resolve the parent node, all other edits the node itself
+    const auto depth = child_list_edit ? edit.path.size() - 1 : edit.path.size();
+    TreeData* node = &tree_data;
+    TreeData* parent = nullptr;
+    for (std::size_t i = 0; i < depth; ++i)
+    {
+      if (edit.path[i] >= node->m_children.size())
+      {
+        std::string message = "ApplyPatch(): node with path [" + PathToString(edit.path) +
+          "] does not exist";
+        throw InvalidOperationException(message);
+      }
+      parent = node;
+      node = &node->m_children[edit.path[i]];
+    }
+    const bool needs_node = edit.kind == TreeDataEdit::Kind::kReplaceNode ||
+                            edit.kind == TreeDataEdit::Kind::kInsertNode;
+    if (needs_node && !edit.node.has_value())
+    {
+      std::string message = "ApplyPatch(): edit for path [" + PathToString(edit.path) +
+        "] has no node";
+      throw InvalidOperationException(message);
+    }
+    switch (edit.kind)
+    {
+    case TreeDataEdit::Kind::kReplaceNode:
+      // The replacement may carry another tag, which changes the parent's child index
+      if (parent != nullptr)
+      {
+        parent->ResetChildIndex();
+      }
+      *node = *edit.node;
+      break;
+    case TreeDataEdit::Kind::kInsertNode:
+    case TreeDataEdit::Kind::kRemoveNode:
+    {
+      auto& children = node->m_children;
+      const auto idx = edit.path.back();
+      const auto limit = edit.kind == TreeDataEdit::Kind::kInsertNode ? children.size() + 1
+                                                                      : children.size();
+      if (idx >= limit)
+      {
+        std::string message = "ApplyPatch(): child index in path [" + PathToString(edit.path) +
+          "] out of range";
+        throw InvalidOperationException(message);
+      }
+      node->ResetChildIndex();
+      auto pos = children.begin() + static_cast<std::ptrdiff_t>(idx);
+      if (edit.kind == TreeDataEdit::Kind::kInsertNode)
+      {
+        (void)children.insert(pos, *edit.node);
+      }
+      else
+      {
+        (void)children.erase(pos);
+      }
+      break;
+    }
+    case TreeDataEdit::Kind::kSetContent:
+      node->m_content = edit.value;
+      break;
+    case TreeDataEdit::Kind::kSetAttribute:
+    case TreeDataEdit::Kind::kRemoveAttribute:
+    {
+      auto& attributes = node->m_attributes;
+      auto it = std::find_if(attributes.begin(), attributes.end(),
+                             [&edit](const TreeData::Attribute& attr)
+                             {
+                               return attr.first == edit.name;
+                             });
+      if (edit.kind == TreeDataEdit::Kind::kSetAttribute)
+      {
+        if (it == attributes.end())
+        {
+          (void)attributes.emplace_back(InternedString{edit.name}, edit.value);
+        }
+        else
+        {
+          it->second = edit.value;
+        }
+        break;
+      }
+      if (it == attributes.end())
+      {
+        std::string message = "ApplyPatch(): attribute with name [" + edit.name +
+          "] does not exist in node with path [" + PathToString(edit.path) + "]";
+        throw InvalidOperationException(message);
+      }
+      (void)attributes.erase(it);
+      break;
+    }
+    default:
+    {
+      std::string message = "ApplyPatch(): unknown edit kind";
+      throw InvalidOperationException(message);
+    }
+    }
+  }
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+using sup::xml::TreeData;
+using sup::xml::TreeDataEdit;
+
+void DiffNodeValues(const TreeData& old_node, const TreeData& new_node, const Path& path,
+                    sup::xml::TreeDataPatch& patch)
+{
+  if (old_node.Content() != new_node.Content())
+  {
+    auto edit = CreateEdit(TreeDataEdit::Kind::kSetContent, path);
+    edit.value = new_node.Content();
+    patch.push_back(std::move(edit));
+  }
+  const auto& old_attributes = old_node.Attributes();
+  const auto& new_attributes = new_node.Attributes();
+  if (old_attributes == new_attributes)
+  {
+    return;
+  }
+  for (const auto& attr : old_attributes)
+  {
+    if (!new_node.HasAttribute(attr.first))
+    {
+      auto edit = CreateEdit(TreeDataEdit::Kind::kRemoveAttribute, path);
+      edit.name = attr.first;
+      patch.push_back(std::move(edit));
+    }
+  }
+  for (const auto& attr : new_attributes)
+  {
+    auto it = std::find_if(old_attributes.begin(), old_attributes.end(),
+                           [&attr](const TreeData::Attribute& other)
+                           {
+                             return other.first == attr.first;
+                           });
+    if (it == old_attributes.end() || it->second != attr.second)
+    {
+      auto edit = CreateEdit(TreeDataEdit::Kind::kSetAttribute, path);
+      edit.name = attr.first;
+      edit.value = attr.second;
+      patch.push_back(std::move(edit));
+    }
+  }
+}
+
+void DiffChildren(const TreeData& old_node, const TreeData& new_node, const Path& path,
+                  sup::xml::TreeDataPatch& patch, std::vector<DiffTask>& tasks)
+{
+  const auto& old_children = old_node.Children();
+  const auto& new_children = new_node.Children();
+  // Skip identical children at both ends: for small edits this leaves only the changed children
+  std::size_t begin = 0;
+  while (begin < old_children.size() && begin < new_children.size() &&
+         old_children[begin] == new_children[begin])
+  {
+    ++begin;
+  }
+  auto old_end = old_children.size();
+  auto new_end = new_children.size();
+  while (old_end > begin && new_end > begin &&
+         old_children[old_end - 1] == new_children[new_end - 1])
+  {
+    --old_end;
+    --new_end;
+  }
+  if (begin == old_end && begin == new_end)
+  {
+    return;
+  }
+  auto anchors = MatchUnchangedChildren(old_children, begin, old_end,
+                                        new_children, begin, new_end);
+  anchors.emplace_back(old_end, new_end);
+  // Align the gaps between unchanged children. The next child to be placed in the patched list
+  // always has its index in new_node, since all children before it are already final.
+  auto old_idx = begin;
+  auto new_idx = begin;
+  for (const auto& anchor : anchors)
+  {
+    while (old_idx < anchor.first || new_idx < anchor.second)
+    {
+      const auto n_old = anchor.first - old_idx;
+      const auto n_new = anchor.second - new_idx;
+      if (n_old > 0 && n_new > 0 && old_children[old_idx].GetInternedNodeName() ==
+                                    new_children[new_idx].GetInternedNodeName())
+      {
+        tasks.push_back({&old_children[old_idx], &new_children[new_idx],
+                         ChildPath(path, new_idx)});
+        ++old_idx;
+        ++new_idx;
+      }
+      else if (n_new > n_old)
+      {
+        auto edit = CreateEdit(TreeDataEdit::Kind::kInsertNode, ChildPath(path, new_idx));
+        edit.node = new_children[new_idx];
+        patch.push_back(std::move(edit));
+        ++new_idx;
+      }
+      else if (n_old > n_new)
+      {
+        patch.push_back(CreateEdit(TreeDataEdit::Kind::kRemoveNode, ChildPath(path, new_idx)));
+        ++old_idx;
+      }
+      else
+      {
+        auto edit = CreateEdit(TreeDataEdit::Kind::kReplaceNode, ChildPath(path, new_idx));
+        edit.node = new_children[new_idx];
+        patch.push_back(std::move(edit));
+        ++old_idx;
+        ++new_idx;
+      }
+    }
+    // Skip the unchanged child itself
+    ++old_idx;
+    ++new_idx;
+  }
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> MatchUnchangedChildren(
+  const std::vector<TreeData>& old_children, std::size_t old_begin, std::size_t old_end,
+  const std::vector<TreeData>& new_children, std::size_t new_begin, std::size_t new_end)
+{
+  std::vector<std::pair<std::size_t, std::size_t>> result;
+  if (old_begin == old_end || new_begin == new_end)
+  {
+    return result;
+  }
+  // Indices of the new children per hash, in ascending order
+  std::unordered_map<std::size_t, std::vector<std::size_t>> new_indices;
+  for (auto idx = new_begin; idx < new_end; ++idx)
+  {
+    new_indices[sup::xml::Hash(new_children[idx])].push_back(idx);
+  }
+  // Greedily match each old child with the first equal new child after the previous match
+  auto next_new = new_begin;
+  for (auto old_idx = old_begin; old_idx < old_end && next_new < new_end; ++old_idx)
+  {
+    auto it = new_indices.find(sup::xml::Hash(old_children[old_idx]));
+    if (it == new_indices.end())
+    {
+      continue;
+    }
+    const auto& candidates = it->second;
+    for (auto cand = std::lower_bound(candidates.begin(), candidates.end(), next_new);
+         cand != candidates.end(); ++cand)
+    {
+      if (old_children[old_idx] == new_children[*cand])
+      {
+        result.emplace_back(old_idx, *cand);
+        next_new = *cand + 1;
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+TreeDataEdit CreateEdit(TreeDataEdit::Kind kind, Path path)
+{
+  TreeDataEdit result;
+  result.kind = kind;
+  result.path = std::move(path);
+  return result;
+}
+
+Path ChildPath(const Path& path, std::size_t idx)
+{
+  Path result{path};
+  result.push_back(idx);
+  return result;
+}
+
+std::string PathToString(const Path& path)
+{
+  std::string result;
+  for (const auto idx : path)
+  {
+    result += "/" + std::to_string(idx);
+  }
+  return result.empty() ? "/" : result;
+}
+}  // unnamed namespace
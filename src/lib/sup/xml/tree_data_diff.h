@@ -0,0 +1,100 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_DIFF_H_
+#define SUP_XML_TREE_DATA_DIFF_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Single edit of a TreeData patch.
+ *
+ * @details The node an edit applies to is addressed by its path: the child indices from the root
+ * node down to that node (an empty path denotes the root node itself). Paths refer to the tree as
+ * it is when the edit is applied, i.e. after all preceding edits of the patch.
+ */
+struct TreeDataEdit
+{
+  enum class Kind
+  {
+    kReplaceNode = 0,   //!< Replace the node at path with node.
+    kInsertNode,        //!< Insert node as child at the position given by the last path index.
+    kRemoveNode,        //!< Remove the node at path.
+    kSetContent,        //!< Set the content of the node at path to value.
+    kSetAttribute,      //!< Add attribute name or overwrite its value with value.
+    kRemoveAttribute    //!< Remove attribute name.
+  };
+  Kind kind = Kind::kReplaceNode;
+  std::vector<std::size_t> path{};
+  std::string name{};
+  std::string value{};
+  std::optional<TreeData> node{};
+};
+
+/**
+ * @brief Ordered list of edits that transforms one tree into another.
+ */
+using TreeDataPatch = std::vector<TreeDataEdit>;
+
+/**
+ * @brief Compute the edits that transform a tree into another one.
+ *
+ * @param old_tree Original tree.
+ * @param new_tree Modified tree.
+ *
+ * @return Patch that, when applied to old_tree, yields a tree equal to new_tree. The patch is empty
+ * when both trees are equal.
+ *
+ * @details Children are matched in order by their tag name: runs of identical children at the
+ * start and end of each child list are skipped and unchanged subtrees in between are recognized by
+ * their structural hash. Only the nodes that actually differ are visited in depth, so the cost is
+ * close to linear in the size of the trees. Edits are ordered such that every change to a subtree
+ * is preceded by the changes to the child list that contains it. Paths of changed nodes, except
+ * for removed ones, are their paths in new_tree.
+ */
+TreeDataPatch Diff(const TreeData& old_tree, const TreeData& new_tree);
+
+/**
+ * @brief Apply a patch to a tree.
+ *
+ * @param tree_data Tree to modify.
+ * @param patch Patch to apply.
+ *
+ * @throw InvalidOperationException when an edit refers to a node or attribute that does not
+ * exist. Edits preceding the failing one remain applied.
+ */
+void ApplyPatch(TreeData& tree_data, const TreeDataPatch& patch);
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_DIFF_H_
@@ -0,0 +1,649 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_file_cache.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/mapped_file.h>
+#include <sup/xml/tree_data_traversal.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+using sup::xml::TreeData;
+
+// Identifies the entry format. Change it whenever the layout below changes.
+const char kEntryMagic[8] = {'S', 'U', 'P', 'X', 'T', 'D', 'C', '1'};
+
+// Fixed part of an entry: magic, source size, source modification time, source content hash,
+// payload size and payload hash, each stored as eight little-endian bytes. It is followed by the
+// source path and the payload with the tree in pre-order.
+const std::size_t kEntryHeaderSize = 48;
+
+// Temporary entries older than this are left over from a writer that died before renaming them.
+// Writing an entry takes far less, so younger ones may still belong to a live writer.
+const std::chrono::seconds kStaleTemporaryAge{3600};
+
+struct SourceInfo
+{
+  std::uint64_t size;
+  std::uint64_t mtime_ns;
+};
+
+/**
+ * @brief Sequential reader of entry data that reports truncated or malformed input instead of
+ * reading past its end.
+ */
+class EntryReader
+{
+public:
+  EntryReader(const char* data, std::size_t size);
+
+  bool ReadFixed(std::uint64_t& value);
+  bool ReadVarint(std::uint64_t& value);
+  bool ReadString(std::string_view& str);
+  std::string_view Remaining() const;
+  bool AtEnd() const;
+
+private:
+  const char* m_pos;
+  const char* m_end;
+};
+
+bool GetSourceInfo(const std::string& filename, SourceInfo& info);
+
+std::string AbsolutePath(const std::string& filename);
+
+std::uint64_t ContentHash(const char* data, std::size_t size);
+
+std::string HexString(std::uint64_t value);
+
+std::uint64_t NextTemporaryId();
+
+void RemoveStaleTemporaryEntries(const std::string& cache_directory);
+
+void PutFixed(std::string& out, std::uint64_t value);
+
+void PutVarint(std::string& out, std::uint64_t value);
+
+void PutString(std::string& out, std::string_view str);
+
+std::string SerializeTree(const TreeData& tree);
+
+std::unique_ptr<TreeData> DeserializeTree(std::string_view payload);
+
+bool WriteFile(const std::string& filename, const std::string& contents);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+struct TreeDataFileCache::TreeDataFileCacheImpl
+{
+  explicit TreeDataFileCacheImpl(std::string cache_directory);
+
+  //! Name of the cache entry for the given absolute path.
+  std::string EntryName(const std::string& path) const;
+
+  //! Load a valid entry or return nullptr. Sets rejected when an entry existed but was unusable.
+  std::unique_ptr<TreeData> LoadEntry(const std::string& entry_name, const std::string& path,
+                                      const SourceInfo& info, std::uint64_t content_hash,
+                                      bool& rejected) const;
+
+  //! Write an entry atomically. Returns false when it could not be written.
+  bool StoreEntry(const std::string& entry_name, const std::string& path, const SourceInfo& info,
+                  std::uint64_t content_hash, const TreeData& tree);
+
+  std::string m_cache_directory;
+  std::atomic<std::size_t> m_hits;
+  std::atomic<std::size_t> m_misses;
+  std::atomic<std::size_t> m_rejected_entries;
+  std::atomic<std::size_t> m_write_errors;
+};
+
+TreeDataFileCache::TreeDataFileCache(const std::string& cache_directory)
+  : p_impl{std::make_unique<TreeDataFileCacheImpl>(cache_directory)}
+{
+  std::error_code error;
+  (void)std::filesystem::create_directories(cache_directory, error);
+  if (error || !std::filesystem::is_directory(cache_directory, error))
+  {
+    std::string message = "TreeDataFileCache::TreeDataFileCache(): could not create cache "
+                          "directory [" + cache_directory + "]";
+    throw InvalidOperationException(message);
+  }
+  RemoveStaleTemporaryEntries(cache_directory);
+}
+
+TreeDataFileCache::~TreeDataFileCache() = default;
+
+std::unique_ptr<TreeData> TreeDataFileCache::TreeDataFromFile(const std::string& filename,
+                                                              ParseMode mode)
+{
+  SourceInfo info{};
+  if (!GetSourceInfo(filename, info))
+  {
+    // Let the parser report the missing or unreadable file
+    ++p_impl->m_misses;
+    return xml::TreeDataFromFile(filename, mode);
+  }
+  std::uint64_t content_hash = 0;
+  {
+    const MappedFile source{filename};
+    content_hash = ContentHash(source.Data(), source.Size());
+  }
+  const auto path = AbsolutePath(filename);
+  const auto entry_name = p_impl->EntryName(path);
+  bool rejected = false;
+  if (auto tree = p_impl->LoadEntry(entry_name, path, info, content_hash, rejected))
+  {
+    ++p_impl->m_hits;
+    return tree;
+  }
+  ++p_impl->m_misses;
+  if (rejected)
+  {
+    ++p_impl->m_rejected_entries;
+  }
+  auto tree = xml::TreeDataFromFile(filename, mode);
+  // Only store the result when the file did not change while it was hashed and parsed
+  SourceInfo after{};
+  if (GetSourceInfo(filename, after) && after.size == info.size &&
+      after.mtime_ns == info.mtime_ns)
+  {
+    if (!p_impl->StoreEntry(entry_name, path, info, content_hash, *tree))
+    {
+      ++p_impl->m_write_errors;
+    }
+  }
+  return tree;
+}
+
+TreeDataFileCacheStatistics TreeDataFileCache::GetStatistics() const
+{
+  TreeDataFileCacheStatistics result;
+  result.hits = p_impl->m_hits.load();
+  result.misses = p_impl->m_misses.load();
+  result.rejected_entries = p_impl->m_rejected_entries.load();
+  result.write_errors = p_impl->m_write_errors.load();
+  return result;
+}
+
+void TreeDataFileCache::ResetStatistics()
+{
+  p_impl->m_hits = 0;
+  p_impl->m_misses = 0;
+  p_impl->m_rejected_entries = 0;
+  p_impl->m_write_errors = 0;
+}
+
+TreeDataFileCache::TreeDataFileCacheImpl::TreeDataFileCacheImpl(std::string cache_directory)
+  : m_cache_directory{std::move(cache_directory)}
+  , m_hits{0}
+  , m_misses{0}
+  , m_rejected_entries{0}
+  , m_write_errors{0}
+{}
+
+std::string TreeDataFileCache::TreeDataFileCacheImpl::EntryName(const std::string& path) const
+{
+  return m_cache_directory + "/" + HexString(ContentHash(path.data(), path.size())) + ".tdcache";
+}
+
+std::unique_ptr<TreeData> TreeDataFileCache::TreeDataFileCacheImpl::LoadEntry(
+  const std::string& entry_name, const std::string& path, const SourceInfo& info,
+  std::uint64_t content_hash, bool& rejected) const
+{
+  struct stat entry_stat;
+  if (stat(entry_name.c_str(), &entry_stat) != 0)
+  {
+    return nullptr;
+  }
+  rejected = true;
+  std::unique_ptr<MappedFile> entry;
+  try
+  {
+    entry = std::make_unique<MappedFile>(entry_name);
+  }
+  catch (const ParseException&)
+  {
+    return nullptr;
+  }
+  if (entry->Size() < kEntryHeaderSize ||
+      std::memcmp(entry->Data(), kEntryMagic, sizeof(kEntryMagic)) != 0)
+  {
+    return nullptr;
+  }
+  EntryReader reader{entry->Data() + sizeof(kEntryMagic), entry->Size() - sizeof(kEntryMagic)};
+  std::uint64_t size = 0;
+  std::uint64_t mtime_ns = 0;
+  std::uint64_t stored_hash = 0;
+  std::uint64_t payload_size = 0;
+  std::uint64_t payload_hash = 0;
+  std::string_view stored_path;
+  if (!reader.ReadFixed(size) || !reader.ReadFixed(mtime_ns) || !reader.ReadFixed(stored_hash) ||
+      !reader.ReadFixed(payload_size) || !reader.ReadFixed(payload_hash) ||
+      !reader.ReadString(stored_path))
+  {
+    return nullptr;
+  }
+  if (size != info.size || mtime_ns != info.mtime_ns || stored_hash != content_hash ||
+      stored_path != path)
+  {
+    return nullptr;
+  }
+  const auto payload = reader.Remaining();
+  if (payload.size() != payload_size || ContentHash(payload.data(), payload.size()) != payload_hash)
+  {
+    return nullptr;
+  }
+  auto tree = DeserializeTree(payload);
+  if (tree)
+  {
+    rejected = false;
+  }
+  return tree;
+}
+
+bool TreeDataFileCache::TreeDataFileCacheImpl::StoreEntry(
+  const std::string& entry_name, const std::string& path, const SourceInfo& info,
+  std::uint64_t content_hash, const TreeData& tree)
+{
+  const auto payload = SerializeTree(tree);
+  std::string contents{kEntryMagic, sizeof(kEntryMagic)};
+  contents.reserve(kEntryHeaderSize + path.size() + 10 + payload.size());
+  PutFixed(contents, info.size);
+  PutFixed(contents, info.mtime_ns);
+  PutFixed(contents, content_hash);
+  PutFixed(contents, payload.size());
+  PutFixed(contents, ContentHash(payload.data(), payload.size()));
+  PutString(contents, path);
+  contents.append(payload);
+  // Temporary names are unique per process and call, so concurrent writers never share one
+  const auto temporary_name = entry_name + "." + std::to_string(getpid()) + "." +
+                              std::to_string(NextTemporaryId()) + ".tmp";
+  if (!WriteFile(temporary_name, contents))
+  {
+    (void)unlink(temporary_name.c_str());
+    return false;
+  }
+  if (std::rename(temporary_name.c_str(), entry_name.c_str()) != 0)
+  {
+    (void)unlink(temporary_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+EntryReader::EntryReader(const char* data, std::size_t size)
+  : m_pos{data}
+  , m_end{data + size}
+{}
+
+bool EntryReader::ReadFixed(std::uint64_t& value)
+{
+  if (m_end - m_pos < 8)
+  {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < 8; ++i)
+  {
+    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(m_pos[i])) << (8 * i);
+  }
+  m_pos += 8;
+  return true;
+}
+
+bool EntryReader::ReadVarint(std::uint64_t& value)
+{
+  value = 0;
+  for (unsigned shift = 0; shift < 64 && m_pos != m_end; shift += 7)
+  {
+    const auto byte = static_cast<unsigned char>(*m_pos++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool EntryReader::ReadString(std::string_view& str)
+{
+  std::uint64_t size = 0;
+  if (!ReadVarint(size) || size > static_cast<std::uint64_t>(m_end - m_pos))
+  {
+    return false;
+  }
+  str = std::string_view{m_pos, static_cast<std::size_t>(size)};
+  m_pos += size;
+  return true;
+}
+
+std::string_view EntryReader::Remaining() const
+{
+  return {m_pos, static_cast<std::size_t>(m_end - m_pos)};
+}
+
+bool EntryReader::AtEnd() const
+{
+  return m_pos == m_end;
+}
+
+bool GetSourceInfo(const std::string& filename, SourceInfo& info)
+{
+  struct stat file_stat;
+  if (stat(filename.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+  {
+    return false;
+  }
+  info.size = static_cast<std::uint64_t>(file_stat.st_size);
+  info.mtime_ns = static_cast<std::uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000u +
+                  static_cast<std::uint64_t>(file_stat.st_mtim.tv_nsec);
+  return true;
+}
+
+std::string AbsolutePath(const std::string& filename)
+{
+  char* resolved = realpath(filename.c_str(), nullptr);
+  if (resolved == nullptr)
+  {
+    return filename;
+  }
+  std::string result{resolved};
+  std::free(resolved);
+  return result;
+}
+
+std::uint64_t ContentHash(const char* data, std::size_t size)
+{
+  // Word-at-a-time multiply-rotate hash: much faster than parsing, and a mismatch in any byte
+  // changes the result with overwhelming probability.
+  const std::uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+  std::uint64_t hash = 0xcbf29ce484222325ull ^ (size * kMultiplier);
+  std::size_t idx = 0;
+  for (; idx + 8 <= size; idx += 8)
+  {
+    std::uint64_t word;
+    std::memcpy(&word, data + idx, sizeof(word));
+    hash = (hash ^ word) * kMultiplier;
+    hash ^= hash >> 29;
+  }
+  for (; idx < size; ++idx)
+  {
+    hash = (hash ^ static_cast<unsigned char>(data[idx])) * kMultiplier;
+    hash ^= hash >> 29;
+  }
+  hash ^= hash >> 32;
+  hash *= kMultiplier;
+  return hash ^ (hash >> 29);
+}
+
+std::string HexString(std::uint64_t value)
+{
+  static const char kDigits[] = "0123456789abcdef";
+  std::string result(16, '0');
+  for (int i = 15; i >= 0; --i)
+  {
+    result[static_cast<std::size_t>(i)] = kDigits[value & 0xf];
+    value >>= 4;
+  }
+  return result;
+}
+
+std::uint64_t NextTemporaryId()
+{
+  static std::atomic<std::uint64_t> counter{0};
+  return counter++;
+}
+
+void RemoveStaleTemporaryEntries(const std::string& cache_directory)
+{
+  // Only remove files named like the temporary entries from StoreEntry and ignore all errors:
+  // another process may remove or rename the same files concurrently.
+  static const std::string kEntrySuffix = ".tdcache.";
+  static const std::string kTemporarySuffix = ".tmp";
+  std::error_code error;
+  std::filesystem::directory_iterator it{cache_directory, error};
+  if (error)
+  {
+    return;
+  }
+  const auto threshold = std::filesystem::file_time_type::clock::now() - kStaleTemporaryAge;
+  for (const std::filesystem::directory_iterator end; it != end; it.increment(error))
+  {
+    if (error)
+    {
+      return;
+    }
+    const auto filename = it->path().filename().string();
+    if (filename.size() <= kTemporarySuffix.size() ||
+        filename.compare(filename.size() - kTemporarySuffix.size(), kTemporarySuffix.size(),
+                         kTemporarySuffix) != 0 ||
+        filename.find(kEntrySuffix) == std::string::npos || !it->is_regular_file(error))
+    {
+      continue;
+    }
+    const auto last_write = it->last_write_time(error);
+    if (!error && last_write < threshold)
+    {
+      (void)std::filesystem::remove(it->path(), error);
+    }
+  }
+}
+
+void PutFixed(std::string& out, std::uint64_t value)
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void PutVarint(std::string& out, std::uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void PutString(std::string& out, std::string_view str)
+{
+  PutVarint(out, str.size());
+  out.append(str);
+}
+
+std::string SerializeTree(const TreeData& tree)
+{
+  // Names are written once and referred to by their position in the table afterwards
+  std::string out;
+  std::unordered_map<sup::xml::InternedString, std::uint64_t> names;
+  auto put_name = [&out, &names](const sup::xml::InternedString& name)
+  {
+    auto [it, inserted] = names.try_emplace(name, names.size());
+    PutVarint(out, it->second);
+    if (inserted)
+    {
+      PutString(out, static_cast<const std::string&>(name));
+    }
+  };
+  (void)sup::xml::Visit(tree,
+    [&out, &put_name](const TreeData& node, std::size_t)
+    {
+      put_name(node.GetInternedNodeName());
+      PutString(out, node.Content());
+      PutVarint(out, node.GetNumberOfAttributes());
+      for (const auto& [name, value] : node.Attributes())
+      {
+        put_name(name);
+        PutString(out, value);
+      }
+      PutVarint(out, node.GetNumberOfChildren());
+      return sup::xml::VisitAction::kContinue;
+    });
+  return out;
+}
+
+std::unique_ptr<TreeData> DeserializeTree(std::string_view payload)
+{
+  EntryReader reader{payload.data(), payload.size()};
+  std::vector<sup::xml::InternedString> names;
+  auto read_name = [&reader, &names](sup::xml::InternedString& name)
+  {
+    std::uint64_t id = 0;
+    if (!reader.ReadVarint(id) || id > names.size())
+    {
+      return false;
+    }
+    if (id == names.size())
+    {
+      std::string_view str;
+      if (!reader.ReadString(str))
+      {
+        return false;
+      }
+      names.emplace_back(std::string{str});
+    }
+    name = names[id];
+    return true;
+  };
+  // Reads the record of a node, except for its name, and returns its number of children
+  auto read_node = [&reader, &read_name](TreeData& node, std::uint64_t& n_children)
+  {
+    std::string_view content;
+    std::uint64_t n_attributes = 0;
+    if (!reader.ReadString(content) || !reader.ReadVarint(n_attributes))
+    {
+      return false;
+    }
+    node.SetContent(std::string{content});
+    for (std::uint64_t i = 0; i < n_attributes; ++i)
+    {
+      sup::xml::InternedString name;
+      std::string_view value;
+      if (!read_name(name) || !reader.ReadString(value) || node.HasAttribute(name))
+      {
+        return false;
+      }
+      node.AddAttribute(name, std::string{value});
+    }
+    return reader.ReadVarint(n_children);
+  };
+  sup::xml::InternedString root_name;
+  if (!read_name(root_name))
+  {
+    return nullptr;
+  }
+  auto result = std::make_unique<TreeData>(root_name);
+  std::uint64_t n_children = 0;
+  if (!read_node(*result, n_children))
+  {
+    return nullptr;
+  }
+  // Each frame holds a node and the number of its children that still need to be read
+  std::vector<std::pair<TreeData*, std::uint64_t>> stack;
+  if (n_children > 0)
+  {
+    stack.emplace_back(result.get(), n_children);
+  }
+  while (!stack.empty())
+  {
+    auto& [parent, remaining] = stack.back();
+    if (remaining == 0)
+    {
+      stack.pop_back();
+      continue;
+    }
+    --remaining;
+    sup::xml::InternedString name;
+    if (!read_name(name))
+    {
+      return nullptr;
+    }
+    auto& child = parent->EmplaceChild(name);
+    if (!read_node(child, n_children))
+    {
+      return nullptr;
+    }
+    if (n_children > 0)
+    {
+      stack.emplace_back(&child, n_children);
+    }
+  }
+  if (!reader.AtEnd())
+  {
+    return nullptr;
+  }
+  return result;
+}
+
+bool WriteFile(const std::string& filename, const std::string& contents)
+{
+  const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  const char* data = contents.data();
+  std::size_t remaining = contents.size();
+  while (remaining > 0)
+  {
+    const auto written = write(fd, data, remaining);
+    if (written <= 0)
+    {
+      (void)close(fd);
+      return false;
+    }
+    data += written;
+    remaining -= static_cast<std::size_t>(written);
+  }
+  return close(fd) == 0;
+}
+}  // unnamed namespace
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_FILE_CACHE_H_
+#define SUP_XML_TREE_DATA_FILE_CACHE_H_
+
+#include <sup/xml/tree_data.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Counters of a TreeDataFileCache.
+ */
+struct TreeDataFileCacheStatistics
+{
+  std::size_t hits{};             //!< Files loaded from a valid cache entry.
+  std::size_t misses{};           //!< Files that were parsed, including rejected entries.
+  std::size_t rejected_entries{}; //!< Cache entries that were stale or corrupt.
+  std::size_t write_errors{};     //!< Parsed files whose cache entry could not be written.
+};
+
+/**
+ * @brief Opt-in cache of parsed XML files on disk.
+ *
+ * @details Parsed trees are stored in a compact binary format in the cache directory, one entry
+ * per file path. An entry is only used when the path, modification time, size and content hash
+ * of the file all match and the entry itself is intact. Otherwise the file is parsed as with
+ * TreeDataFromFile and the entry is rewritten. Entries are written to a temporary file first and
+ * renamed into place, so processes sharing a cache directory never read a partial entry.
+ * Temporary files left behind by a writer that was killed before the rename are removed when a
+ * cache is opened on the directory, once they are more than an hour old.
+ *
+ * A TreeDataFileCache can be used from multiple threads concurrently.
+ */
+class TreeDataFileCache
+{
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param cache_directory Directory for the cache entries. It is created when missing.
+   *
+   * @throw InvalidOperationException when the directory could not be created.
+   */
+  explicit TreeDataFileCache(const std::string& cache_directory);
+  ~TreeDataFileCache();
+
+  TreeDataFileCache(const TreeDataFileCache&) = delete;
+  TreeDataFileCache& operator=(const TreeDataFileCache&) = delete;
+
+  /**
+   * @brief Parse a file into TreeData, using the cache entry when it is valid.
+   *
+   * @param filename Name of the XML file.
+   * @param mode Parse mode used when the file needs to be parsed.
+   *
+   * @throw ParseException when the file could not be read or parsed.
+   */
+  std::unique_ptr<TreeData> TreeDataFromFile(const std::string& filename,
+                                             ParseMode mode = ParseMode::kDocument);
+
+  /**
+   * @brief Retrieve the counters accumulated since construction or the last reset.
+   */
+  TreeDataFileCacheStatistics GetStatistics() const;
+
+  void ResetStatistics();
+
+private:
+  struct TreeDataFileCacheImpl;
+  std::unique_ptr<TreeDataFileCacheImpl> p_impl;
+};
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_FILE_CACHE_H_
@@ -23,46 +23,435 @@
 #include "tree_data_parser.h"
 
 #include <sup/xml/exceptions.h>
+#include <sup/xml/mapped_file.h>
 #include <sup/xml/tree_data_parser_utils.h>
+#include <sup/xml/tree_data_reader_utils.h>
 #include <sup/xml/xml_utils.h>
 
+#include <libxml/parser.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+using sup::xml::TreeData;
+
+xmlDocPtr ReadXMLDocFromFile(const std::string& filename, const std::string& caller);
+
+xmlDocPtr ReadXMLDocFromString(const std::string& xml_str, const std::string& caller);
+
+xmlDocPtr ReadXMLDocFromMemory(const char* data, std::size_t size, const char* url,
+                               const std::string& caller, const std::string& source);
+
+xmlTextReaderPtr OpenXMLReaderForFile(const std::string& filename, const std::string& caller);
+
+std::unique_ptr<TreeData> StreamTreeDataFromFile(const std::string& filename);
+
+std::unique_ptr<TreeData> StreamTreeDataFromString(const std::string& xml_str);
+
+std::unique_ptr<TreeData> TreeDataFromRegion(const char* data, std::size_t size,
+                                             const char* url, sup::xml::ParseMode mode,
+                                             const std::string& caller, const std::string& source);
+
+void ParseFilesWorker(const std::vector<std::string>& filenames, std::atomic<std::size_t>& next,
+                      std::vector<sup::xml::TreeDataFileResult>& results);
+
+/**
+ * @brief Worker threads that are joined on destruction, also during stack unwinding. The first
+ * exception that escaped a worker is kept to be rethrown by the owner.
+ */
+class WorkerThreads
+{
+public:
+  WorkerThreads();
+  ~WorkerThreads();
+
+  WorkerThreads(const WorkerThreads&) = delete;
+  WorkerThreads& operator=(const WorkerThreads&) = delete;
+
+  //! Start a thread that runs the given function.
+  void Start(std::function<void()> func);
+
+  //! Join all threads and rethrow the first exception of a worker, if any.
+  void JoinAll();
+
+private:
+  void Join() noexcept;
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::exception_ptr m_exception;
+};
+
+bool IsCompressed(const char* data, std::size_t size);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace xml
 {
 
-std::unique_ptr<TreeData> TreeDataFromFile(const std::string& filename)
+std::unique_ptr<TreeData> TreeDataFromFile(const std::string& filename, ParseMode mode,
+                                           FileAccess access)
+{
+  if (access == FileAccess::kMemoryMapped)
+  {
+    const MappedFile mapped_file{filename};
+    // Compressed files are left to the decompressing file input of libxml2
+    if (!IsCompressed(mapped_file.Data(), mapped_file.Size()))
+    {
+      // Passing the filename as URL keeps relative references resolved against its location
+      return TreeDataFromRegion(mapped_file.Data(), mapped_file.Size(), filename.c_str(), mode,
+                                "sup::xml::TreeDataFromFile()", "file " + filename);
+    }
+  }
+  if (mode == ParseMode::kStreaming)
+  {
+    return StreamTreeDataFromFile(filename);
+  }
+  return ParseXMLDoc(ReadXMLDocFromFile(filename, "sup::xml::TreeDataFromFile()"));
+}
+
+std::unique_ptr<TreeData> TreeDataFromString(const std::string& xml_str, ParseMode mode)
+{
+  if (mode == ParseMode::kStreaming)
+  {
+    return StreamTreeDataFromString(xml_str);
+  }
+  return ParseXMLDoc(ReadXMLDocFromString(xml_str, "sup::xml::TreeDataFromString()"));
+}
+
+std::vector<TreeDataFileResult> TreeDataFromFiles(const std::vector<std::string>& filenames,
+                                                  unsigned threads)
+{
+  // Global initialization of libxml2 is not thread-safe and needs to happen before any worker
+  // starts parsing
+  xmlInitParser();
+  std::vector<TreeDataFileResult> results(filenames.size());
+  if (threads == 0)
+  {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  const auto n_workers = std::min<std::size_t>(threads, filenames.size());
+  std::atomic<std::size_t> next{0};
+  // Declared after everything the workers refer to, so it joins them before those are destroyed
+  WorkerThreads workers;
+  auto work = [&filenames, &next, &results]() { ParseFilesWorker(filenames, next, results); };
+  for (std::size_t i = 1; i < n_workers; ++i)
+  {
+    workers.Start(work);
+  }
+  work();
+  workers.JoinAll();
+  return results;
+}
+
+struct TreeDataParser::TreeDataParserImpl
+{
+  xmlParserCtxtPtr m_ctxt;
+
+  TreeDataParserImpl();
+  ~TreeDataParserImpl();
+
+  TreeDataParserImpl(const TreeDataParserImpl&) = delete;
+  TreeDataParserImpl& operator=(const TreeDataParserImpl&) = delete;
+
+  //! Recreate the parser context when its dictionary grew too large, e.g. because many distinct
+  //! element names were seen.
+  void LimitDictionarySize();
+};
+
+TreeDataParser::TreeDataParser() : p_impl(std::make_unique<TreeDataParserImpl>()) {}
+
+TreeDataParser::~TreeDataParser() = default;
+
+std::unique_ptr<TreeData> TreeDataParser::Parse(const std::string& xml_str)
+{
+  return Parse(xml_str.data(), xml_str.size());
+}
+
+std::unique_ptr<TreeData> TreeDataParser::Parse(const char* data, std::size_t size)
+{
+  if (data == nullptr || size == 0 || size > static_cast<std::size_t>(INT_MAX))
+  {
+    std::string message = "sup::xml::TreeDataParser::Parse(): used xml library could not parse "
+                          "empty or oversized input";
+    throw ParseException(message);
+  }
+  p_impl->LimitDictionarySize();
+  // xmlCtxtReadMemory resets the context, but keeps its dictionary
+  xmlDocPtr doc = xmlCtxtReadMemory(p_impl->m_ctxt, data, static_cast<int>(size), nullptr, nullptr,
+                                    XML_PARSE_NOBLANKS);
+  if (doc == nullptr)
+  {
+    std::string message = "sup::xml::TreeDataParser::Parse(): used xml library could not parse "
+                          "string [" + std::string(data, std::min<std::size_t>(size, 1024)) + "]";
+    throw ParseException(message);
+  }
+  return ParseXMLDoc(doc);
+}
+
+TreeDataParser::TreeDataParserImpl::TreeDataParserImpl()
+  : m_ctxt{AssertNoNullptr(xmlNewParserCtxt(), ParseException(
+      "sup::xml::TreeDataParser(): could not create parser context"))}
+{}
+
+TreeDataParser::TreeDataParserImpl::~TreeDataParserImpl()
+{
+  xmlFreeParserCtxt(m_ctxt);
+}
+
+void TreeDataParser::TreeDataParserImpl::LimitDictionarySize()
+{
+  const int kMaxDictionaryEntries = 100000;
+  if (xmlDictSize(m_ctxt->dict) <= kMaxDictionaryEntries)
+  {
+    return;
+  }
+  auto new_ctxt = AssertNoNullptr(xmlNewParserCtxt(), ParseException(
+      "sup::xml::TreeDataParser::Parse(): could not create parser context"));
+  xmlFreeParserCtxt(m_ctxt);
+  m_ctxt = new_ctxt;
+}
+
+std::unique_ptr<TreeData> TreeDataFromMemory(const char* data, std::size_t size, ParseMode mode)
+{
+  return TreeDataFromRegion(data, size, nullptr, mode, "sup::xml::TreeDataFromMemory()",
+                            "memory region");
+}
+
+void ParseTreeDataStream(const std::string& filename, uint32 depth,
+                         const std::function<void(TreeData&)>& callback)
+{
+  const XMLTextReaderHandle h_reader{OpenXMLReaderForFile(filename,
+                                                          "sup::xml::ParseTreeDataStream()")};
+  ParseXMLReaderRecords(h_reader.Reader(), depth, callback, "file " + filename);
+}
+
+FlatTreeData FlatTreeDataFromFile(const std::string& filename)
+{
+  return ParseXMLDocToFlatTreeData(
+    ReadXMLDocFromFile(filename, "sup::xml::FlatTreeDataFromFile()"));
+}
+
+FlatTreeData FlatTreeDataFromString(const std::string& xml_str)
+{
+  return ParseXMLDocToFlatTreeData(
+    ReadXMLDocFromString(xml_str, "sup::xml::FlatTreeDataFromString()"));
+}
+
+PmrTreeData PmrTreeDataFromFile(const std::string& filename, std::pmr::memory_resource* resource)
+{
+  return ParseXMLDocToPmrTreeData(
+    ReadXMLDocFromFile(filename, "sup::xml::PmrTreeDataFromFile()"), resource);
+}
+
+PmrTreeData PmrTreeDataFromString(const std::string& xml_str,
+                                  std::pmr::memory_resource* resource)
+{
+  return ParseXMLDocToPmrTreeData(
+    ReadXMLDocFromString(xml_str, "sup::xml::PmrTreeDataFromString()"), resource);
+}
+
+PmrTreeData PmrTreeDataFromMemory(const char* data, std::size_t size,
+                                  std::pmr::memory_resource* resource)
+{
+  return ParseXMLDocToPmrTreeData(
+    ReadXMLDocFromMemory(data, size, nullptr, "sup::xml::PmrTreeDataFromMemory()",
+                         "memory region"), resource);
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+using namespace sup::xml;
+
+xmlDocPtr ReadXMLDocFromFile(const std::string& filename, const std::string& caller)
 {
   // Read file into xmlDocPtr
   if (!FileExists(filename))
   {
-    std::string message = "sup::xml::TreeDataFromFile(): file not found [" + filename + "]";
+    std::string message = caller + ": file not found [" + filename + "]";
     throw ParseException(message);
   }
   xmlDocPtr doc = xmlReadFile(filename.c_str(), nullptr, XML_PARSE_NOBLANKS);
   if (doc == nullptr)
   {
-    std::string message = "sup::xml::TreeDataFromFile(): used xml library could not parse file [" +
-    filename + "]";
+    std::string message = caller + ": used xml library could not parse file [" + filename + "]";
     throw ParseException(message);
   }
-  return ParseXMLDoc(doc);
+  return doc;
 }
 
-std::unique_ptr<TreeData> TreeDataFromString(const std::string& xml_str)
+xmlDocPtr ReadXMLDocFromString(const std::string& xml_str, const std::string& caller)
 {
   // Read the string into xmlDocPtr
   xmlDocPtr doc = xmlReadDoc(FromString(xml_str), nullptr, nullptr, XML_PARSE_NOBLANKS);
   if (doc == nullptr)
   {
     auto xml_head = xml_str.substr(0, 1024);
-    std::string message = "sup::xml::TreeDataFromString(): used xml library could not parse string "
-    "[" + xml_head + "]";
+    std::string message = caller + ": used xml library could not parse string [" + xml_head + "]";
     throw ParseException(message);
   }
-  return ParseXMLDoc(doc);
+  return doc;
 }
 
-}  // namespace xml
+xmlDocPtr ReadXMLDocFromMemory(const char* data, std::size_t size, const char* url,
+                               const std::string& caller, const std::string& source)
+{
+  // libxml2 takes the buffer size as int
+  if (data == nullptr || size == 0 || size > static_cast<std::size_t>(INT_MAX))
+  {
+    std::string message = caller + ": used xml library could not parse " + source;
+    throw ParseException(message);
+  }
+  xmlDocPtr doc = xmlReadMemory(data, static_cast<int>(size), url, nullptr, XML_PARSE_NOBLANKS);
+  if (doc == nullptr)
+  {
+    std::string message = caller + ": used xml library could not parse " + source;
+    throw ParseException(message);
+  }
+  return doc;
+}
 
-}  // namespace sup
+xmlTextReaderPtr OpenXMLReaderForFile(const std::string& filename, const std::string& caller)
+{
+  if (!FileExists(filename))
+  {
+    std::string message = caller + ": file not found [" + filename + "]";
+    throw ParseException(message);
+  }
+  const std::string message =
+    caller + ": could not create an XML reader for file [" + filename + "]";
+  return AssertNoNullptr(xmlReaderForFile(filename.c_str(), nullptr, XML_PARSE_NOBLANKS),
+                         ParseException(message));
+}
+
+std::unique_ptr<TreeData> StreamTreeDataFromFile(const std::string& filename)
+{
+  const XMLTextReaderHandle h_reader{OpenXMLReaderForFile(filename,
+                                                          "sup::xml::TreeDataFromFile()")};
+  return ParseXMLReader(h_reader.Reader(), "file " + filename);
+}
+
+std::unique_ptr<TreeData> StreamTreeDataFromString(const std::string& xml_str)
+{
+  const XMLTextReaderHandle h_reader{
+    xmlReaderForDoc(FromString(xml_str), nullptr, nullptr, XML_PARSE_NOBLANKS)};
+  const std::string message = "sup::xml::TreeDataFromString(): could not create an XML reader";
+  auto reader = AssertNoNullptr(h_reader.Reader(), ParseException(message));
+  return ParseXMLReader(reader, "string " + xml_str.substr(0, 1024));
+}
+
+std::unique_ptr<TreeData> TreeDataFromRegion(const char* data, std::size_t size,
+                                             const char* url, sup::xml::ParseMode mode,
+                                             const std::string& caller, const std::string& source)
+{
+  if (mode == ParseMode::kStreaming)
+  {
+    // libxml2 takes the buffer size as int
+    if (data == nullptr || size == 0 || size > static_cast<std::size_t>(INT_MAX))
+    {
+      std::string message = caller + ": used xml library could not parse " + source;
+      throw ParseException(message);
+    }
+    const XMLTextReaderHandle h_reader{
+      xmlReaderForMemory(data, static_cast<int>(size), url, nullptr, XML_PARSE_NOBLANKS)};
+    const std::string message = caller + ": could not create an XML reader for " + source;
+    auto reader = AssertNoNullptr(h_reader.Reader(), ParseException(message));
+    return ParseXMLReader(reader, source);
+  }
+  return ParseXMLDoc(ReadXMLDocFromMemory(data, size, url, caller, source));
+}
+
+void ParseFilesWorker(const std::vector<std::string>& filenames, std::atomic<std::size_t>& next,
+                      std::vector<TreeDataFileResult>& results)
+{
+  // Each index is claimed by exactly one worker, so results can be written without locking
+  for (auto idx = next++; idx < filenames.size(); idx = next++)
+  {
+    try
+    {
+      results[idx].tree_data = TreeDataFromFile(filenames[idx]);
+    }
+    catch (const std::exception& e)
+    {
+      results[idx].error_message = e.what();
+    }
+    catch (...)
+    {
+      results[idx].error_message = "unknown exception";
+    }
+  }
+}
+
+WorkerThreads::WorkerThreads()
+  : m_threads{}
+  , m_mutex{}
+  , m_exception{}
+{}
+
+WorkerThreads::~WorkerThreads()
+{
+  Join();
+}
+
+void WorkerThreads::Start(std::function<void()> func)
+{
+  m_threads.emplace_back(
+    [this, func = std::move(func)]()
+    {
+      try
+      {
+        func();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lk{m_mutex};
+        if (!m_exception)
+        {
+          m_exception = std::current_exception();
+        }
+      }
+    });
+}
+
+void WorkerThreads::JoinAll()
+{
+  Join();
+  if (m_exception)
+  {
+    std::rethrow_exception(m_exception);
+  }
+}
+
+void WorkerThreads::Join() noexcept
+{
+  for (auto& thread : m_threads)
+  {
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+}
+
+bool IsCompressed(const char* data, std::size_t size)
+{
+  // Magic numbers of gzip and xz, the formats libxml2 can decompress
+  const std::string gzip_magic{"\x1f\x8b"};
+  const std::string xz_magic{"\xfd" "7zXZ", 5};
+  const std::string_view header{data, size};
+  return header.substr(0, gzip_magic.size()) == gzip_magic ||
+         header.substr(0, xz_magic.size()) == xz_magic;
+}
+}  // unnamed namespace
@@ -23,17 +23,176 @@
 #ifndef SUP_XML_TREEDATA_PARSER_H_
 #define SUP_XML_TREEDATA_PARSER_H_
 
+#include <sup/xml/base_types.h>
+#include <sup/xml/flat_tree_data.h>
+#include <sup/xml/pmr_tree_data.h>
 #include <sup/xml/tree_data.h>
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 namespace sup
 {
 namespace xml
 {
-std::unique_ptr<TreeData> TreeDataFromFile(const std::string& filename);
+/**
+ * @brief Selects how XML input is turned into TreeData. Both modes produce identical trees.
+ */
+enum class ParseMode
+{
+  kDocument,   //!< Build a complete libxml2 document first and convert it afterwards.
+  kStreaming   //!< Build TreeData directly while reading; nodes are discarded once processed.
+};
+
+/**
+ * @brief Selects how the contents of a file are handed to the XML library.
+ */
+enum class FileAccess
+{
+  kBuffered,     //!< Let the XML library read the file through buffered I/O.
+  kMemoryMapped  //!< Map the file into memory and parse the mapped region in place.
+};
+
+/**
+ * @brief Parse a file into TreeData.
+ *
+ * @details Files compressed with gzip or xz are decompressed transparently. With
+ * FileAccess::kMemoryMapped the file is opened exactly once and no intermediate copies of its
+ * contents are made, except for compressed files, which are read through the decompressing input
+ * of the XML library. The file must not be modified while it is parsed.
+ *
+ * @note Element and attribute names are stored as InternedString. Interned names are never
+ * released, but the table holding them is limited to InternedString::kMaxInternedBytes. Names
+ * parsed after that are stored with the trees that use them, so parsing an open-ended set of
+ * names, e.g. from untrusted input, does not make a process grow without bound. This applies to
+ * all functions of this header.
+ *
+ * @throw ParseException when the file could not be read or parsed.
+ */
+std::unique_ptr<TreeData> TreeDataFromFile(const std::string& filename,
+                                           ParseMode mode = ParseMode::kDocument,
+                                           FileAccess access = FileAccess::kBuffered);
+
+std::unique_ptr<TreeData> TreeDataFromString(const std::string& xml_str,
+                                             ParseMode mode = ParseMode::kDocument);
+
+/**
+ * @brief Outcome of parsing a single file with TreeDataFromFiles.
+ */
+struct TreeDataFileResult
+{
+  std::unique_ptr<TreeData> tree_data{};  //!< Parsed tree or nullptr when parsing failed.
+  std::string error_message{};            //!< Reason of the failure or empty on success.
+};
+
+/**
+ * @brief Parse a list of files concurrently.
+ *
+ * @details Files are distributed over a pool of worker threads, which includes the calling
+ * thread. A failure to parse one file does not affect the others. The workers share the table of
+ * interned names, but names already seen by a thread are found without locking it.
+ *
+ * @param filenames Names of the XML files.
+ * @param threads Maximum number of threads to use. Zero selects the number of hardware threads.
+ *
+ * @return One result per file, in the same order as the input.
+ */
+std::vector<TreeDataFileResult> TreeDataFromFiles(const std::vector<std::string>& filenames,
+                                                  unsigned threads = 0);
+
+/**
+ * @brief Parse XML from a region of memory, e.g. a file that was already mapped by the caller.
+ *
+ * @param data Start of the region. It does not need to be null-terminated.
+ * @param size Size of the region in bytes.
+ * @param mode Parse mode.
+ *
+ * @throw ParseException when the region could not be parsed.
+ */
+std::unique_ptr<TreeData> TreeDataFromMemory(const char* data, std::size_t size,
+                                             ParseMode mode = ParseMode::kDocument);
+
+/**
+ * @brief Parser for repeatedly converting (small) XML strings into TreeData.
+ *
+ * @details The parser keeps its libxml2 parser context and name dictionary alive between calls,
+ * so the setup and teardown cost of TreeDataFromString is only paid once. Results are identical
+ * to those of TreeDataFromString in document mode. A TreeDataParser is not thread-safe: use one
+ * instance per thread.
+ */
+class TreeDataParser
+{
+public:
+  TreeDataParser();
+  ~TreeDataParser();
+
+  TreeDataParser(const TreeDataParser&) = delete;
+  TreeDataParser& operator=(const TreeDataParser&) = delete;
+
+  /**
+   * @brief Parse an XML string.
+   *
+   * @throw ParseException when the string could not be parsed.
+   */
+  std::unique_ptr<TreeData> Parse(const std::string& xml_str);
+
+  /**
+   * @brief Parse XML from a region of memory that does not need to be null-terminated.
+   *
+   * @throw ParseException when the region could not be parsed.
+   */
+  std::unique_ptr<TreeData> Parse(const char* data, std::size_t size);
+
+private:
+  struct TreeDataParserImpl;
+  std::unique_ptr<TreeDataParserImpl> p_impl;
+};
+
+/**
+ * @brief Parse a file one record at a time.
+ *
+ * @details Each element at the given depth (the root element has depth zero) is parsed into a
+ * TreeData, passed to the callback and released before the next one is read. Elements above that
+ * depth are not materialized. Memory use is therefore bounded by the largest record, apart from
+ * the limited table of interned names. The attribute and content rules are the same as for TreeDataFromFile.
+ *
+ * @param filename Name of the XML file.
+ * @param depth Depth of the elements to pass to the callback.
+ * @param callback Function called for each record. It may move from the passed TreeData.
+ *
+ * @throw ParseException when the file could not be read or parsed. Records preceding the error
+ * may already have been passed to the callback.
+ */
+void ParseTreeDataStream(const std::string& filename, uint32 depth,
+                         const std::function<void(TreeData&)>& callback);
+
+FlatTreeData FlatTreeDataFromFile(const std::string& filename);
+
+FlatTreeData FlatTreeDataFromString(const std::string& xml_str);
+
+/**
+ * @brief Parse a file into a PmrTreeData whose nodes are allocated from the given resource.
+ *
+ * @details Parsing is done in document mode. Only the resulting tree uses the resource; the
+ * temporary document of the XML library is allocated and freed as usual.
+ *
+ * @throw ParseException when the file could not be read or parsed.
+ */
+PmrTreeData PmrTreeDataFromFile(
+  const std::string& filename,
+  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+PmrTreeData PmrTreeDataFromString(
+  const std::string& xml_str,
+  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-std::unique_ptr<TreeData> TreeDataFromString(const std::string& xml_str);
+PmrTreeData PmrTreeDataFromMemory(
+  const char* data, std::size_t size,
+  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 }  // namespace xml
 
@@ -30,18 +30,72 @@
 
 #include <fstream>
 #include <stack>
+#include <utility>
 
 namespace
 {
 using namespace sup::xml;
 
-struct StackNode
+/**
+ * @brief Adapters that let one traversal build each of the tree representations. A Node
+ * identifies an element under construction and stays valid while its descendants are added.
+ */
+class TreeDataBuilder
+{
+public:
+  using Node = TreeData*;
+
+  Node AddChild(Node parent, std::string_view name);
+  void ReserveAttributes(Node node, std::size_t n_attributes);
+  void AddAttribute(Node node, std::string_view name, std::string_view value);
+  void SetContent(Node node, std::string_view content);
+};
+
+class FlatTreeDataBuilder
 {
-  TreeData tree;
-  xmlNodePtr xml_node;
-  uint32 next_child_index;
+public:
+  using Node = FlatTreeData::NodeIndex;
+
+  explicit FlatTreeDataBuilder(FlatTreeData& tree);
+
+  Node AddChild(Node parent, std::string_view name);
+  void ReserveAttributes(Node node, std::size_t n_attributes);
+  void AddAttribute(Node node, std::string_view name, std::string_view value);
+  void SetContent(Node node, std::string_view content);
+
+private:
+  FlatTreeData& m_tree;
 };
 
+class PmrTreeDataBuilder
+{
+public:
+  using Node = PmrTreeData*;
+
+  Node AddChild(Node parent, std::string_view name);
+  void ReserveAttributes(Node node, std::size_t n_attributes);
+  void AddAttribute(Node node, std::string_view name, std::string_view value);
+  void SetContent(Node node, std::string_view content);
+};
+
+/**
+ * @brief Add the attributes, content and all descendant elements of the given libxml2 node to
+ * the (already created) root node of the builder.
+ */
+template <typename Builder>
+void BuildTree(Builder& builder, typename Builder::Node root, xmlDocPtr doc, xmlNodePtr node);
+
+template <typename Builder>
+void AddAttributes(Builder& builder, typename Builder::Node target, const xmlNodePtr node);
+
+template <typename Builder>
+void AddContent(Builder& builder, typename Builder::Node target, xmlDocPtr doc,
+                const xmlNodePtr node);
+
+xmlNodePtr GetRootElement(xmlDocPtr doc, const char* caller);
+
+void ReserveFlatTreeData(FlatTreeData& tree, const xmlNodePtr root);
+
 }  // unnamed namespace
 
 namespace sup
@@ -56,90 +110,215 @@ bool FileExists(const std::string& filename)
 
 std::unique_ptr<TreeData> ParseXMLDoc(xmlDocPtr doc)
 {
-  // Check root element
-  xmlNodePtr root_node = xmlDocGetRootElement(doc);
-  if (root_node == nullptr)
+  // The document is also freed when the conversion throws
+  const XMLDocPointer doc_owner{doc};
+  return ParseDataTree(doc, GetRootElement(doc, "sup::xml::ParseXMLDoc()"));
+}
+
+std::unique_ptr<TreeData> ParseDataTree(xmlDocPtr doc, xmlNodePtr node)
+{
+  auto result = std::make_unique<TreeData>(InternedString{ToStringView(node->name)});
+  TreeDataBuilder builder;
+  BuildTree(builder, result.get(), doc, node);
+  return result;
+}
+
+TreeData CreateTreeData(xmlDocPtr doc, xmlNodePtr node)
+{
+  auto result = TreeData{InternedString{ToStringView(node->name)}};
+  AddXMLAttributes(result, node);
+  AddXMLContent(result, doc, node);
+  return result;
+}
+
+xmlNodePtr NextElement(xmlNodePtr node)
+{
+  while (node != nullptr && node->type != XML_ELEMENT_NODE)
   {
-    xmlFreeDoc(doc);
-    std::string message = "sup::xml::ParseXMLDoc(): could not retrieve root element";
-    throw ParseException(message);
+    node = node->next;
   }
-  auto data_tree = ParseDataTree(doc, root_node);
-  xmlFreeDoc(doc);
-  return data_tree;
+  return node;
 }
 
-std::unique_ptr<TreeData> ParseDataTree(xmlDocPtr doc, xmlNodePtr node)
+void AddXMLAttributes(TreeData& tree, const xmlNodePtr node)
+{
+  TreeDataBuilder builder;
+  AddAttributes(builder, &tree, node);
+}
+
+void AddXMLContent(TreeData& tree, xmlDocPtr doc, const xmlNodePtr node)
+{
+  TreeDataBuilder builder;
+  AddContent(builder, &tree, doc, node);
+}
+
+FlatTreeData ParseXMLDocToFlatTreeData(xmlDocPtr doc)
+{
+  const XMLDocPointer doc_owner{doc};
+  auto root_node = GetRootElement(doc, "sup::xml::ParseXMLDocToFlatTreeData()");
+  FlatTreeData result{ToStringView(root_node->name)};
+  ReserveFlatTreeData(result, root_node);
+  FlatTreeDataBuilder builder{result};
+  BuildTree(builder, result.Root(), doc, root_node);
+  return result;
+}
+
+PmrTreeData ParseXMLDocToPmrTreeData(xmlDocPtr doc, std::pmr::memory_resource* resource)
+{
+  // The resource may run out of memory, which also leaves the document to the guard
+  const XMLDocPointer doc_owner{doc};
+  auto root_node = GetRootElement(doc, "sup::xml::ParseXMLDocToPmrTreeData()");
+  PmrTreeData result{InternedString{ToStringView(root_node->name)},
+                     PmrTreeData::allocator_type{resource}};
+  PmrTreeDataBuilder builder;
+  BuildTree(builder, &result, doc, root_node);
+  return result;
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
 {
-  std::stack<StackNode> stack;
-  stack.push({CreateTreeData(doc, node), node, 0});
+TreeDataBuilder::Node TreeDataBuilder::AddChild(Node parent, std::string_view name)
+{
+  return &parent->EmplaceChild(InternedString{name});
+}
+
+void TreeDataBuilder::ReserveAttributes(Node node, std::size_t n_attributes)
+{
+  node->ReserveAttributes(n_attributes);
+}
+
+void TreeDataBuilder::AddAttribute(Node node, std::string_view name, std::string_view value)
+{
+  node->AddAttribute(InternedString{name}, std::string{value});
+}
+
+void TreeDataBuilder::SetContent(Node node, std::string_view content)
+{
+  node->SetContent(std::string{content});
+}
+
+FlatTreeDataBuilder::FlatTreeDataBuilder(FlatTreeData& tree)
+  : m_tree{tree}
+{}
+
+FlatTreeDataBuilder::Node FlatTreeDataBuilder::AddChild(Node parent, std::string_view name)
+{
+  return m_tree.AddChild(parent, name);
+}
+
+void FlatTreeDataBuilder::ReserveAttributes(Node, std::size_t)
+{
+  // The attribute table of the whole tree is reserved up front by ReserveFlatTreeData
+}
+
+void FlatTreeDataBuilder::AddAttribute(Node node, std::string_view name, std::string_view value)
+{
+  m_tree.AddAttribute(node, name, value);
+}
+
+void FlatTreeDataBuilder::SetContent(Node node, std::string_view content)
+{
+  m_tree.SetContent(node, content);
+}
+
+PmrTreeDataBuilder::Node PmrTreeDataBuilder::AddChild(Node parent, std::string_view name)
+{
+  return &parent->EmplaceChild(InternedString{name});
+}
+
+void PmrTreeDataBuilder::ReserveAttributes(Node node, std::size_t n_attributes)
+{
+  node->ReserveAttributes(n_attributes);
+}
+
+void PmrTreeDataBuilder::AddAttribute(Node node, std::string_view name, std::string_view value)
+{
+  node->AddAttribute(InternedString{name}, value);
+}
+
+void PmrTreeDataBuilder::SetContent(Node node, std::string_view content)
+{
+  node->SetContent(content);
+}
+
+/**
+ * @brief Element under construction, with a cursor to the next sibling in the libxml2 child list
+ * that still needs to be visited.
+ */
+template <typename Node>
+struct StackNode
+{
+  Node tree;
+  xmlNodePtr next_child;
+};
+
+template <typename Builder>
+void BuildTree(Builder& builder, typename Builder::Node root, xmlDocPtr doc, xmlNodePtr node)
+{
+  // Children are constructed in place inside their parent. The nodes on the stack remain valid
+  // since a parent only gets a new child after the previous one was fully processed and popped.
+  AddAttributes(builder, root, node);
+  AddContent(builder, root, doc, node);
+  std::stack<StackNode<typename Builder::Node>> stack;
+  stack.push({root, node->children});
 
   while (!stack.empty())  // process each node
   {
     auto& top_node = stack.top();
-    auto next_child = NextChild(top_node.xml_node, top_node.next_child_index);
+    auto next_child = NextElement(top_node.next_child);
     if (next_child != nullptr)
     {
-      stack.push({CreateTreeData(doc, next_child), next_child, 0});
+      top_node.next_child = next_child->next;
+      auto child = builder.AddChild(top_node.tree, ToStringView(next_child->name));
+      AddAttributes(builder, child, next_child);
+      AddContent(builder, child, doc, next_child);
+      stack.push({child, next_child->children});
     }
     else
     {
-      auto current_tree = top_node.tree;  // Creates a copy
       stack.pop();
-      if (!stack.empty())
-      {
-        auto& parent = stack.top();
-        parent.tree.AddChild(current_tree);
-      }
-      else
-      {
-        return std::make_unique<TreeData>(current_tree);
-      }
     }
   }
-  return nullptr;
 }
 
-TreeData CreateTreeData(xmlDocPtr doc, xmlNodePtr node)
+template <typename Builder>
+void AddAttributes(Builder& builder, typename Builder::Node target, const xmlNodePtr node)
 {
-  auto result = TreeData{ToString(node->name)};
-  AddXMLAttributes(result, node);
-  AddXMLContent(result, doc, node);
-  return result;
-}
-
-xmlNodePtr NextChild(xmlNodePtr parent, uint32& next_child_idx)
-{
-  auto child = parent->children;
-  uint32 child_idx = 0;
-  while (child != nullptr)
+  // Sizing the attribute list exactly saves the reallocations of growing it one by one
+  std::size_t n_attributes = 0;
+  for (auto attribute = node->properties; attribute != nullptr; attribute = attribute->next)
   {
-    if ((child_idx >= next_child_idx) && (child->type == XML_ELEMENT_NODE))
-    {
-      next_child_idx = ++child_idx;
-      return child;
-    }
-    child = child->next;
-    ++child_idx;
+    ++n_attributes;
+  }
+  if (n_attributes > 1)
+  {
+    builder.ReserveAttributes(target, n_attributes);
   }
-  return nullptr;
-}
-
-void AddXMLAttributes(TreeData& tree, const xmlNodePtr node)
-{
   auto attribute = node->properties;
   while (attribute != nullptr)
   {
-    auto name = ToString(attribute->name);
     auto xml_val = xmlGetProp(node, attribute->name);
-    auto value = ToString(xml_val);
+    try
+    {
+      builder.AddAttribute(target, ToStringView(attribute->name), ToStringView(xml_val));
+    }
+    catch (...)
+    {
+      xmlFree(xml_val);
+      throw;
+    }
     xmlFree(xml_val);
-    tree.AddAttribute(name, value);
     attribute = attribute->next;
   }
 }
 
-void AddXMLContent(TreeData& tree, xmlDocPtr doc, const xmlNodePtr node)
+template <typename Builder>
+void AddContent(Builder& builder, typename Builder::Node target, xmlDocPtr doc,
+                const xmlNodePtr node)
 {
   auto child_node = node->children;
   while (child_node != nullptr)
@@ -147,9 +326,16 @@ void AddXMLContent(TreeData& tree, xmlDocPtr doc, const xmlNodePtr node)
     if (child_node->type == XML_TEXT_NODE)
     {
       auto xml_content = xmlNodeListGetString(doc, child_node, 1);
-      auto content = ToString(xml_content);
+      try
+      {
+        builder.SetContent(target, ToStringView(xml_content));
+      }
+      catch (...)
+      {
+        xmlFree(xml_content);
+        throw;
+      }
       xmlFree(xml_content);
-      tree.SetContent(content);
     }
     else
     {
@@ -159,6 +345,57 @@ void AddXMLContent(TreeData& tree, xmlDocPtr doc, const xmlNodePtr node)
   }
 }
 
-}  // namespace xml
+xmlNodePtr GetRootElement(xmlDocPtr doc, const char* caller)
+{
+  xmlNodePtr root_node = xmlDocGetRootElement(doc);
+  if (root_node == nullptr)
+  {
+    std::string message = std::string{caller} + ": could not retrieve root element";
+    throw ParseException(message);
+  }
+  return root_node;
+}
 
-}  // namespace sup
+void ReserveFlatTreeData(FlatTreeData& tree, const xmlNodePtr root)
+{
+  // Pre-pass over the document to size the node/attribute tables and the character arena.
+  std::size_t n_nodes = 0;
+  std::size_t n_attributes = 0;
+  std::size_t n_chars = 0;
+  xmlNodePtr current = root;
+  while (current != nullptr)
+  {
+    if (current->type == XML_ELEMENT_NODE)
+    {
+      ++n_nodes;
+      n_chars += xmlStrlen(current->name);
+      for (auto attribute = current->properties; attribute != nullptr;
+           attribute = attribute->next)
+      {
+        ++n_attributes;
+        n_chars += xmlStrlen(attribute->name);
+        if (attribute->children != nullptr)
+        {
+          n_chars += xmlStrlen(attribute->children->content);
+        }
+      }
+    }
+    else if (current->type == XML_TEXT_NODE)
+    {
+      n_chars += xmlStrlen(current->content);
+    }
+    // Pre-order traversal of the libxml2 tree
+    if (current->type == XML_ELEMENT_NODE && current->children != nullptr)
+    {
+      current = current->children;
+      continue;
+    }
+    while (current != root && current->next == nullptr)
+    {
+      current = current->parent;
+    }
+    current = (current == root) ? nullptr : current->next;
+  }
+  tree.Reserve(n_nodes, n_attributes, n_chars);
+}
+}  // unnamed namespace
@@ -24,11 +24,14 @@
 #define SUP_XML_TREEDATA_PARSER_UTILS_H_
 
 #include <sup/xml/base_types.h>
+#include <sup/xml/flat_tree_data.h>
+#include <sup/xml/pmr_tree_data.h>
 #include <sup/xml/tree_data.h>
 
 #include <libxml/tree.h>
 
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace sup
@@ -38,18 +41,26 @@ namespace xml
 
 bool FileExists(const std::string& filename);
 
+//! Convert a document to TreeData. Takes ownership of the document and frees it, also on failure.
 std::unique_ptr<TreeData> ParseXMLDoc(xmlDocPtr doc);
 
 std::unique_ptr<TreeData> ParseDataTree(xmlDocPtr doc, const xmlNodePtr node);
 
 TreeData CreateTreeData(xmlDocPtr doc, xmlNodePtr node);
 
-xmlNodePtr NextChild(xmlNodePtr parent, uint32& next_child_idx);
+//! First element node in the sibling list starting at (and including) the given node.
+xmlNodePtr NextElement(xmlNodePtr node);
 
 void AddXMLAttributes(TreeData& tree, const xmlNodePtr node);
 
 void AddXMLContent(TreeData& tree, xmlDocPtr doc, const xmlNodePtr node);
 
+//! Convert a document to FlatTreeData, taking ownership of the document as ParseXMLDoc does.
+FlatTreeData ParseXMLDocToFlatTreeData(xmlDocPtr doc);
+
+//! Convert a document to PmrTreeData, taking ownership of the document as ParseXMLDoc does.
+PmrTreeData ParseXMLDocToPmrTreeData(xmlDocPtr doc, std::pmr::memory_resource* resource);
+
 }  // namespace xml
 
 }  // namespace sup
@@ -0,0 +1,522 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_query.h"
+
+#include <sup/xml/exceptions.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace
+{
+const std::size_t kMaxSteps = 64;
+
+/**
+ * @brief Cursor over a query expression with helpers for its tokens.
+ */
+class ExpressionReader
+{
+public:
+  explicit ExpressionReader(const std::string& expression);
+
+  bool AtEnd() const;
+
+  //! Consume the given character when it is next.
+  bool Accept(char c);
+
+  //! Consume the given character or fail.
+  void Expect(char c);
+
+  //! Read a tag or attribute name, or '*' when allowed.
+  std::string ReadName(bool allow_wildcard);
+
+  //! Read a literal between single or double quotes.
+  std::string ReadLiteral();
+
+  void SkipSpaces();
+
+  [[noreturn]] void Fail(const std::string& reason) const;
+
+private:
+  const std::string& m_expression;
+  std::size_t m_pos;
+};
+
+/**
+ * @brief Traversal stack that keeps its first frames inline, so evaluation on trees of moderate
+ * depth does not allocate.
+ */
+template <typename Frame>
+class EvaluationStack
+{
+public:
+  EvaluationStack() : m_inline{}, m_overflow{}, m_size{0} {}
+
+  bool Empty() const { return m_size == 0; }
+
+  Frame& Back() { return m_size <= kInlineFrames ? m_inline[m_size - 1] : m_overflow.back(); }
+
+  void Push(const Frame& frame)
+  {
+    if (m_size < kInlineFrames)
+    {
+      m_inline[m_size] = frame;
+    }
+    else
+    {
+      m_overflow.push_back(frame);
+    }
+    ++m_size;
+  }
+
+  void Pop()
+  {
+    if (m_size > kInlineFrames)
+    {
+      m_overflow.pop_back();
+    }
+    --m_size;
+  }
+
+private:
+  static const std::size_t kInlineFrames = 64;
+  std::array<Frame, kInlineFrames> m_inline;
+  std::vector<Frame> m_overflow;
+  std::size_t m_size;
+};
+
+/**
+ * @brief Open node during evaluation, with the set of steps that are candidates for its children.
+ */
+struct QueryFrame
+{
+  const sup::xml::TreeData* tree;
+  std::size_t next_child;
+  std::uint64_t child_candidates;
+};
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+TreeDataTagIndex::TreeDataTagIndex(const TreeData& tree)
+  : m_root{&tree}
+  , m_nodes{}
+{
+  std::vector<std::pair<const TreeData*, std::size_t>> stack{{&tree, 0}};
+  m_nodes[tree.GetInternedNodeName()].push_back(&tree);
+  while (!stack.empty())
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.first->Children();
+    if (top_node.second < children.size())
+    {
+      const auto& child = children[top_node.second++];
+      m_nodes[child.GetInternedNodeName()].push_back(&child);
+      stack.emplace_back(&child, 0);
+    }
+    else
+    {
+      stack.pop_back();
+    }
+  }
+}
+
+TreeDataTagIndex::~TreeDataTagIndex() = default;
+
+TreeDataTagIndex::TreeDataTagIndex(TreeDataTagIndex&& other) noexcept = default;
+TreeDataTagIndex& TreeDataTagIndex::operator=(TreeDataTagIndex&& other) & noexcept = default;
+
+const TreeData& TreeDataTagIndex::Root() const
+{
+  return *m_root;
+}
+
+const std::vector<const TreeData*>& TreeDataTagIndex::Find(const InternedString& tag) const
+{
+  static const std::vector<const TreeData*> empty_list{};
+  auto it = m_nodes.find(tag);
+  return it == m_nodes.end() ? empty_list : it->second;
+}
+
+TreeDataQuery::TreeDataQuery(const std::string& expression)
+  : m_expression{expression}
+  , m_absolute{false}
+  , m_steps{}
+{
+  ExpressionReader reader{m_expression};
+  reader.SkipSpaces();
+  if (reader.AtEnd())
+  {
+    reader.Fail("empty expression");
+  }
+  bool descendant = false;
+  if (reader.Accept('/'))
+  {
+    m_absolute = true;
+    descendant = reader.Accept('/');
+  }
+  while (true)
+  {
+    if (m_steps.size() == kMaxSteps)
+    {
+      reader.Fail("more than " + std::to_string(kMaxSteps) + " steps");
+    }
+    const auto tag = reader.ReadName(true);
+    Step step{descendant, tag == "*", InternedString{tag == "*" ? "" : tag}, {}};
+    reader.SkipSpaces();
+    while (reader.Accept('['))
+    {
+      reader.SkipSpaces();
+      reader.Expect('@');
+      AttributePredicate predicate{InternedString{reader.ReadName(false)}, {}, false};
+      reader.SkipSpaces();
+      if (reader.Accept('='))
+      {
+        reader.SkipSpaces();
+        predicate.value = reader.ReadLiteral();
+        predicate.check_value = true;
+        reader.SkipSpaces();
+      }
+      reader.Expect(']');
+      reader.SkipSpaces();
+      step.predicates.push_back(std::move(predicate));
+    }
+    m_steps.push_back(std::move(step));
+    if (reader.AtEnd())
+    {
+      break;
+    }
+    reader.Expect('/');
+    descendant = reader.Accept('/');
+  }
+}
+
+TreeDataQuery::~TreeDataQuery() = default;
+
+TreeDataQuery::TreeDataQuery(const TreeDataQuery& other) = default;
+TreeDataQuery::TreeDataQuery(TreeDataQuery&& other) noexcept = default;
+TreeDataQuery& TreeDataQuery::operator=(const TreeDataQuery& other) & = default;
+TreeDataQuery& TreeDataQuery::operator=(TreeDataQuery&& other) & noexcept = default;
+
+const std::string& TreeDataQuery::GetExpression() const
+{
+  return m_expression;
+}
+
+bool TreeDataQuery::ForEach(const TreeData& tree,
+                            const std::function<bool(const TreeData&)>& func) const
+{
+  return Evaluate(tree, func);
+}
+
+const TreeData* TreeDataQuery::FindFirst(const TreeData& tree) const
+{
+  const TreeData* result = nullptr;
+  (void)Evaluate(tree, [&result](const TreeData& node)
+                 {
+                   result = &node;
+                   return false;
+                 });
+  return result;
+}
+
+std::vector<const TreeData*> TreeDataQuery::FindAll(const TreeData& tree) const
+{
+  std::vector<const TreeData*> result;
+  (void)Evaluate(tree, [&result](const TreeData& node)
+                 {
+                   result.push_back(&node);
+                   return true;
+                 });
+  return result;
+}
+
+std::size_t TreeDataQuery::Count(const TreeData& tree) const
+{
+  std::size_t result = 0;
+  (void)Evaluate(tree, [&result](const TreeData&)
+                 {
+                   ++result;
+                   return true;
+                 });
+  return result;
+}
+
+bool TreeDataQuery::ForEach(const TreeDataTagIndex& index,
+                            const std::function<bool(const TreeData&)>& func) const
+{
+  return Evaluate(index, func);
+}
+
+const TreeData* TreeDataQuery::FindFirst(const TreeDataTagIndex& index) const
+{
+  const TreeData* result = nullptr;
+  (void)Evaluate(index, [&result](const TreeData& node)
+                 {
+                   result = &node;
+                   return false;
+                 });
+  return result;
+}
+
+std::vector<const TreeData*> TreeDataQuery::FindAll(const TreeDataTagIndex& index) const
+{
+  std::vector<const TreeData*> result;
+  (void)Evaluate(index, [&result](const TreeData& node)
+                 {
+                   result.push_back(&node);
+                   return true;
+                 });
+  return result;
+}
+
+std::size_t TreeDataQuery::Count(const TreeDataTagIndex& index) const
+{
+  if (UsesTagIndex() && m_steps[0].predicates.empty())
+  {
+    return index.Find(m_steps[0].tag).size();
+  }
+  std::size_t result = 0;
+  (void)Evaluate(index, [&result](const TreeData&)
+                 {
+                   ++result;
+                   return true;
+                 });
+  return result;
+}
+
+bool TreeDataQuery::UsesTagIndex() const
+{
+  // The index holds all nodes with a tag in document order, which is exactly the result of an
+  // absolute query with a single step on the descendant axis.
+  return m_absolute && m_steps.size() == 1 && m_steps[0].descendant && !m_steps[0].any_tag;
+}
+
+bool TreeDataQuery::MatchStep(const Step& step, const TreeData& node)
+{
+  if (!step.any_tag && node.GetInternedNodeName() != step.tag)
+  {
+    return false;
+  }
+  for (const auto& predicate : step.predicates)
+  {
+    const std::string* value = nullptr;
+    for (const auto& attr : node.Attributes())
+    {
+      if (attr.first == predicate.name)
+      {
+        value = &attr.second;
+        break;
+      }
+    }
+    if (value == nullptr || (predicate.check_value && *value != predicate.value))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F>
+bool TreeDataQuery::Evaluate(const TreeData& tree, F&& func) const
+{
+  // Bit i of a candidate set means that step i is tested on the node: steps 0..i-1 matched its
+  // ancestors. A node matching step i makes step i+1 a candidate for its children and steps on
+  // the descendant axis stay candidates for the whole subtree.
+  const auto n_steps = m_steps.size();
+  const std::uint64_t last_step = std::uint64_t{1} << (n_steps - 1);
+  std::uint64_t descendant_steps = 0;
+  for (std::size_t i = 0; i < n_steps; ++i)
+  {
+    descendant_steps |= m_steps[i].descendant ? (std::uint64_t{1} << i) : 0;
+  }
+  // Reports the node when it matches the last step and computes the candidates for its children.
+  // Returns false when the evaluation needs to stop.
+  auto visit = [&](const TreeData& node, std::uint64_t candidates, std::uint64_t& child_candidates)
+  {
+    std::uint64_t matched = 0;
+    for (std::size_t i = 0; i < n_steps; ++i)
+    {
+      const std::uint64_t bit = std::uint64_t{1} << i;
+      if ((candidates & bit) != 0 && MatchStep(m_steps[i], node))
+      {
+        matched |= bit;
+      }
+    }
+    if ((matched & last_step) != 0 && !func(node))
+    {
+      return false;
+    }
+    child_candidates = ((matched & ~last_step) << 1) | (candidates & descendant_steps);
+    return true;
+  };
+  EvaluationStack<QueryFrame> stack;
+  if (m_absolute)
+  {
+    std::uint64_t child_candidates = 0;
+    if (!visit(tree, 1, child_candidates))
+    {
+      return false;
+    }
+    if (child_candidates != 0)
+    {
+      stack.Push({&tree, 0, child_candidates});
+    }
+  }
+  else
+  {
+    stack.Push({&tree, 0, 1});
+  }
+  while (!stack.Empty())
+  {
+    auto& top_node = stack.Back();
+    const auto& children = top_node.tree->Children();
+    if (top_node.next_child == children.size())
+    {
+      stack.Pop();
+      continue;
+    }
+    const auto& child = children[top_node.next_child++];
+    std::uint64_t child_candidates = 0;
+    if (!visit(child, top_node.child_candidates, child_candidates))
+    {
+      return false;
+    }
+    if (child_candidates != 0 && child.GetNumberOfChildren() > 0)
+    {
+      stack.Push({&child, 0, child_candidates});
+    }
+  }
+  return true;
+}
+
+template <typename F>
+bool TreeDataQuery::Evaluate(const TreeDataTagIndex& index, F&& func) const
+{
+  if (!UsesTagIndex())
+  {
+    return Evaluate(index.Root(), std::forward<F>(func));
+  }
+  for (const auto node : index.Find(m_steps[0].tag))
+  {
+    if (MatchStep(m_steps[0], *node) && !func(*node))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+ExpressionReader::ExpressionReader(const std::string& expression)
+  : m_expression{expression}
+  , m_pos{0}
+{}
+
+bool ExpressionReader::AtEnd() const
+{
+  return m_pos == m_expression.size();
+}
+
+bool ExpressionReader::Accept(char c)
+{
+  if (!AtEnd() && m_expression[m_pos] == c)
+  {
+    ++m_pos;
+    return true;
+  }
+  return false;
+}
+
+void ExpressionReader::Expect(char c)
+{
+  if (!Accept(c))
+  {
+    Fail(std::string("expected '") + c + "'");
+  }
+}
+
+std::string ExpressionReader::ReadName(bool allow_wildcard)
+{
+  if (allow_wildcard && Accept('*'))
+  {
+    return "*";
+  }
+  auto is_name_char = [](char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '.' || c == ':' || (static_cast<unsigned char>(c) >= 0x80);
+  };
+  const auto start = m_pos;
+  while (!AtEnd() && is_name_char(m_expression[m_pos]))
+  {
+    ++m_pos;
+  }
+  if (m_pos == start)
+  {
+    Fail("expected a name");
+  }
+  return m_expression.substr(start, m_pos - start);
+}
+
+std::string ExpressionReader::ReadLiteral()
+{
+  if (AtEnd() || (m_expression[m_pos] != '\'' && m_expression[m_pos] != '"'))
+  {
+    Fail("expected a quoted value");
+  }
+  const char quote = m_expression[m_pos++];
+  const auto end = m_expression.find(quote, m_pos);
+  if (end == std::string::npos)
+  {
+    Fail("unterminated quoted value");
+  }
+  auto result = m_expression.substr(m_pos, end - m_pos);
+  m_pos = end + 1;
+  return result;
+}
+
+void ExpressionReader::SkipSpaces()
+{
+  while (!AtEnd() && m_expression[m_pos] == ' ')
+  {
+    ++m_pos;
+  }
+}
+
+void ExpressionReader::Fail(const std::string& reason) const
+{
+  std::string message = "sup::xml::TreeDataQuery(): " + reason + " at position " +
+    std::to_string(m_pos) + " in expression [" + m_expression + "]";
+  throw sup::xml::ParseException(message);
+}
+}  // unnamed namespace
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_QUERY_H_
+#define SUP_XML_TREE_DATA_QUERY_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Index from tag name to all nodes of a tree with that tag, in document order.
+ *
+ * @details The index refers to the nodes of the tree, so it is invalidated by any modification
+ * of the tree.
+ */
+class TreeDataTagIndex
+{
+public:
+  explicit TreeDataTagIndex(const TreeData& tree);
+  ~TreeDataTagIndex();
+
+  TreeDataTagIndex(TreeDataTagIndex&& other) noexcept;
+  TreeDataTagIndex& operator=(TreeDataTagIndex&& other) & noexcept;
+
+  TreeDataTagIndex(const TreeDataTagIndex&) = delete;
+  TreeDataTagIndex& operator=(const TreeDataTagIndex&) = delete;
+
+  /**
+   * @brief Retrieve the root node of the indexed tree.
+   */
+  const TreeData& Root() const;
+
+  /**
+   * @brief Retrieve all nodes with the given tag, in document order.
+   */
+  const std::vector<const TreeData*>& Find(const InternedString& tag) const;
+
+private:
+  const TreeData* m_root;
+  std::unordered_map<InternedString, std::vector<const TreeData*>> m_nodes;
+};
+
+/**
+ * @brief Compiled path query over TreeData, supporting a subset of XPath.
+ *
+ * @details Supported syntax:
+ * - `/Root/Child`: absolute path, where the first step must match the root node itself;
+ * - `Child/Sub`: relative path, starting at the children of the node the query is applied to;
+ * - `//Tag`, `Parent//Tag`: descendants at any depth (`//Tag` also matches the root node);
+ * - `*`: any tag;
+ * - `Tag[@name]`, `Tag[@name='x']` or `Tag[@name="x"]`: attribute presence or value. Multiple
+ *   predicates can follow each other and all need to match.
+ *
+ * Queries are compiled once. Evaluation visits the tree once, in document order, and skips
+ * subtrees that cannot contain a match. Results are returned in document order. Evaluation
+ * does not allocate for trees of up to 64 levels deep, except for the result vector of FindAll.
+ * A compiled query can be used concurrently from multiple threads.
+ */
+class TreeDataQuery
+{
+public:
+  /**
+   * @brief Compile a query expression.
+   *
+   * @throw ParseException when the expression is not valid or has more than 64 steps.
+   */
+  explicit TreeDataQuery(const std::string& expression);
+  ~TreeDataQuery();
+
+  TreeDataQuery(const TreeDataQuery& other);
+  TreeDataQuery(TreeDataQuery&& other) noexcept;
+  TreeDataQuery& operator=(const TreeDataQuery& other) &;
+  TreeDataQuery& operator=(TreeDataQuery&& other) & noexcept;
+
+  /**
+   * @brief Retrieve the query expression.
+   */
+  const std::string& GetExpression() const;
+
+  /**
+   * @brief Call a function for each matching node, until it returns false.
+   *
+   * @return false when the function stopped the evaluation.
+   */
+  bool ForEach(const TreeData& tree, const std::function<bool(const TreeData&)>& func) const;
+
+  /**
+   * @brief Find the first matching node in document order.
+   *
+   * @return Pointer to the node or nullptr when there is no match.
+   */
+  const TreeData* FindFirst(const TreeData& tree) const;
+
+  /**
+   * @brief Find all matching nodes in document order.
+   */
+  std::vector<const TreeData*> FindAll(const TreeData& tree) const;
+
+  /**
+   * @brief Count the matching nodes.
+   */
+  std::size_t Count(const TreeData& tree) const;
+
+  /**
+   * @brief Overloads evaluating the query on the tree of a tag index.
+   *
+   * @details Queries of the form `//Tag` with optional attribute predicates are answered from the
+   * index, without visiting the rest of the tree. Other queries are evaluated on the indexed
+   * tree as usual.
+   */
+  bool ForEach(const TreeDataTagIndex& index,
+               const std::function<bool(const TreeData&)>& func) const;
+  const TreeData* FindFirst(const TreeDataTagIndex& index) const;
+  std::vector<const TreeData*> FindAll(const TreeDataTagIndex& index) const;
+  std::size_t Count(const TreeDataTagIndex& index) const;
+
+private:
+  struct AttributePredicate
+  {
+    InternedString name;
+    std::string value;
+    bool check_value;
+  };
+  struct Step
+  {
+    bool descendant;
+    bool any_tag;
+    InternedString tag;
+    std::vector<AttributePredicate> predicates;
+  };
+
+  //! Indicate if the query can be answered from a tag index.
+  bool UsesTagIndex() const;
+
+  //! Check the node test and predicates of a step.
+  static bool MatchStep(const Step& step, const TreeData& node);
+
+  //! Evaluate on a tree until the function returns false.
+  template <typename F>
+  bool Evaluate(const TreeData& tree, F&& func) const;
+
+  //! Evaluate using the index when possible.
+  template <typename F>
+  bool Evaluate(const TreeDataTagIndex& index, F&& func) const;
+
+  std::string m_expression;
+  bool m_absolute;
+  std::vector<Step> m_steps;
+};
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_QUERY_H_
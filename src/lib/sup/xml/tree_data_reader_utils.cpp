@@ -0,0 +1,208 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_reader_utils.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/tree_data_parser_utils.h>
+#include <sup/xml/xml_utils.h>
+
+#include <libxml/entities.h>
+
+#include <stack>
+#include <utility>
+
+namespace
+{
+using namespace sup::xml;
+
+/**
+ * @brief Element under construction. Mirrors AddXMLContent: the content is the concatenated text
+ * of the last text node and all text, CDATA and entity reference siblings following it.
+ */
+struct ReaderStackNode
+{
+  TreeData* tree;
+  std::string content;
+  bool has_text;
+};
+
+void FinishElement(std::stack<ReaderStackNode>& stack, std::unique_ptr<TreeData>& record,
+                   const std::function<void(TreeData&)>& callback);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace xml
+{
+
+XMLTextReaderHandle::XMLTextReaderHandle(xmlTextReaderPtr reader)
+  : m_reader{reader}
+{}
+
+XMLTextReaderHandle::~XMLTextReaderHandle()
+{
+  if (m_reader)
+  {
+    xmlFreeTextReader(m_reader);
+  }
+}
+
+xmlTextReaderPtr XMLTextReaderHandle::Reader() const &
+{
+  return m_reader;
+}
+
+std::unique_ptr<TreeData> ParseXMLReader(xmlTextReaderPtr reader, const std::string& source)
+{
+  std::unique_ptr<TreeData> result;
+  auto store_root = [&result](TreeData& root)
+  {
+    result = std::make_unique<TreeData>(std::move(root));
+  };
+  ParseXMLReaderRecords(reader, 0, store_root, source);
+  if (!result)
+  {
+    std::string message = "sup::xml::ParseXMLReader(): could not retrieve root element";
+    throw ParseException(message);
+  }
+  return result;
+}
+
+void ParseXMLReaderRecords(xmlTextReaderPtr reader, uint32 depth,
+                           const std::function<void(TreeData&)>& callback,
+                           const std::string& source)
+{
+  std::unique_ptr<TreeData> record;
+  std::stack<ReaderStackNode> stack;
+  int32 rc = 0;
+  while ((rc = xmlTextReaderRead(reader)) == 1)
+  {
+    const auto node_type = xmlTextReaderNodeType(reader);
+    if (stack.empty() && node_type == XML_READER_TYPE_ELEMENT &&
+        static_cast<uint32>(xmlTextReaderDepth(reader)) != depth)
+    {
+      // Elements outside of a record are not materialized
+      continue;
+    }
+    switch (node_type)
+    {
+    case XML_READER_TYPE_ELEMENT:
+    {
+      auto node = xmlTextReaderCurrentNode(reader);
+      const InternedString name{ToStringView(node->name)};
+      TreeData* tree = nullptr;
+      if (stack.empty())
+      {
+        record = std::make_unique<TreeData>(name);
+        tree = record.get();
+      }
+      else
+      {
+        tree = &stack.top().tree->EmplaceChild(name);
+      }
+      AddXMLAttributes(*tree, node);
+      stack.push({tree, {}, false});
+      if (xmlTextReaderIsEmptyElement(reader) == 1)
+      {
+        FinishElement(stack, record, callback);
+      }
+      break;
+    }
+    case XML_READER_TYPE_END_ELEMENT:
+      if (!stack.empty())
+      {
+        FinishElement(stack, record, callback);
+      }
+      break;
+    case XML_READER_TYPE_TEXT:
+    case XML_READER_TYPE_WHITESPACE:
+    case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:
+      if (!stack.empty())
+      {
+        auto& top_node = stack.top();
+        top_node.content = GetXMLReaderText(reader);
+        top_node.has_text = true;
+      }
+      break;
+    case XML_READER_TYPE_CDATA:
+    case XML_READER_TYPE_ENTITY_REFERENCE:
+      if (!stack.empty() && stack.top().has_text)
+      {
+        stack.top().content += GetXMLReaderText(reader);
+      }
+      break;
+    default:
+      // All other node types are ignored in this process
+      break;
+    }
+  }
+  if (rc < 0 || !stack.empty())
+  {
+    std::string message = "sup::xml::ParseXMLReaderRecords(): used xml library could not parse [" +
+      source + "]";
+    throw ParseException(message);
+  }
+}
+
+std::string GetXMLReaderText(xmlTextReaderPtr reader)
+{
+  // xmlTextReaderCurrentDoc is avoided on purpose: it makes xmlFreeTextReader keep the document
+  auto node = xmlTextReaderCurrentNode(reader);
+  if (node->type == XML_ENTITY_REF_NODE)
+  {
+    auto entity = xmlGetDocEntity(node->doc, node->name);
+    if (entity == nullptr)
+    {
+      return ToString(node->content);
+    }
+    auto xml_content = xmlNodeListGetString(node->doc, entity->children, 1);
+    auto content = ToString(xml_content);
+    xmlFree(xml_content);
+    return content;
+  }
+  return std::string{ToStringView(xmlTextReaderConstValue(reader))};
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+void FinishElement(std::stack<ReaderStackNode>& stack, std::unique_ptr<TreeData>& record,
+                   const std::function<void(TreeData&)>& callback)
+{
+  auto& top_node = stack.top();
+  if (top_node.has_text)
+  {
+    top_node.tree->SetContent(std::move(top_node.content));
+  }
+  stack.pop();
+  if (stack.empty())
+  {
+    // The record is complete: hand it over and release it
+    callback(*record);
+    record.reset();
+  }
+}
+}  // unnamed namespace
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_READER_UTILS_H_
+#define SUP_XML_TREE_DATA_READER_UTILS_H_
+
+#include <sup/xml/base_types.h>
+#include <sup/xml/tree_data.h>
+
+#include <libxml/xmlreader.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace sup
+{
+namespace xml
+{
+class XMLTextReaderHandle
+{
+public:
+  explicit XMLTextReaderHandle(xmlTextReaderPtr reader);
+  ~XMLTextReaderHandle();
+
+  XMLTextReaderHandle(const XMLTextReaderHandle&) = delete;
+  XMLTextReaderHandle& operator=(const XMLTextReaderHandle&) = delete;
+
+  xmlTextReaderPtr Reader() const &;
+private:
+  xmlTextReaderPtr m_reader;
+};
+
+//! Build TreeData directly from the nodes reported by the reader, without keeping the document.
+std::unique_ptr<TreeData> ParseXMLReader(xmlTextReaderPtr reader, const std::string& source);
+
+//! Build one TreeData for each element at the given depth (root is zero) and pass it to the
+//! callback, after which it is released.
+void ParseXMLReaderRecords(xmlTextReaderPtr reader, uint32 depth,
+                           const std::function<void(TreeData&)>& callback,
+                           const std::string& source);
+
+//! Text content of the current text, CDATA or entity reference node of the reader.
+std::string GetXMLReaderText(xmlTextReaderPtr reader);
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_READER_UTILS_H_
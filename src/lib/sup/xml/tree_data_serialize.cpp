@@ -30,21 +30,84 @@
 #include <libxml/encoding.h>
 #include <libxml/xmlwriter.h>
 
+namespace
+{
+template <typename T>
+void SerializeToFile(const std::string& file_name, const T& tree_data,
+                     const sup::xml::SerializeOptions& options);
+
+template <typename T>
+std::string SerializeToString(const T& tree_data, const sup::xml::SerializeOptions& options);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace xml
 {
-void TreeDataToFile(const std::string& file_name, const TreeData& tree_data)
+void TreeDataToFile(const std::string& file_name, const TreeData& tree_data,
+                    const SerializeOptions& options)
+{
+  SerializeToFile(file_name, tree_data, options);
+}
+
+std::string TreeDataToString(const TreeData& tree_data, const SerializeOptions& options)
+{
+  std::string result;
+  result.reserve(EstimateSerializedSize(tree_data, options));
+  WriterOutput output{result};
+  WriteTreeData(output, tree_data, options);
+  return result;
+}
+
+void TreeDataToSink(SerializeSink& sink, const TreeData& tree_data,
+                    const SerializeOptions& options, std::size_t buffer_size)
+{
+  std::string buffer;
+  WriterOutput output{buffer, sink, buffer_size};
+  WriteTreeData(output, tree_data, options);
+  output.Flush();
+}
+
+void TreeDataToFile(const std::string& file_name, const FlatTreeData& tree_data,
+                    const SerializeOptions& options)
+{
+  SerializeToFile(file_name, tree_data, options);
+}
+
+std::string TreeDataToString(const FlatTreeData& tree_data, const SerializeOptions& options)
+{
+  return SerializeToString(tree_data, options);
+}
+
+}  // namespace xml
+
+}  // namespace sup
+
+namespace
+{
+using namespace sup::xml;
+
+template <typename T>
+void SerializeToFile(const std::string& file_name, const T& tree_data,
+                     const SerializeOptions& options)
 {
-    // Create a new XmlWriter for uri, with no compression.
-    const XMLTextWriterHandle h_writer(xmlNewTextWriterFilename(file_name.c_str(), 0));
+    if (options.compression < 0 || options.compression > 9)
+    {
+      std::string message = "sup::xml::TreeDataToFile(): compression level must be between 0 and "
+                            "9, got " + std::to_string(options.compression);
+      throw SerializeException(message);
+    }
+    // Create a new XmlWriter for uri, with the requested gzip compression.
+    const XMLTextWriterHandle h_writer(
+      xmlNewTextWriterFilename(file_name.c_str(), options.compression));
     const std::string message =
         "sup::xml::TreeDataToFile(): could not create an XML writer for file [" + file_name;
     auto writer = AssertNoNullptr(h_writer.Writer(), SerializeException(message));
-    SerializeUsingWriter(writer, tree_data);
+    SerializeUsingWriter(writer, tree_data, options);
 }
 
-std::string TreeDataToString(const TreeData& tree_data)
+template <typename T>
+std::string SerializeToString(const T& tree_data, const SerializeOptions& options)
 {
     // Create a new XML buffer, to which the XML document will be written
     const XMLBufferHandle h_buffer{};
@@ -55,10 +118,7 @@ std::string TreeDataToString(const TreeData& tree_data)
     const XMLTextWriterHandle h_writer(xmlNewTextWriterMemory(buf, 0));
     const std::string writer_message = "sup::xml::TreeDataToString(): could not create an XML writer";
     auto writer = AssertNoNullptr(h_writer.Writer(), SerializeException(writer_message));
-    SerializeUsingWriter(writer, tree_data);
+    SerializeUsingWriter(writer, tree_data, options);
     return ToString(xmlBufferContent(buf));
 }
-
-}  // namespace xml
-
-}  // namespace sup
+}  // unnamed namespace
@@ -23,17 +23,63 @@
 #ifndef SUP_XML_TREE_DATA_SERIALIZE_H_
 #define SUP_XML_TREE_DATA_SERIALIZE_H_
 
+#include <sup/xml/flat_tree_data.h>
+#include <sup/xml/serialize_sink.h>
 #include <sup/xml/tree_data.h>
 
+#include <cstddef>
 #include <string>
 
 namespace sup
 {
 namespace xml
 {
-void TreeDataToFile(const std::string& file_name, const TreeData& tree_data);
+/**
+ * @brief Options controlling the layout and compression of serialized XML.
+ */
+struct SerializeOptions
+{
+  //! Write all elements on a single line, without indentation.
+  bool compact = false;
+
+  //! String written once per nesting level in front of an element, unless compact.
+  std::string indent = "  ";
+
+  //! Gzip compression level from 0 (uncompressed) to 9. Only used when writing to files, which
+  //! TreeDataFromFile transparently decompresses.
+  int compression = 0;
+};
+
+void TreeDataToFile(const std::string& file_name, const TreeData& tree_data,
+                    const SerializeOptions& options = SerializeOptions{});
+
+std::string TreeDataToString(const TreeData& tree_data,
+                             const SerializeOptions& options = SerializeOptions{});
+
+/**
+ * @brief Serialize TreeData in chunks to a sink.
+ *
+ * @details The output is identical to that of TreeDataToString. It is collected in a buffer of
+ * the given size, which is passed on to the sink whenever it is full. Extra memory use is thus
+ * bounded by the buffer size and the depth of the tree, independent of the size of the output.
+ *
+ * @param sink Destination of the output.
+ * @param tree_data TreeData to serialize.
+ * @param options Layout options. Compression is not applied.
+ * @param buffer_size Size of the intermediate buffer in bytes.
+ *
+ * @throw SerializeException when the TreeData cannot be serialized or the sink fails. Part of the
+ * output may already have been written to the sink.
+ */
+void TreeDataToSink(SerializeSink& sink, const TreeData& tree_data,
+                    const SerializeOptions& options = SerializeOptions{},
+                    std::size_t buffer_size = 8192);
+
+void TreeDataToFile(const std::string& file_name, const FlatTreeData& tree_data,
+                    const SerializeOptions& options = SerializeOptions{});
 
-std::string TreeDataToString(const TreeData& tree_data);
+std::string TreeDataToString(const FlatTreeData& tree_data,
+                             const SerializeOptions& options = SerializeOptions{});
 
 }  // namespace xml
 
@@ -23,9 +23,55 @@
 #include "tree_data_serialize_utils.h"
 
 #include <sup/xml/exceptions.h>
+#include <sup/xml/tree_data_traversal.h>
 #include <sup/xml/xml_utils.h>
 #include "base_types.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stack>
+#include <vector>
+
+namespace
+{
+using sup::xml::TreeData;
+
+const std::string kXMLDeclaration = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+
+/**
+ * @brief Element opened by WriteTreeData. While the start tag is still open (no '>' written yet),
+ * the element can be closed as an empty element.
+ */
+struct WriterStackNode
+{
+  const TreeData* tree;
+  std::size_t next_child;
+  bool start_tag_open;
+};
+
+using EscapeTable = std::array<const char*, 256>;
+
+using sup::xml::SerializeOptions;
+using sup::xml::WriterOutput;
+
+EscapeTable CreateEscapeTable(bool attribute);
+
+void AppendEscaped(WriterOutput& output, std::string_view text, const EscapeTable& table);
+
+void AppendIndent(WriterOutput& output, std::size_t depth, const SerializeOptions& options);
+
+void AppendLineEnd(WriterOutput& output, const SerializeOptions& options);
+
+std::string_view UpToNullCharacter(std::string_view text);
+
+bool StartWriterElement(WriterOutput& output, const TreeData& tree_data, std::size_t depth,
+                        const SerializeOptions& options, bool& do_indent);
+
+void EndWriterElement(WriterOutput& output, const WriterStackNode& node, std::size_t depth,
+                      const SerializeOptions& options, bool& do_indent);
+}  // unnamed namespace
+
 namespace sup
 {
 namespace xml
@@ -65,9 +111,10 @@ xmlTextWriterPtr XMLTextWriterHandle::Writer() const &
   return m_writer;
 }
 
-void SerializeUsingWriter(xmlTextWriterPtr writer, const TreeData& tree_data)
+void SerializeUsingWriter(xmlTextWriterPtr writer, const TreeData& tree_data,
+                          const SerializeOptions& options)
 {
-  SetupWriterIndentation(writer);
+  SetupWriterIndentation(writer, options);
   (void)xmlTextWriterStartDocument(writer, nullptr, "UTF-8", nullptr);
 
   AddTreeData(writer, tree_data);
@@ -75,72 +122,408 @@ void SerializeUsingWriter(xmlTextWriterPtr writer, const TreeData& tree_data)
   (void)xmlTextWriterEndDocument(writer);
 }
 
-void SetupWriterIndentation(xmlTextWriterPtr writer)
+void SerializeUsingWriter(xmlTextWriterPtr writer, const FlatTreeData& tree_data,
+                          const SerializeOptions& options)
+{
+  SetupWriterIndentation(writer, options);
+  (void)xmlTextWriterStartDocument(writer, nullptr, "UTF-8", nullptr);
+
+  AddFlatTreeData(writer, tree_data);
+
+  (void)xmlTextWriterEndDocument(writer);
+}
+
+void SetupWriterIndentation(xmlTextWriterPtr writer, const SerializeOptions& options)
 {
-  const int32 indentation_on = 1;
+  const int32 indentation_on = options.compact ? 0 : 1;
   (void)xmlTextWriterSetIndent(writer, indentation_on);
-  (void)xmlTextWriterSetIndentString(writer, FromString(std::string("  ")));
+  (void)xmlTextWriterSetIndentString(writer, FromString(options.indent));
 }
 
 void AddTreeData(xmlTextWriterPtr writer, const TreeData& tree_data)
 {
-  if (tree_data.GetNodeName().empty())
+  auto start_element = [writer](const TreeData& node, std::size_t)
   {
-    std::string message = "AddTreeData(): TreeData node has no name";
+    if (node.NodeName().empty())
+    {
+      std::string message = "AddTreeData(): TreeData node has no name";
+      throw SerializeException(message);
+    }
+
+    // opening element
+    int32 rc = xmlTextWriterStartElement(writer, FromStringView(node.NodeName()));
+    if (rc < 0)
+    {
+      std::string message = "AddTreeData(): Error at xmlTextWriterStartElement";
+      throw SerializeException(message);
+    }
+
+    // writing attribute
+    AddTreeAttributes(writer, node);
+
+    // writing content
+    if (!node.Content().empty())
+    {
+      rc = xmlTextWriterWriteString(writer, FromStringView(node.Content()));
+      if (rc < 0)
+      {
+        std::string message = "AddTreeData(): Error at xmlTextWriterWriteString";
+        throw SerializeException(message);
+      }
+    }
+    return VisitAction::kContinue;
+  };
+  auto end_element = [writer](const TreeData&, std::size_t)
+  {
+    // closing element
+    int32 rc = xmlTextWriterEndElement(writer);
+    if (rc < 0)
+    {
+      std::string message = "AddTreeData(): Error at xmlTextWriterEndElement";
+      throw SerializeException(message);
+    }
+    return VisitAction::kContinue;
+  };
+  // children are written between the start and end of their parent element
+  (void)Visit(tree_data, start_element, end_element);
+}
+
+void AddTreeAttributes(xmlTextWriterPtr writer, const TreeData& tree_data)
+{
+  for (const auto& attr : tree_data.Attributes())
+  {
+    int32 rc = xmlTextWriterWriteAttribute(writer, FromString(attr.first), FromString(attr.second));
+    if (rc < 0)
+    {
+      std::string message = "AddTreeAttributes(): Error at xmlTextWriterWriteAttribute";
+      throw SerializeException(message);
+    }
+  }
+}
+
+void AddFlatTreeData(xmlTextWriterPtr writer, const FlatTreeData& tree_data)
+{
+  // Each stack entry holds the next child to write for an opened element.
+  std::stack<FlatTreeData::NodeIndex> stack;
+  StartFlatTreeElement(writer, tree_data, tree_data.Root());
+  stack.push(tree_data.FirstChild(tree_data.Root()));
+  while (!stack.empty())
+  {
+    const auto child = stack.top();
+    if (child != FlatTreeData::kInvalidNode)
+    {
+      stack.top() = tree_data.NextSibling(child);
+      StartFlatTreeElement(writer, tree_data, child);
+      stack.push(tree_data.FirstChild(child));
+    }
+    else
+    {
+      EndTreeElement(writer);
+      stack.pop();
+    }
+  }
+}
+
+void StartFlatTreeElement(xmlTextWriterPtr writer, const FlatTreeData& tree_data,
+                          FlatTreeData::NodeIndex node)
+{
+  const std::string node_name{tree_data.GetNodeName(node)};
+  if (node_name.empty())
+  {
+    std::string message = "AddFlatTreeData(): FlatTreeData node has no name";
     throw SerializeException(message);
   }
 
   // opening element
-  int32 rc = xmlTextWriterStartElement(writer, FromString(tree_data.GetNodeName()));
+  int32 rc = xmlTextWriterStartElement(writer, FromString(node_name));
   if (rc < 0)
   {
-    std::string message = "AddTreeData(): Error at xmlTextWriterStartElement";
+    std::string message = "AddFlatTreeData(): Error at xmlTextWriterStartElement";
     throw SerializeException(message);
   }
 
-  // writing attribute
-  AddTreeAttributes(writer, tree_data);
-
-  // writing content
-  if (!tree_data.GetContent().empty())
+  // writing attributes
+  const auto n_attributes = tree_data.GetNumberOfAttributes(node);
+  for (std::size_t idx = 0; idx < n_attributes; ++idx)
   {
-    rc = xmlTextWriterWriteString(writer, FromString(tree_data.GetContent()));
+    const std::string name{tree_data.GetAttributeName(node, idx)};
+    const std::string value{tree_data.GetAttributeValue(node, idx)};
+    rc = xmlTextWriterWriteAttribute(writer, FromString(name), FromString(value));
     if (rc < 0)
     {
-      std::string message = "AddTreeData(): Error at xmlTextWriterWriteString";
+      std::string message = "AddFlatTreeData(): Error at xmlTextWriterWriteAttribute";
       throw SerializeException(message);
     }
   }
 
-  // writing children
-  for (const auto& child : tree_data.Children())
+  // writing content
+  const auto content = tree_data.GetContent(node);
+  if (!content.empty())
   {
-    AddTreeData(writer, child);
+    rc = xmlTextWriterWriteString(writer, FromString(std::string{content}));
+    if (rc < 0)
+    {
+      std::string message = "AddFlatTreeData(): Error at xmlTextWriterWriteString";
+      throw SerializeException(message);
+    }
   }
+}
 
-  // closing element
-  rc = xmlTextWriterEndElement(writer);
+void EndTreeElement(xmlTextWriterPtr writer)
+{
+  int32 rc = xmlTextWriterEndElement(writer);
   if (rc < 0)
   {
-    std::string message = "AddTreeData(): Error at xmlTextWriterEndElement";
+    std::string message = "EndTreeElement(): Error at xmlTextWriterEndElement";
     throw SerializeException(message);
   }
 }
 
-void AddTreeAttributes(xmlTextWriterPtr writer, const TreeData& tree_data)
+WriterOutput::WriterOutput(std::string& buffer)
+  : m_buffer{buffer}
+  , m_sink{nullptr}
+  , m_capacity{std::numeric_limits<std::size_t>::max()}
+{}
+
+WriterOutput::WriterOutput(std::string& buffer, SerializeSink& sink, std::size_t capacity)
+  : m_buffer{buffer}
+  , m_sink{&sink}
+  , m_capacity{std::max<std::size_t>(capacity, 1)}
 {
-  for (const auto& attr : tree_data.Attributes())
+  m_buffer.reserve(m_capacity);
+}
+
+void WriterOutput::Append(std::string_view text)
+{
+  if (m_buffer.size() + text.size() <= m_capacity)
   {
-    int32 rc = xmlTextWriterWriteAttribute(writer, FromString(attr.first), FromString(attr.second));
-    if (rc < 0)
+    (void)m_buffer.append(text);
+    return;
+  }
+  Flush();
+  // Only reachable with a sink: text that does not fit in the buffer is passed on directly
+  if (text.size() >= m_capacity)
+  {
+    m_sink->Write(text.data(), text.size());
+    return;
+  }
+  (void)m_buffer.append(text);
+}
+
+void WriterOutput::Append(char c)
+{
+  if (m_buffer.size() >= m_capacity)
+  {
+    Flush();
+  }
+  m_buffer.push_back(c);
+}
+
+void WriterOutput::Flush()
+{
+  if (m_sink != nullptr && !m_buffer.empty())
+  {
+    m_sink->Write(m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+  }
+}
+
+std::size_t EstimateSerializedSize(const TreeData& tree_data, const SerializeOptions& options)
+{
+  const std::size_t indent_size = options.compact ? 0 : options.indent.size();
+  std::size_t result = kXMLDeclaration.size();
+  std::vector<std::pair<const TreeData*, std::size_t>> stack{{&tree_data, 0}};
+  while (!stack.empty())
+  {
+    const auto node = stack.back();
+    stack.pop_back();
+    const auto& tree = *node.first;
+    // Indentation and line end for start and end tag, '<', '>', '</' and '>'
+    result += 2 * (node.second * indent_size + 1) + 5;
+    result += 2 * tree.NodeName().size() + tree.Content().size();
+    for (const auto& attr : tree.Attributes())
     {
-      std::string message = "AddTreeAttributes(): Error at xmlTextWriterWriteAttribute";
-      throw SerializeException(message);
+      // ' ', '=' and two quotes
+      result += attr.first.size() + attr.second.size() + 4;
+    }
+    for (const auto& child : tree.Children())
+    {
+      stack.emplace_back(&child, node.second + 1);
+    }
+  }
+  return result;
+}
+
+void WriteTreeData(WriterOutput& output, const TreeData& tree_data,
+                   const SerializeOptions& options)
+{
+  // The layout follows the state handling of libxml2's indenting text writer: a child's start tag
+  // is preceded by a newline only when the parent has no content and an end tag is indented
+  // unless it directly follows the element's content. Compact output has neither indentation nor
+  // newlines, apart from the one closing the document.
+  output.Append(kXMLDeclaration);
+  bool do_indent = true;
+  std::vector<WriterStackNode> stack;
+  stack.push_back({&tree_data, 0, StartWriterElement(output, tree_data, 0, options, do_indent)});
+  while (!stack.empty())
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.tree->Children();
+    if (top_node.next_child < children.size())
+    {
+      const auto& child = children[top_node.next_child++];
+      if (top_node.start_tag_open)
+      {
+        output.Append('>');
+        AppendLineEnd(output, options);
+        top_node.start_tag_open = false;
+      }
+      const auto depth = stack.size();
+      stack.push_back({&child, 0, StartWriterElement(output, child, depth, options, do_indent)});
     }
+    else
+    {
+      EndWriterElement(output, top_node, stack.size() - 1, options, do_indent);
+      stack.pop_back();
+    }
+  }
+  if (options.compact)
+  {
+    output.Append('\n');
   }
 }
 
+void AppendEscapedContent(WriterOutput& output, std::string_view text)
+{
+  static const EscapeTable table = CreateEscapeTable(false);
+  AppendEscaped(output, text, table);
+}
+
+void AppendEscapedAttribute(WriterOutput& output, std::string_view text)
+{
+  static const EscapeTable table = CreateEscapeTable(true);
+  AppendEscaped(output, text, table);
+}
+
 }  // namespace xml
 
 }  // namespace sup
 
+namespace
+{
+EscapeTable CreateEscapeTable(bool attribute)
+{
+  EscapeTable result{};
+  result['<'] = "&lt;";
+  result['>'] = "&gt;";
+  result['&'] = "&amp;";
+  result['"'] = "&quot;";
+  result['\r'] = "&#13;";
+  if (attribute)
+  {
+    result['\t'] = "&#9;";
+    result['\n'] = "&#10;";
+  }
+  return result;
+}
+
+void AppendEscaped(WriterOutput& output, std::string_view text, const EscapeTable& table)
+{
+  // Copy runs of characters that need no escaping in one go
+  std::size_t run_start = 0;
+  for (std::size_t idx = 0; idx < text.size(); ++idx)
+  {
+    const char* replacement = table[static_cast<unsigned char>(text[idx])];
+    if (replacement != nullptr)
+    {
+      output.Append(text.substr(run_start, idx - run_start));
+      output.Append(replacement);
+      run_start = idx + 1;
+    }
+  }
+  output.Append(text.substr(run_start));
+}
+
+void AppendIndent(WriterOutput& output, std::size_t depth, const SerializeOptions& options)
+{
+  if (options.compact)
+  {
+    return;
+  }
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    output.Append(options.indent);
+  }
+}
+
+void AppendLineEnd(WriterOutput& output, const SerializeOptions& options)
+{
+  if (!options.compact)
+  {
+    output.Append('\n');
+  }
+}
+
+std::string_view UpToNullCharacter(std::string_view text)
+{
+  // libxml2 receives null-terminated strings and stops at the first null character
+  return text.substr(0, text.find('\0'));
+}
+
+bool StartWriterElement(WriterOutput& output, const TreeData& tree_data, std::size_t depth,
+                        const SerializeOptions& options, bool& do_indent)
+{
+  const auto name = UpToNullCharacter(tree_data.NodeName());
+  if (name.empty())
+  {
+    std::string message = "WriteTreeData(): TreeData node has no name";
+    throw sup::xml::SerializeException(message);
+  }
+  AppendIndent(output, depth, options);
+  output.Append('<');
+  output.Append(name);
+  for (const auto& attr : tree_data.Attributes())
+  {
+    const auto attr_name = UpToNullCharacter(attr.first);
+    if (attr_name.empty())
+    {
+      std::string message = "WriteTreeData(): TreeData attribute has no name";
+      throw sup::xml::SerializeException(message);
+    }
+    output.Append(' ');
+    output.Append(attr_name);
+    output.Append("=\"");
+    sup::xml::AppendEscapedAttribute(output, UpToNullCharacter(attr.second));
+    output.Append('"');
+  }
+  if (tree_data.Content().empty())
+  {
+    return true;
+  }
+  output.Append('>');
+  sup::xml::AppendEscapedContent(output, UpToNullCharacter(tree_data.Content()));
+  do_indent = false;
+  return false;
+}
+
+void EndWriterElement(WriterOutput& output, const WriterStackNode& node, std::size_t depth,
+                      const SerializeOptions& options, bool& do_indent)
+{
+  if (node.start_tag_open)
+  {
+    output.Append("/>");
+  }
+  else
+  {
+    if (do_indent)
+    {
+      AppendIndent(output, depth, options);
+    }
+    output.Append("</");
+    output.Append(UpToNullCharacter(node.tree->NodeName()));
+    output.Append('>');
+  }
+  AppendLineEnd(output, options);
+  do_indent = true;
+}
+}  // unnamed namespace
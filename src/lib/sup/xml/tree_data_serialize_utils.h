@@ -23,10 +23,17 @@
 #ifndef SUP_XML_TREE_DATA_SERIALIZE_UTILS_H_
 #define SUP_XML_TREE_DATA_SERIALIZE_UTILS_H_
 
+#include <sup/xml/flat_tree_data.h>
+#include <sup/xml/serialize_sink.h>
+#include <sup/xml/tree_data_serialize.h>
 #include <sup/xml/tree_data.h>
 
 #include <libxml/xmlwriter.h>
 
+#include <cstddef>
+#include <string>
+#include <string_view>
+
 namespace sup
 {
 namespace xml
@@ -60,10 +67,15 @@ private:
 };
 
 //! Serialize the TreeData to the given writer
-void SerializeUsingWriter(xmlTextWriterPtr writer, const sup::xml::TreeData& tree_data);
+void SerializeUsingWriter(xmlTextWriterPtr writer, const sup::xml::TreeData& tree_data,
+                          const SerializeOptions& options = SerializeOptions{});
+
+//! Serialize the FlatTreeData to the given writer
+void SerializeUsingWriter(xmlTextWriterPtr writer, const sup::xml::FlatTreeData& tree_data,
+                          const SerializeOptions& options = SerializeOptions{});
 
 //! Set-up indentation.
-void SetupWriterIndentation(xmlTextWriterPtr writer);
+void SetupWriterIndentation(xmlTextWriterPtr writer, const SerializeOptions& options);
 
 //! Main method for recursive writing of XML from TreeData.
 void AddTreeData(xmlTextWriterPtr writer, const sup::xml::TreeData& tree_data);
@@ -71,6 +83,53 @@ void AddTreeData(xmlTextWriterPtr writer, const sup::xml::TreeData& tree_data);
 //! Adds to currently opened XML element all attributes defined in TreeData.
 void AddTreeAttributes(xmlTextWriterPtr writer, const sup::xml::TreeData& tree_data);
 
+//! Main method for (non-recursive) writing of XML from FlatTreeData.
+void AddFlatTreeData(xmlTextWriterPtr writer, const sup::xml::FlatTreeData& tree_data);
+
+//! Opens an XML element for the given node and writes its attributes and content.
+void StartFlatTreeElement(xmlTextWriterPtr writer, const sup::xml::FlatTreeData& tree_data,
+                          sup::xml::FlatTreeData::NodeIndex node);
+
+//! Closes the currently opened XML element.
+void EndTreeElement(xmlTextWriterPtr writer);
+
+//! Output of the native XML writer. Text is collected in a string, which either grows without
+//! limit or is passed on to a sink in chunks whenever it would exceed its capacity.
+class WriterOutput
+{
+public:
+  explicit WriterOutput(std::string& buffer);
+  WriterOutput(std::string& buffer, SerializeSink& sink, std::size_t capacity);
+
+  WriterOutput(const WriterOutput&) = delete;
+  WriterOutput& operator=(const WriterOutput&) = delete;
+
+  void Append(std::string_view text);
+  void Append(char c);
+
+  //! Pass all buffered text to the sink, if there is one.
+  void Flush();
+private:
+  std::string& m_buffer;
+  SerializeSink* m_sink;
+  std::size_t m_capacity;
+};
+
+//! Estimate of the size of the indented XML document for the TreeData, not counting escapes.
+std::size_t EstimateSerializedSize(const sup::xml::TreeData& tree_data,
+                                   const SerializeOptions& options = SerializeOptions{});
+
+//! Appends the XML document for the TreeData to the output without going through libxml2. The
+//! output is byte-for-byte identical to the one produced by SerializeUsingWriter.
+void WriteTreeData(WriterOutput& output, const sup::xml::TreeData& tree_data,
+                   const SerializeOptions& options = SerializeOptions{});
+
+//! Appends text, escaped in the same way as libxml2 escapes element content.
+void AppendEscapedContent(WriterOutput& output, std::string_view text);
+
+//! Appends text, escaped in the same way as libxml2 escapes attribute values.
+void AppendEscapedAttribute(WriterOutput& output, std::string_view text);
+
 }  // namespace xml
 
 }  // namespace sup
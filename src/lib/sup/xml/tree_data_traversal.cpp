@@ -0,0 +1,271 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_traversal.h"
+
+namespace sup
+{
+namespace xml
+{
+
+TreeDataPreOrderIterator::TreeDataPreOrderIterator()
+  : m_current{nullptr}
+  , m_skip_children{false}
+  , m_stack{}
+{}
+
+TreeDataPreOrderIterator::TreeDataPreOrderIterator(const TreeData& root)
+  : m_current{&root}
+  , m_skip_children{false}
+  , m_stack{}
+{}
+
+TreeDataPreOrderIterator::~TreeDataPreOrderIterator() = default;
+
+TreeDataPreOrderIterator::TreeDataPreOrderIterator(const TreeDataPreOrderIterator& other) = default;
+TreeDataPreOrderIterator::TreeDataPreOrderIterator(TreeDataPreOrderIterator&& other) noexcept = default;
+TreeDataPreOrderIterator& TreeDataPreOrderIterator::operator=(const TreeDataPreOrderIterator& other) & = default;
+TreeDataPreOrderIterator& TreeDataPreOrderIterator::operator=(TreeDataPreOrderIterator&& other) & noexcept = default;
+
+TreeDataPreOrderIterator::reference TreeDataPreOrderIterator::operator*() const
+{
+  return *m_current;
+}
+
+TreeDataPreOrderIterator::pointer TreeDataPreOrderIterator::operator->() const
+{
+  return m_current;
+}
+
+TreeDataPreOrderIterator& TreeDataPreOrderIterator::operator++()
+{
+  const auto& children = m_current->Children();
+  if (!m_skip_children && !children.empty())
+  {
+    m_stack.push_back({m_current, 1});
+    m_current = &children.front();
+    return *this;
+  }
+  m_skip_children = false;
+  while (!m_stack.empty())
+  {
+    auto& top_node = m_stack.back();
+    const auto& siblings = top_node.tree->Children();
+    if (top_node.next_child < siblings.size())
+    {
+      m_current = &siblings[top_node.next_child++];
+      return *this;
+    }
+    m_stack.pop_back();
+  }
+  m_current = nullptr;
+  return *this;
+}
+
+TreeDataPreOrderIterator TreeDataPreOrderIterator::operator++(int)
+{
+  auto result = *this;
+  ++(*this);
+  return result;
+}
+
+std::size_t TreeDataPreOrderIterator::Depth() const
+{
+  return m_stack.size();
+}
+
+void TreeDataPreOrderIterator::SkipChildren()
+{
+  m_skip_children = true;
+}
+
+bool TreeDataPreOrderIterator::operator==(const TreeDataPreOrderIterator& other) const
+{
+  return m_current == other.m_current;
+}
+
+bool TreeDataPreOrderIterator::operator!=(const TreeDataPreOrderIterator& other) const
+{
+  return !(*this == other);
+}
+
+TreeDataPostOrderIterator::TreeDataPostOrderIterator()
+  : m_current{nullptr}
+  , m_stack{}
+{}
+
+TreeDataPostOrderIterator::TreeDataPostOrderIterator(const TreeData& root)
+  : m_current{&root}
+  , m_stack{}
+{
+  DescendToLeaf();
+}
+
+TreeDataPostOrderIterator::~TreeDataPostOrderIterator() = default;
+
+TreeDataPostOrderIterator::TreeDataPostOrderIterator(const TreeDataPostOrderIterator& other) = default;
+TreeDataPostOrderIterator::TreeDataPostOrderIterator(TreeDataPostOrderIterator&& other) noexcept = default;
+TreeDataPostOrderIterator& TreeDataPostOrderIterator::operator=(const TreeDataPostOrderIterator& other) & = default;
+TreeDataPostOrderIterator& TreeDataPostOrderIterator::operator=(TreeDataPostOrderIterator&& other) & noexcept = default;
+
+TreeDataPostOrderIterator::reference TreeDataPostOrderIterator::operator*() const
+{
+  return *m_current;
+}
+
+TreeDataPostOrderIterator::pointer TreeDataPostOrderIterator::operator->() const
+{
+  return m_current;
+}
+
+TreeDataPostOrderIterator& TreeDataPostOrderIterator::operator++()
+{
+  if (m_stack.empty())
+  {
+    m_current = nullptr;
+    return *this;
+  }
+  auto& top_node = m_stack.back();
+  const auto& siblings = top_node.tree->Children();
+  if (top_node.next_child < siblings.size())
+  {
+    m_current = &siblings[top_node.next_child++];
+    DescendToLeaf();
+  }
+  else
+  {
+    m_current = top_node.tree;
+    m_stack.pop_back();
+  }
+  return *this;
+}
+
+TreeDataPostOrderIterator TreeDataPostOrderIterator::operator++(int)
+{
+  auto result = *this;
+  ++(*this);
+  return result;
+}
+
+std::size_t TreeDataPostOrderIterator::Depth() const
+{
+  return m_stack.size();
+}
+
+bool TreeDataPostOrderIterator::operator==(const TreeDataPostOrderIterator& other) const
+{
+  return m_current == other.m_current;
+}
+
+bool TreeDataPostOrderIterator::operator!=(const TreeDataPostOrderIterator& other) const
+{
+  return !(*this == other);
+}
+
+void TreeDataPostOrderIterator::DescendToLeaf()
+{
+  while (m_current->GetNumberOfChildren() > 0)
+  {
+    m_stack.push_back({m_current, 1});
+    m_current = &m_current->Children().front();
+  }
+}
+
+TreeDataRange<TreeDataPreOrderIterator> PreOrder(const TreeData& tree)
+{
+  return TreeDataRange<TreeDataPreOrderIterator>{tree};
+}
+
+TreeDataRange<TreeDataPostOrderIterator> PostOrder(const TreeData& tree)
+{
+  return TreeDataRange<TreeDataPostOrderIterator>{tree};
+}
+
+bool Visit(const TreeData& tree, const TreeDataVisitFunction& on_enter,
+           const TreeDataVisitFunction& on_leave)
+{
+  auto enter = [&on_enter](const TreeData& node, std::size_t depth)
+  {
+    return on_enter ? on_enter(node, depth) : VisitAction::kContinue;
+  };
+  auto leave = [&on_leave](const TreeData& node, std::size_t depth)
+  {
+    return on_leave ? on_leave(node, depth) : VisitAction::kContinue;
+  };
+  struct VisitStackNode
+  {
+    const TreeData* tree;
+    std::size_t next_child;
+  };
+  const auto root_action = enter(tree, 0);
+  if (root_action == VisitAction::kStop)
+  {
+    return false;
+  }
+  std::vector<VisitStackNode> stack;
+  if (root_action != VisitAction::kSkipChildren)
+  {
+    stack.push_back({&tree, 0});
+  }
+  else if (leave(tree, 0) == VisitAction::kStop)
+  {
+    return false;
+  }
+  while (!stack.empty())
+  {
+    auto& top_node = stack.back();
+    const auto& children = top_node.tree->Children();
+    if (top_node.next_child < children.size())
+    {
+      const auto& child = children[top_node.next_child++];
+      const auto depth = stack.size();
+      const auto action = enter(child, depth);
+      if (action == VisitAction::kStop)
+      {
+        return false;
+      }
+      if (action == VisitAction::kSkipChildren || child.GetNumberOfChildren() == 0)
+      {
+        if (leave(child, depth) == VisitAction::kStop)
+        {
+          return false;
+        }
+        continue;
+      }
+      stack.push_back({&child, 0});
+    }
+    else
+    {
+      const auto& node = *top_node.tree;
+      stack.pop_back();
+      if (leave(node, stack.size()) == VisitAction::kStop)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace xml
+
+}  // namespace sup
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_TRAVERSAL_H_
+#define SUP_XML_TREE_DATA_TRAVERSAL_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+/**
+ * @brief Forward iterator over all nodes of a tree in pre-order (document order): each node is
+ * visited before its children.
+ *
+ * @details The path from the root to the current node is kept on an explicit stack, so trees of
+ * any depth can be traversed. A default constructed iterator is the end iterator. Iterators are
+ * invalidated by any modification of the tree.
+ */
+class TreeDataPreOrderIterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = TreeData;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const TreeData*;
+  using reference = const TreeData&;
+
+  TreeDataPreOrderIterator();
+  explicit TreeDataPreOrderIterator(const TreeData& root);
+  ~TreeDataPreOrderIterator();
+
+  TreeDataPreOrderIterator(const TreeDataPreOrderIterator& other);
+  TreeDataPreOrderIterator(TreeDataPreOrderIterator&& other) noexcept;
+  TreeDataPreOrderIterator& operator=(const TreeDataPreOrderIterator& other) &;
+  TreeDataPreOrderIterator& operator=(TreeDataPreOrderIterator&& other) & noexcept;
+
+  reference operator*() const;
+  pointer operator->() const;
+
+  TreeDataPreOrderIterator& operator++();
+  TreeDataPreOrderIterator operator++(int);
+
+  /**
+   * @brief Depth of the current node: zero for the root node.
+   */
+  std::size_t Depth() const;
+
+  /**
+   * @brief Do not visit the children of the current node: the next increment moves to the
+   * following sibling (or the following sibling of the closest ancestor that has one).
+   */
+  void SkipChildren();
+
+  bool operator==(const TreeDataPreOrderIterator& other) const;
+  bool operator!=(const TreeDataPreOrderIterator& other) const;
+
+private:
+  struct StackNode
+  {
+    const TreeData* tree;
+    std::size_t next_child;
+  };
+  const TreeData* m_current;
+  bool m_skip_children;
+  std::vector<StackNode> m_stack;
+};
+
+/**
+ * @brief Forward iterator over all nodes of a tree in post-order: each node is visited after all
+ * its children, the root node last.
+ *
+ * @details Same properties as TreeDataPreOrderIterator.
+ */
+class TreeDataPostOrderIterator
+{
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = TreeData;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const TreeData*;
+  using reference = const TreeData&;
+
+  TreeDataPostOrderIterator();
+  explicit TreeDataPostOrderIterator(const TreeData& root);
+  ~TreeDataPostOrderIterator();
+
+  TreeDataPostOrderIterator(const TreeDataPostOrderIterator& other);
+  TreeDataPostOrderIterator(TreeDataPostOrderIterator&& other) noexcept;
+  TreeDataPostOrderIterator& operator=(const TreeDataPostOrderIterator& other) &;
+  TreeDataPostOrderIterator& operator=(TreeDataPostOrderIterator&& other) & noexcept;
+
+  reference operator*() const;
+  pointer operator->() const;
+
+  TreeDataPostOrderIterator& operator++();
+  TreeDataPostOrderIterator operator++(int);
+
+  /**
+   * @brief Depth of the current node: zero for the root node.
+   */
+  std::size_t Depth() const;
+
+  bool operator==(const TreeDataPostOrderIterator& other) const;
+  bool operator!=(const TreeDataPostOrderIterator& other) const;
+
+private:
+  //! Push the current node and its first children until a leaf is reached.
+  void DescendToLeaf();
+
+  struct StackNode
+  {
+    const TreeData* tree;
+    std::size_t next_child;
+  };
+  const TreeData* m_current;
+  std::vector<StackNode> m_stack;
+};
+
+/**
+ * @brief Pair of iterators for use in range-based for loops.
+ */
+template <typename Iterator>
+class TreeDataRange
+{
+public:
+  explicit TreeDataRange(const TreeData& root) : m_root{root} {}
+
+  Iterator begin() const { return Iterator{m_root}; }
+  Iterator end() const { return Iterator{}; }
+
+private:
+  const TreeData& m_root;
+};
+
+/**
+ * @brief Range over all nodes of a tree in pre-order, e.g. `for (const auto& node : PreOrder(tree))`.
+ */
+TreeDataRange<TreeDataPreOrderIterator> PreOrder(const TreeData& tree);
+
+/**
+ * @brief Range over all nodes of a tree in post-order.
+ */
+TreeDataRange<TreeDataPostOrderIterator> PostOrder(const TreeData& tree);
+
+/**
+ * @brief Return value of visitor callbacks, controlling the rest of the traversal.
+ */
+enum class VisitAction
+{
+  kContinue = 0,   //!< Continue the traversal.
+  kSkipChildren,   //!< Do not visit the children of this node (only meaningful on entering).
+  kStop            //!< End the traversal immediately.
+};
+
+/**
+ * @brief Callback receiving a node and its depth (zero for the root node).
+ */
+using TreeDataVisitFunction = std::function<VisitAction(const TreeData&, std::size_t)>;
+
+/**
+ * @brief Depth-first traversal of a tree without recursion.
+ *
+ * @param tree Tree to traverse.
+ * @param on_enter Called for each node before its children (may be empty).
+ * @param on_leave Called for each node after its children (may be empty), also when its children
+ * were skipped. Nodes that are still open when the traversal is stopped are not left.
+ *
+ * @return false when the traversal was stopped by one of the callbacks.
+ */
+bool Visit(const TreeData& tree, const TreeDataVisitFunction& on_enter,
+           const TreeDataVisitFunction& on_leave = {});
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_TRAVERSAL_H_
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "tree_data_utils.h"
+
+#include <algorithm>
+
+namespace sup
+{
+namespace xml
+{
+
+bool EqualAttributes(const std::vector<TreeData::Attribute>& left,
+                     const std::vector<TreeData::Attribute>& right)
+{
+  using Attribute = TreeData::Attribute;
+  if (left.size() != right.size())
+  {
+    return false;
+  }
+  // Attributes are usually stored in the same order
+  if (std::equal(left.begin(), left.end(), right.begin()))
+  {
+    return true;
+  }
+  // Attribute names are unique within a node: look up each name for small sets and compare sorted
+  // copies otherwise.
+  const std::size_t kMaxLinearSearch = 32;
+  if (left.size() <= kMaxLinearSearch)
+  {
+    for (const auto& attr : left)
+    {
+      auto it = std::find_if(right.begin(), right.end(), [&attr](const Attribute& other)
+                             { return attr.first == other.first; });
+      if (it == right.end() || it->second != attr.second)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  auto sorted = [](const std::vector<Attribute>& attributes)
+  {
+    std::vector<const Attribute*> result;
+    result.reserve(attributes.size());
+    for (const auto& attr : attributes)
+    {
+      result.push_back(&attr);
+    }
+    std::sort(result.begin(), result.end(), [](const Attribute* lhs, const Attribute* rhs)
+              { return InternedStringOrder{}(lhs->first, rhs->first); });
+    return result;
+  };
+  const auto left_sorted = sorted(left);
+  const auto right_sorted = sorted(right);
+  return std::equal(left_sorted.begin(), left_sorted.end(), right_sorted.begin(),
+                    [](const Attribute* lhs, const Attribute* rhs) { return *lhs == *rhs; });
+}
+
+std::size_t HashCombine(std::size_t seed, std::size_t value)
+{
+  // Mixing step of boost::hash_combine, widened to 64 bits
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 12) + (seed >> 4));
+}
+
+}  // namespace xml
+
+}  // namespace sup
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_TREE_DATA_UTILS_H_
+#define SUP_XML_TREE_DATA_UTILS_H_
+
+#include <sup/xml/tree_data.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace sup
+{
+namespace xml
+{
+//! Compare two attribute lists, independent of the order of the attributes.
+bool EqualAttributes(const std::vector<TreeData::Attribute>& left,
+                     const std::vector<TreeData::Attribute>& right);
+
+//! Mix a value into a hash seed.
+std::size_t HashCombine(std::size_t seed, std::size_t value);
+
+}  // namespace xml
+
+}  // namespace sup
+
+#endif  // SUP_XML_TREE_DATA_UTILS_H_
@@ -25,6 +25,41 @@
 #include "exceptions.h"
 
 #include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+using sup::xml::TreeData;
+
+/**
+ * @brief ElementRule with its children and attributes indexed by interned name.
+ */
+struct CompiledElementRule
+{
+  static constexpr std::size_t kForbidden = std::numeric_limits<std::size_t>::max();
+
+  std::vector<sup::xml::ChildRule> child_rules;
+  std::unordered_map<sup::xml::InternedString, std::size_t> child_slots;
+  bool allow_other_children;
+  std::vector<std::string> required_attributes;
+  // Index in required_attributes or kForbidden
+  std::unordered_map<sup::xml::InternedString, std::size_t> attributes;
+  sup::xml::ContentRule content;
+};
+
+CompiledElementRule CompileElementRule(const sup::xml::ElementRule& rule);
+
+void ValidateElement(const TreeData& tree, const CompiledElementRule& rule,
+                     std::vector<std::size_t>& counts, std::vector<std::string>& messages);
+
+std::string QuotedList(const std::vector<std::string>& items);
+
+template <typename Tag>
+void ValidateSingleChildWithTagImpl(const TreeData& tree, const Tag& child_tag);
+
+template <typename Tag>
+void ValidateAllowedChildTagsImpl(const TreeData& tree, const std::vector<Tag>& allowed_tags);
+}  // unnamed namespace
 
 namespace sup
 {
@@ -33,36 +68,24 @@ namespace xml
 
 void ValidateSingleChildWithTag(const TreeData& tree, const std::string& child_tag)
 {
-  const auto& children = tree.Children();
-  auto number_of_elements =
-    std::count_if(children.begin(), children.end(),
-                  [&child_tag](const TreeData& child)
-                  {
-                    return child.GetNodeName() == child_tag;
-                  });
-  if (number_of_elements != 1)
-  {
-    std::string error_message =
-      "sup::xml::ValidateSingleChildWithTag(): element with tag [" + tree.GetNodeName() +
-      "] requires exactly one child element with tag [" + child_tag + "]";
-    throw ValidationException(error_message);
-  }
+  ValidateSingleChildWithTagImpl(tree, child_tag);
+}
+
+void ValidateSingleChildWithInternedTag(const TreeData& tree, const InternedString& child_tag)
+{
+  ValidateSingleChildWithTagImpl(tree, child_tag);
 }
 
 void ValidateAllowedChildTags(const TreeData& tree,
                               const std::vector<std::string>& allowed_tags)
 {
-  for (const auto& child : tree.Children())
-  {
-    auto child_tag = child.GetNodeName();
-    if (std::find(allowed_tags.begin(), allowed_tags.end(), child_tag) == allowed_tags.end())
-    {
-      std::string error_message =
-        "sup::xml::ValidateAllowedChildTags(): element with tag [" + tree.GetNodeName() +
-        "] must not contain child with tag [" + child_tag + "]";
-      throw ValidationException(error_message);
-    }
-  }
+  ValidateAllowedChildTagsImpl(tree, allowed_tags);
+}
+
+void ValidateAllowedInternedChildTags(const TreeData& tree,
+                                      const std::vector<InternedString>& allowed_tags)
+{
+  ValidateAllowedChildTagsImpl(tree, allowed_tags);
 }
 
 void ValidateNoAttributes(const TreeData& tree)
@@ -89,7 +112,7 @@ void ValidateNoChildren(const TreeData& tree)
 
 void ValidateNoContent(const TreeData& tree)
 {
-  if (!tree.GetContent().empty())
+  if (!tree.Content().empty())
   {
     std::string error_message =
       "sup::xml::ValidateNoContent(): element with tag [" + tree.GetNodeName() +
@@ -98,6 +121,275 @@ void ValidateNoContent(const TreeData& tree)
   }
 }
 
+struct TreeDataSchema::TreeDataSchemaImpl
+{
+  std::unordered_map<InternedString, CompiledElementRule> m_rules{};
+  std::string m_root_tag{};
+  std::size_t m_max_child_rules = 0;
+};
+
+TreeDataSchema::TreeDataSchema(const std::vector<ElementRule>& rules, const std::string& root_tag)
+  : p_impl(std::make_unique<TreeDataSchemaImpl>())
+{
+  p_impl->m_root_tag = root_tag;
+  for (const auto& rule : rules)
+  {
+    auto compiled = CompileElementRule(rule);
+    p_impl->m_max_child_rules = std::max(p_impl->m_max_child_rules, compiled.child_rules.size());
+    if (!p_impl->m_rules.emplace(InternedString{rule.tag}, std::move(compiled)).second)
+    {
+      std::string message = "TreeDataSchema::TreeDataSchema(): duplicate rule for element with "
+        "tag [" + rule.tag + "]";
+      throw InvalidOperationException(message);
+    }
+  }
+}
+
+TreeDataSchema::~TreeDataSchema() = default;
+
+TreeDataSchema::TreeDataSchema(TreeDataSchema&& other) noexcept = default;
+TreeDataSchema& TreeDataSchema::operator=(TreeDataSchema&& other) & noexcept = default;
+
+std::vector<SchemaViolation> TreeDataSchema::Validate(const TreeData& tree) const
+{
+  std::vector<SchemaViolation> result;
+  if (!p_impl->m_root_tag.empty() && tree.GetInternedNodeName() != p_impl->m_root_tag)
+  {
+    result.push_back({{}, "root element has tag [" + tree.GetNodeName() + "] instead of [" +
+                          p_impl->m_root_tag + "]"});
+  }
+  // Pre-order walk keeping a cursor into the children of each open element: the cursors on the
+  // stack form the path of the current element, so paths are only built for violations.
+  struct ValidateStackNode
+  {
+    const TreeData* tree;
+    std::size_t next_child;
+  };
+  std::vector<ValidateStackNode> stack;
+  std::vector<std::size_t> counts(p_impl->m_max_child_rules);
+  std::vector<std::string> messages;
+  const TreeData* current = &tree;
+  while (current != nullptr)
+  {
+    auto it = p_impl->m_rules.find(current->GetInternedNodeName());
+    if (it != p_impl->m_rules.end())
+    {
+      ValidateElement(*current, it->second, counts, messages);
+      for (auto& message : messages)
+      {
+        std::vector<std::size_t> path;
+        path.reserve(stack.size());
+        for (const auto& node : stack)
+        {
+          path.push_back(node.next_child - 1);
+        }
+        result.push_back({std::move(path), std::move(message)});
+      }
+      messages.clear();
+    }
+    if (current->GetNumberOfChildren() > 0)
+    {
+      stack.push_back({current, 0});
+    }
+    current = nullptr;
+    while (!stack.empty() && current == nullptr)
+    {
+      auto& top_node = stack.back();
+      if (top_node.next_child < top_node.tree->GetNumberOfChildren())
+      {
+        current = &top_node.tree->Children()[top_node.next_child++];
+      }
+      else
+      {
+        stack.pop_back();
+      }
+    }
+  }
+  return result;
+}
+
+void ValidateTreeData(const TreeData& tree, const TreeDataSchema& schema)
+{
+  const auto violations = schema.Validate(tree);
+  if (violations.empty())
+  {
+    return;
+  }
+  std::string error_message = "sup::xml::ValidateTreeData(): " +
+    std::to_string(violations.size()) + " violation(s):";
+  for (const auto& violation : violations)
+  {
+    error_message += "\n  /";
+    for (std::size_t i = 0; i < violation.path.size(); ++i)
+    {
+      error_message += (i > 0 ? "/" : "") + std::to_string(violation.path[i]);
+    }
+    error_message += ": " + violation.message;
+  }
+  throw ValidationException(error_message);
+}
+
 }  // namespace xml
 
 }  // namespace sup
+
+namespace
+{
+using sup::xml::ValidationException;
+
+CompiledElementRule CompileElementRule(const sup::xml::ElementRule& rule)
+{
+  using sup::xml::InternedString;
+  CompiledElementRule result{{}, {}, rule.allow_other_children, rule.required_attributes, {},
+                             rule.content};
+  auto throw_invalid = [&rule](const std::string& reason)
+  {
+    std::string message = "TreeDataSchema::TreeDataSchema(): rule for element with tag [" +
+      rule.tag + "] " + reason;
+    throw sup::xml::InvalidOperationException(message);
+  };
+  for (const auto& child_rule : rule.children)
+  {
+    if (child_rule.min_occurs > child_rule.max_occurs)
+    {
+      throw_invalid("has child [" + child_rule.tag + "] with min_occurs larger than max_occurs");
+    }
+    if (!result.child_slots.emplace(InternedString{child_rule.tag},
+                                    result.child_rules.size()).second)
+    {
+      throw_invalid("lists child [" + child_rule.tag + "] more than once");
+    }
+    result.child_rules.push_back(child_rule);
+  }
+  for (std::size_t i = 0; i < rule.required_attributes.size(); ++i)
+  {
+    if (!result.attributes.emplace(InternedString{rule.required_attributes[i]}, i).second)
+    {
+      throw_invalid("lists attribute [" + rule.required_attributes[i] + "] more than once");
+    }
+  }
+  for (const auto& name : rule.forbidden_attributes)
+  {
+    if (!result.attributes.emplace(InternedString{name}, CompiledElementRule::kForbidden).second)
+    {
+      throw_invalid("lists attribute [" + name + "] more than once");
+    }
+  }
+  return result;
+}
+
+void ValidateElement(const TreeData& tree, const CompiledElementRule& rule,
+                     std::vector<std::size_t>& counts, std::vector<std::string>& messages)
+{
+  const auto& tag = tree.GetInternedNodeName().Str();
+  if (rule.content == sup::xml::ContentRule::kNone && !tree.Content().empty())
+  {
+    messages.push_back("element with tag [" + tag + "] must not have a content string");
+  }
+  else if (rule.content == sup::xml::ContentRule::kRequired && tree.Content().empty())
+  {
+    messages.push_back("element with tag [" + tag + "] requires a content string");
+  }
+  std::size_t n_required = 0;
+  for (const auto& attr : tree.Attributes())
+  {
+    auto it = rule.attributes.find(attr.first);
+    if (it == rule.attributes.end())
+    {
+      continue;
+    }
+    if (it->second == CompiledElementRule::kForbidden)
+    {
+      messages.push_back("element with tag [" + tag + "] must not have attribute [" +
+                         attr.first.Str() + "]");
+    }
+    else
+    {
+      ++n_required;
+    }
+  }
+  if (n_required < rule.required_attributes.size())
+  {
+    std::vector<std::string> missing;
+    for (const auto& name : rule.required_attributes)
+    {
+      if (tree.FindAttribute(name) == nullptr)
+      {
+        missing.push_back(name);
+      }
+    }
+    messages.push_back("element with tag [" + tag + "] is missing required attribute(s) " +
+                       QuotedList(missing));
+  }
+  std::fill(counts.begin(), counts.begin() + rule.child_rules.size(), 0);
+  for (const auto& child : tree.Children())
+  {
+    auto it = rule.child_slots.find(child.GetInternedNodeName());
+    if (it != rule.child_slots.end())
+    {
+      ++counts[it->second];
+    }
+    else if (!rule.allow_other_children)
+    {
+      messages.push_back("element with tag [" + tag + "] must not contain child with tag [" +
+                         child.GetInternedNodeName().Str() + "]");
+    }
+  }
+  for (std::size_t i = 0; i < rule.child_rules.size(); ++i)
+  {
+    const auto& child_rule = rule.child_rules[i];
+    if (counts[i] < child_rule.min_occurs || counts[i] > child_rule.max_occurs)
+    {
+      std::string expected = "at least " + std::to_string(child_rule.min_occurs);
+      if (child_rule.max_occurs != sup::xml::ChildRule::kUnbounded)
+      {
+        expected = child_rule.min_occurs == child_rule.max_occurs
+                     ? "exactly " + std::to_string(child_rule.min_occurs)
+                     : "between " + std::to_string(child_rule.min_occurs) + " and " +
+                         std::to_string(child_rule.max_occurs);
+      }
+      messages.push_back("element with tag [" + tag + "] requires " + expected +
+                         " child element(s) with tag [" + child_rule.tag + "], found " +
+                         std::to_string(counts[i]));
+    }
+  }
+}
+
+std::string QuotedList(const std::vector<std::string>& items)
+{
+  std::string result;
+  for (const auto& item : items)
+  {
+    result += (result.empty() ? "[" : ", [") + item + "]";
+  }
+  return result;
+}
+
+template <typename Tag>
+void ValidateSingleChildWithTagImpl(const TreeData& tree, const Tag& child_tag)
+{
+  if (tree.CountChildren(child_tag) != 1)
+  {
+    std::string error_message =
+      "sup::xml::ValidateSingleChildWithTag(): element with tag [" + tree.GetNodeName() +
+      "] requires exactly one child element with tag [" + std::string(child_tag) + "]";
+    throw ValidationException(error_message);
+  }
+}
+
+template <typename Tag>
+void ValidateAllowedChildTagsImpl(const TreeData& tree, const std::vector<Tag>& allowed_tags)
+{
+  for (const auto& child : tree.Children())
+  {
+    const auto& child_tag = child.GetInternedNodeName();
+    if (std::find(allowed_tags.begin(), allowed_tags.end(), child_tag) == allowed_tags.end())
+    {
+      std::string error_message =
+        "sup::xml::ValidateAllowedChildTags(): element with tag [" + tree.GetNodeName() +
+        "] must not contain child with tag [" + child_tag.Str() + "]";
+      throw ValidationException(error_message);
+    }
+  }
+}
+}  // unnamed namespace
@@ -25,7 +25,11 @@
 
 #include <sup/xml/tree_data.h>
 
+#include <cstddef>
+#include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace sup
 {
@@ -36,12 +40,125 @@ void ValidateSingleChildWithTag(const TreeData& tree, const std::string& child_t
 
 void ValidateAllowedChildTags(const TreeData& tree, const std::vector<std::string>& allowed_tags);
 
+/**
+ * @brief Variants taking interned tags, which reduce all tag comparisons to pointer compares.
+ * Callers that validate many elements should intern their tags once and use these.
+ *
+ * @note These have their own names instead of overloading the functions above, since a braced
+ * list of string literals would otherwise be ambiguous.
+ */
+void ValidateSingleChildWithInternedTag(const TreeData& tree, const InternedString& child_tag);
+
+void ValidateAllowedInternedChildTags(const TreeData& tree,
+                                      const std::vector<InternedString>& allowed_tags);
+
 void ValidateNoAttributes(const TreeData& tree);
 
 void ValidateNoChildren(const TreeData& tree);
 
 void ValidateNoContent(const TreeData& tree);
 
+/**
+ * @brief Allowed child element of an ElementRule, with the number of times it may occur.
+ */
+struct ChildRule
+{
+  static constexpr std::size_t kUnbounded = std::numeric_limits<std::size_t>::max();
+
+  std::string tag{};
+  std::size_t min_occurs = 0;
+  std::size_t max_occurs = kUnbounded;
+};
+
+/**
+ * @brief Constraint on the content string of an element.
+ */
+enum class ContentRule
+{
+  kAny = 0,   //!< Content is not checked.
+  kNone,      //!< Content must be empty.
+  kRequired   //!< Content must not be empty.
+};
+
+/**
+ * @brief Declarative constraints on all elements with a given tag.
+ *
+ * @details Child elements whose tag is not listed in children are violations, unless
+ * allow_other_children is set. Attributes that are neither required nor forbidden are always
+ * allowed.
+ */
+struct ElementRule
+{
+  std::string tag{};
+  std::vector<ChildRule> children{};
+  bool allow_other_children = false;
+  std::vector<std::string> required_attributes{};
+  std::vector<std::string> forbidden_attributes{};
+  ContentRule content = ContentRule::kAny;
+};
+
+/**
+ * @brief Single violation found while validating a tree against a TreeDataSchema.
+ *
+ * @details The element is addressed by its path: the child indices from the root element down
+ * to the offending element (empty for the root element).
+ */
+struct SchemaViolation
+{
+  std::vector<std::size_t> path{};
+  std::string message{};
+};
+
+/**
+ * @brief Set of element rules compiled into hash tables indexed by interned tag and attribute
+ * names.
+ *
+ * @details Validation visits every element exactly once, without recursion, and reports all
+ * violations instead of stopping at the first one. Elements whose tag has no rule are only
+ * checked as children of their parent. A compiled schema is immutable, so Validate can be called
+ * concurrently from multiple threads.
+ */
+class TreeDataSchema
+{
+public:
+  /**
+   * @brief Compile a set of rules.
+   *
+   * @param rules Element rules, at most one per tag.
+   * @param root_tag Required tag of the root element (not checked when empty).
+   *
+   * @throw InvalidOperationException when rules are inconsistent: duplicate element, child or
+   * attribute entries, an attribute that is both required and forbidden or a child rule with
+   * min_occurs larger than max_occurs.
+   */
+  explicit TreeDataSchema(const std::vector<ElementRule>& rules, const std::string& root_tag = {});
+  ~TreeDataSchema();
+
+  TreeDataSchema(TreeDataSchema&& other) noexcept;
+  TreeDataSchema& operator=(TreeDataSchema&& other) & noexcept;
+
+  TreeDataSchema(const TreeDataSchema&) = delete;
+  TreeDataSchema& operator=(const TreeDataSchema&) = delete;
+
+  /**
+   * @brief Validate a tree in a single pass.
+   *
+   * @return All violations in document order, empty when the tree is valid.
+   */
+  std::vector<SchemaViolation> Validate(const TreeData& tree) const;
+
+private:
+  struct TreeDataSchemaImpl;
+  std::unique_ptr<TreeDataSchemaImpl> p_impl;
+};
+
+/**
+ * @brief Validate a tree against a compiled schema.
+ *
+ * @throw ValidationException listing all violations when the tree is not valid.
+ */
+void ValidateTreeData(const TreeData& tree, const TreeDataSchema& schema);
+
 }  // namespace xml
 
 }  // namespace sup
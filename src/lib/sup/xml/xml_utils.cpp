@@ -31,11 +31,25 @@ std::string ToString(const xmlChar *xml_name)
   return std::string(reinterpret_cast<const char *>(xml_name), xmlStrlen(xml_name));
 }
 
+std::string_view ToStringView(const xmlChar *xml_name)
+{
+  if (xml_name == nullptr)
+  {
+    return {};
+  }
+  return std::string_view(reinterpret_cast<const char *>(xml_name), xmlStrlen(xml_name));
+}
+
 const xmlChar *FromString(const std::string &str)
 {
   return reinterpret_cast<const xmlChar *>(str.c_str());
 }
 
+const xmlChar *FromStringView(std::string_view str)
+{
+  return reinterpret_cast<const xmlChar *>(str.data());
+}
+
 }  // namespace xml
 
 }  // namespace sup
@@ -23,9 +23,12 @@
 #ifndef SUP_XML_XML_UTILS_H_
 #define SUP_XML_XML_UTILS_H_
 
+#include <libxml/tree.h>
 #include <libxml/xmlstring.h>
 
+#include <memory>
 #include <string>
+#include <string_view>
 
 namespace sup
 {
@@ -34,9 +37,23 @@ namespace xml
 //! Converts xmlChar array to std::string.
 std::string ToString(const xmlChar* xml_name);
 
+//! Views an xmlChar array as std::string_view without copying. A nullptr gives an empty view.
+std::string_view ToStringView(const xmlChar* xml_name);
+
 //! Converts std::string to xmlChar array. The result array is still owned by the input string.
 const xmlChar* FromString(const std::string& str);
 
+//! Converts a view on a null-terminated string to xmlChar array without copying.
+const xmlChar* FromStringView(std::string_view str);
+
+//! Frees an xmlDoc when its owning pointer goes out of scope.
+struct XMLDocDeleter
+{
+  void operator()(xmlDocPtr doc) const { xmlFreeDoc(doc); }
+};
+
+using XMLDocPointer = std::unique_ptr<xmlDoc, XMLDocDeleter>;
+
 }  // namespace xml
 
 }  // namespace sup
@@ -0,0 +1,294 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+
+#include <libxml/xmlmemory.h>
+
+#include <fcntl.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+namespace
+{
+std::atomic<std::size_t> g_allocation_count{0};
+std::atomic<std::size_t> g_live_bytes{0};
+std::atomic<std::size_t> g_peak_bytes{0};
+
+void* TrackedMalloc(std::size_t size);
+void TrackedFree(void* ptr);
+void* TrackedRealloc(void* ptr, std::size_t size);
+char* TrackedStrdup(const char* str);
+}  // unnamed namespace
+
+void* operator new(std::size_t size)
+{
+  ++g_allocation_count;
+  if (void* ptr = TrackedMalloc(size == 0 ? 1 : size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+  TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+namespace sup
+{
+namespace benchmark
+{
+
+std::size_t AllocationCount()
+{
+  return g_allocation_count.load();
+}
+
+std::size_t LiveHeapBytes()
+{
+  return g_live_bytes.load();
+}
+
+void InstallXMLMemoryHooks()
+{
+  (void)xmlMemSetup(TrackedFree, TrackedMalloc, TrackedRealloc, TrackedStrdup);
+}
+
+void ResetPeakHeapBytes()
+{
+  g_peak_bytes = g_live_bytes.load();
+}
+
+std::size_t PeakHeapBytes()
+{
+  return g_peak_bytes.load();
+}
+
+void PrintResult(const std::string& name, const BenchmarkResult& result, std::size_t bytes)
+{
+  const char* unit = "ms";
+  double scale = 1e3;
+  if (result.seconds < 1e-6)
+  {
+    unit = "ns";
+    scale = 1e9;
+  }
+  else if (result.seconds < 1e-3)
+  {
+    unit = "us";
+    scale = 1e6;
+  }
+  std::printf("%-48s %12.3f %s %14.0f allocs", name.c_str(), result.seconds * scale, unit,
+              result.allocations);
+  if (bytes > 0)
+  {
+    const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::printf(" %10.3f s/MB", result.seconds / megabytes);
+  }
+  std::printf("\n");
+}
+
+std::string GenerateWideDocument(std::size_t n_children)
+{
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Root>\n";
+  for (std::size_t i = 0; i < n_children; ++i)
+  {
+    result += "  <Child index=\"" + std::to_string(i) + "\">value</Child>\n";
+  }
+  result += "</Root>\n";
+  return result;
+}
+
+std::string GenerateDeepDocument(std::size_t depth)
+{
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    result += "<Level depth=\"" + std::to_string(i) + "\">";
+  }
+  result += "leaf";
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    result += "</Level>";
+  }
+  result += "\n";
+  return result;
+}
+
+std::string GenerateProcedureDocument(std::size_t n_instructions)
+{
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Procedure>\n";
+  result += "  <Workspace>\n";
+  for (std::size_t i = 0; i < n_instructions / 10; ++i)
+  {
+    const auto idx = std::to_string(i);
+    result += "    <Local name=\"var" + idx + "\" type='{\"type\":\"uint32\"}' value=\"" + idx +
+              "\"/>\n";
+  }
+  result += "  </Workspace>\n";
+  std::size_t count = 0;
+  while (count < n_instructions)
+  {
+    const auto idx = std::to_string(count);
+    result += "  <Sequence name=\"seq" + idx + "\">\n";
+    result += "    <Wait name=\"wait" + idx + "\" timeout=\"1.0\"/>\n";
+    result += "    <Copy name=\"copy" + idx + "\" inputVar=\"var1\" outputVar=\"var2\"/>\n";
+    result += "    <Message text=\"step " + idx + " completed\"/>\n";
+    result += "    <Description>Sequence number " + idx + "</Description>\n";
+    result += "  </Sequence>\n";
+    count += 5;
+  }
+  result += "</Procedure>\n";
+  return result;
+}
+
+std::string GenerateArchiveDocument(std::size_t n_records)
+{
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Archive>\n";
+  for (std::size_t i = 0; i < n_records; ++i)
+  {
+    const auto idx = std::to_string(i);
+    result += "  <Record id=\"" + idx + "\" timestamp=\"2026-01-01T00:00:00." + idx + "\">\n";
+    result += "    <Channel name=\"PCS:CH" + idx + "\" status=\"OK\">" + idx + "</Channel>\n";
+    result += "  </Record>\n";
+  }
+  result += "</Archive>\n";
+  return result;
+}
+
+std::string GenerateChannelDocument(std::size_t n_channels)
+{
+  const std::size_t n_templates = 8;
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Configuration>\n";
+  for (std::size_t i = 0; i < n_channels; ++i)
+  {
+    const auto idx = std::to_string(i % n_templates);
+    result += "  <Channel type=\"float64\" template=\"tpl" + idx + "\">\n";
+    result += "    <Limits low=\"-" + idx + "\" high=\"" + idx + "00\"/>\n";
+    result += "    <Alarm severity=\"major\" enabled=\"true\">Limit exceeded</Alarm>\n";
+    result += "    <Archive period=\"1.0\" deadband=\"0.01\"/>\n";
+    result += "    <Description>Channel template " + idx + "</Description>\n";
+    result += "  </Channel>\n";
+  }
+  result += "</Configuration>\n";
+  return result;
+}
+
+bool EvictFromPageCache(const std::string& filename)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  // Dirty pages cannot be dropped, so write them back first
+  const bool evicted = (fdatasync(fd) == 0) && (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+  (void)close(fd);
+  return evicted;
+}
+
+TemporaryFile::TemporaryFile(const std::string& filename, const std::string& contents)
+  : m_filename{filename}
+{
+  std::ofstream file_out(m_filename);
+  file_out.write(contents.c_str(), contents.size());
+}
+
+TemporaryFile::~TemporaryFile()
+{
+  std::remove(m_filename.c_str());
+}
+
+const std::string& TemporaryFile::Name() const
+{
+  return m_filename;
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+void UpdatePeak(std::size_t live)
+{
+  auto peak = g_peak_bytes.load();
+  while (live > peak && !g_peak_bytes.compare_exchange_weak(peak, live))
+  {}
+}
+
+void* TrackedMalloc(std::size_t size)
+{
+  void* ptr = std::malloc(size);
+  if (ptr != nullptr)
+  {
+    UpdatePeak(g_live_bytes += malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+void TrackedFree(void* ptr)
+{
+  if (ptr != nullptr)
+  {
+    g_live_bytes -= malloc_usable_size(ptr);
+  }
+  std::free(ptr);
+}
+
+void* TrackedRealloc(void* ptr, std::size_t size)
+{
+  const std::size_t old_size = ptr != nullptr ? malloc_usable_size(ptr) : 0;
+  void* result = std::realloc(ptr, size);
+  if (result != nullptr)
+  {
+    g_live_bytes -= old_size;
+    UpdatePeak(g_live_bytes += malloc_usable_size(result));
+  }
+  return result;
+}
+
+char* TrackedStrdup(const char* str)
+{
+  const std::size_t size = std::strlen(str) + 1;
+  auto result = static_cast<char*>(TrackedMalloc(size));
+  if (result != nullptr)
+  {
+    std::memcpy(result, str, size);
+  }
+  return result;
+}
+}  // unnamed namespace
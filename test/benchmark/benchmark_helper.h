@@ -0,0 +1,149 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_BENCHMARK_HELPER_H_
+#define SUP_XML_BENCHMARK_HELPER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace sup
+{
+namespace benchmark
+{
+/**
+ * @brief Result of a timed benchmark run, averaged over all repetitions.
+ */
+struct BenchmarkResult
+{
+  double seconds;
+  double allocations;
+};
+
+/**
+ * @brief Total number of calls to the global operator new since program start.
+ */
+std::size_t AllocationCount();
+
+/**
+ * @brief Number of bytes currently allocated through the global operator new.
+ */
+std::size_t LiveHeapBytes();
+
+/**
+ * @brief Route libxml2's allocations through the same accounting as operator new. Needs to be
+ * called before libxml2 is used.
+ */
+void InstallXMLMemoryHooks();
+
+/**
+ * @brief Reset the peak heap usage to the current heap usage.
+ */
+void ResetPeakHeapBytes();
+
+/**
+ * @brief Highest number of bytes allocated at any time since the last reset.
+ */
+std::size_t PeakHeapBytes();
+
+/**
+ * @brief Run the given function a number of times and return the average duration and number of
+ * heap allocations per run.
+ */
+template <typename F>
+BenchmarkResult Measure(F&& func, std::size_t repetitions)
+{
+  const auto alloc_start = AllocationCount();
+  const auto time_start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < repetitions; ++i)
+  {
+    func();
+  }
+  const auto time_end = std::chrono::steady_clock::now();
+  const auto alloc_end = AllocationCount();
+  const std::chrono::duration<double> elapsed = time_end - time_start;
+  return { elapsed.count() / repetitions,
+           static_cast<double>(alloc_end - alloc_start) / repetitions };
+}
+
+/**
+ * @brief Print a single result line. When the number of processed bytes is not zero, the
+ * throughput is also reported in seconds per MB.
+ */
+void PrintResult(const std::string& name, const BenchmarkResult& result, std::size_t bytes = 0);
+
+/**
+ * @brief Generate an XML document with a root element containing the given number of children.
+ */
+std::string GenerateWideDocument(std::size_t n_children);
+
+/**
+ * @brief Generate an XML document with the given nesting depth.
+ */
+std::string GenerateDeepDocument(std::size_t depth);
+
+/**
+ * @brief Generate a procedure-like XML document with the given number of instructions, using a
+ * small vocabulary of tags and attributes that is repeated throughout.
+ */
+std::string GenerateProcedureDocument(std::size_t n_instructions);
+
+/**
+ * @brief Generate an archive-like XML document with the given number of records under one root.
+ */
+std::string GenerateArchiveDocument(std::size_t n_records);
+
+/**
+ * @brief Generate a configuration-like XML document with the given number of channels, each an
+ * instance of one of a few templates, so most subtrees are repeated many times.
+ */
+std::string GenerateChannelDocument(std::size_t n_channels);
+
+/**
+ * @brief Write back and drop the cached pages of a file, so the next read hits the storage
+ * device. Returns false when the kernel did not accept the request.
+ */
+bool EvictFromPageCache(const std::string& filename);
+
+/**
+ * @brief Temporary file that is removed on destruction.
+ */
+class TemporaryFile
+{
+public:
+  TemporaryFile(const std::string& filename, const std::string& contents);
+  ~TemporaryFile();
+
+  TemporaryFile(const TemporaryFile&) = delete;
+  TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+  const std::string& Name() const;
+private:
+  std::string m_filename;
+};
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+#endif  // SUP_XML_BENCHMARK_HELPER_H_
@@ -0,0 +1,56 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#ifndef SUP_XML_BENCHMARKS_H_
+#define SUP_XML_BENCHMARKS_H_
+
+namespace sup
+{
+namespace benchmark
+{
+void RunParseBenchmarks();
+
+void RunFileBenchmarks();
+
+void RunBatchBenchmarks();
+
+void RunValidateBenchmarks();
+
+void RunLookupBenchmarks();
+
+void RunSerializeBenchmarks();
+
+void RunWalkBenchmarks();
+
+void RunCompareBenchmarks();
+
+void RunSchemaBenchmarks();
+
+void RunQueryBenchmarks();
+
+void RunPersistentBenchmarks();
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+#endif  // SUP_XML_BENCHMARKS_H_
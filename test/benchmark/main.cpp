@@ -0,0 +1,65 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+//! @file
+//! Benchmarks for sup-xml. Pass one or more group names to run only those groups.
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+  using namespace sup::benchmark;
+  InstallXMLMemoryHooks();
+  const std::vector<std::pair<std::string, std::function<void()>>> groups = {
+    { "parse", RunParseBenchmarks },
+    { "file", RunFileBenchmarks },
+    { "batch", RunBatchBenchmarks },
+    { "validate", RunValidateBenchmarks },
+    { "lookup", RunLookupBenchmarks },
+    { "serialize", RunSerializeBenchmarks },
+    { "walk", RunWalkBenchmarks },
+    { "compare", RunCompareBenchmarks },
+    { "schema", RunSchemaBenchmarks },
+    { "query", RunQueryBenchmarks },
+    { "persistent", RunPersistentBenchmarks }
+  };
+  for (const auto& group : groups)
+  {
+    bool selected = (argc < 2);
+    for (int i = 1; i < argc; ++i)
+    {
+      selected = selected || (group.first == argv[i]);
+    }
+    if (selected)
+    {
+      std::cout << "== " << group.first << std::endl;
+      group.second();
+    }
+  }
+  return 0;
+}
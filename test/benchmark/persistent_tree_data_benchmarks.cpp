@@ -0,0 +1,110 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/persistent_tree_data.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunPersistentBenchmarks()
+{
+  const auto procedure = GenerateProcedureDocument(100000);
+  const auto tree = xml::TreeDataFromString(procedure);
+  const std::size_t n_versions = 100;
+  std::size_t count = 0;
+
+  // Keeping versions of a tree with one modified leaf each, e.g. for undo
+  auto result = Measure(
+    [&]()
+    {
+      std::vector<xml::TreeData> versions{*tree};
+      for (std::size_t i = 1; i < n_versions; ++i)
+      {
+        auto version = versions.back();
+        version.AddAttribute("version" + std::to_string(i), "1");
+        versions.push_back(std::move(version));
+      }
+      count += versions.size();
+    }, 1);
+  PrintResult("TreeData/100 versions (deep copies)", result);
+  result = Measure([&]() { count += xml::PersistentTreeData{*tree}.GetNumberOfChildren(); }, 5);
+  PrintResult("PersistentTreeData/from TreeData", result);
+  const xml::PersistentTreeData persistent{*tree};
+  result = Measure(
+    [&]()
+    {
+      std::vector<xml::PersistentTreeData> versions{persistent};
+      for (std::size_t i = 1; i < n_versions; ++i)
+      {
+        auto version = versions.back();
+        version.UpdateNode({i, 0}, [i](xml::PersistentTreeData& leaf)
+                           { leaf.SetAttribute("version", std::to_string(i)); });
+        versions.push_back(std::move(version));
+      }
+      count += versions.size();
+    }, 5);
+  PrintResult("PersistentTreeData/100 versions (leaf edits)", result);
+  result = Measure([&]() { count += xml::PersistentTreeData{persistent}.GetNumberOfChildren(); },
+                   100000);
+  PrintResult("PersistentTreeData/copy", result);
+  result = Measure([&]() { count += persistent.ToTreeData().GetNumberOfChildren(); }, 5);
+  PrintResult("PersistentTreeData/to TreeData", result);
+
+  // Subtree sharing on a document made of repeated channel templates
+  const auto channels = xml::TreeDataFromString(GenerateChannelDocument(20000));
+  result = Measure([&]() { count += xml::ShareIdenticalSubtrees(*channels).CountNodes(); }, 5);
+  PrintResult("ShareIdenticalSubtrees/20000 channels", result);
+  auto bytes_before = LiveHeapBytes();
+  {
+    const auto copy = std::make_unique<xml::TreeData>(*channels);
+    std::printf("%-48s %12.3f MB\n", "Heap/channels (TreeData)",
+                static_cast<double>(LiveHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+  }
+  bytes_before = LiveHeapBytes();
+  {
+    const xml::PersistentTreeData unshared{*channels};
+    std::printf("%-48s %12.3f MB\n", "Heap/channels (PersistentTreeData)",
+                static_cast<double>(LiveHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+  }
+  bytes_before = LiveHeapBytes();
+  {
+    const auto shared = xml::ShareIdenticalSubtrees(*channels);
+    std::printf("%-48s %12.3f MB (%zu of %zu nodes stored)\n", "Heap/channels (shared subtrees)",
+                static_cast<double>(LiveHeapBytes() - bytes_before) / (1024.0 * 1024.0),
+                shared.CountDistinctNodes(), shared.CountNodes());
+  }
+  std::printf("(checksum %zu)\n", count);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
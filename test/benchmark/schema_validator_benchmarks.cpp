@@ -0,0 +1,120 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/schema_validator.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+const std::string PROCEDURE_SCHEMA = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<xs:schema xmlns:xs="http://www.w3.org/2001/XMLSchema">
+  <xs:complexType name="Instruction">
+    <xs:attribute name="name" type="xs:string"/>
+    <xs:anyAttribute processContents="skip"/>
+  </xs:complexType>
+  <xs:element name="Procedure">
+    <xs:complexType>
+      <xs:sequence>
+        <xs:element name="Workspace">
+          <xs:complexType>
+            <xs:sequence>
+              <xs:element name="Local" minOccurs="0" maxOccurs="unbounded">
+                <xs:complexType>
+                  <xs:attribute name="name" type="xs:string" use="required"/>
+                  <xs:attribute name="type" type="xs:string" use="required"/>
+                  <xs:attribute name="value" type="xs:string"/>
+                </xs:complexType>
+              </xs:element>
+            </xs:sequence>
+          </xs:complexType>
+        </xs:element>
+        <xs:element name="Sequence" minOccurs="0" maxOccurs="unbounded">
+          <xs:complexType>
+            <xs:sequence>
+              <xs:element name="Wait" type="Instruction"/>
+              <xs:element name="Copy" type="Instruction"/>
+              <xs:element name="Message" type="Instruction"/>
+              <xs:element name="Description" type="xs:string"/>
+            </xs:sequence>
+            <xs:attribute name="name" type="xs:string" use="required"/>
+          </xs:complexType>
+        </xs:element>
+      </xs:sequence>
+    </xs:complexType>
+  </xs:element>
+</xs:schema>
+)RAW";
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunSchemaBenchmarks()
+{
+  // Many small documents validated against the same schema
+  const std::size_t n_documents = 10000;
+  const auto document = GenerateProcedureDocument(50);
+  const TemporaryFile schema_file{"benchmark_schema.xsd", PROCEDURE_SCHEMA};
+  std::size_t n_errors = 0;
+
+  auto result = Measure(
+    [&]()
+    {
+      const xml::SchemaValidator validator{PROCEDURE_SCHEMA, xml::SchemaType::kXmlSchema};
+      n_errors += validator.Validate(document).size();
+    }, n_documents / 10);
+  PrintResult("Compile+Validate/document", result);
+  std::printf("%-48s %12.3f s (extrapolated)\n", "Compile+Validate/10k documents",
+              result.seconds * n_documents);
+
+  xml::ClearSchemaValidatorCache();
+  result = Measure(
+    [&]()
+    {
+      auto validator = xml::SchemaValidatorFromFile(schema_file.Name(),
+                                                    xml::SchemaType::kXmlSchema);
+      n_errors += validator->Validate(document).size();
+    }, n_documents);
+  PrintResult("SchemaValidatorFromFile+Validate/document", result);
+  std::printf("%-48s %12.3f s\n", "SchemaValidatorFromFile+Validate/10k documents",
+              result.seconds * n_documents);
+
+  auto validator = xml::SchemaValidatorFromFile(schema_file.Name(), xml::SchemaType::kXmlSchema);
+  result = Measure([&]() { n_errors += validator->Validate(document).size(); }, n_documents);
+  PrintResult("Validate/document", result);
+  const auto tree = xml::TreeDataFromString(document);
+  result = Measure([&]() { n_errors += validator->Validate(*tree).size(); }, n_documents);
+  PrintResult("Validate/TreeData", result);
+  std::printf("(errors %zu)\n", n_errors);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
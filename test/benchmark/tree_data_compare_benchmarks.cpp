@@ -0,0 +1,98 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_diff.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <string>
+
+namespace
+{
+/**
+ * @brief Tree with the given number of nodes, each having the given number of attributes. When
+ * reversed, the attributes of each node are added in reverse order.
+ */
+sup::xml::TreeData CreateAttributeTree(std::size_t n_nodes, std::size_t n_attributes,
+                                       bool reversed);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunCompareBenchmarks()
+{
+  const auto procedure = GenerateProcedureDocument(100000);
+  const auto left = xml::TreeDataFromString(procedure);
+  const auto right = xml::TreeDataFromString(procedure);
+  auto result = Measure([&left, &right]() { (void)(*left == *right); }, 10);
+  PrintResult("operator==/procedure (equal)", result);
+  result = Measure([&left]() { (void)xml::Hash(*left); }, 10);
+  PrintResult("Hash/procedure", result);
+
+  const auto ordered = CreateAttributeTree(10000, 32, false);
+  const auto reversed = CreateAttributeTree(10000, 32, true);
+  result = Measure([&ordered, &reversed]() { (void)(ordered == reversed); }, 10);
+  PrintResult("operator==/32 attributes reordered", result);
+
+  // Reload after a single attribute was edited: reparse versus diff and patch
+  auto edited_procedure = procedure;
+  const std::string old_timeout = "name=\"wait50000\" timeout=\"1.0\"";
+  edited_procedure.replace(edited_procedure.find(old_timeout), old_timeout.size(),
+                           "name=\"wait50000\" timeout=\"2.5\"");
+  const auto edited = xml::TreeDataFromString(edited_procedure);
+  result = Measure([&edited_procedure]() { (void)xml::TreeDataFromString(edited_procedure); }, 10);
+  PrintResult("TreeDataFromString/procedure (reload)", result);
+  xml::TreeDataPatch patch;
+  result = Measure([&left, &edited, &patch]() { patch = xml::Diff(*left, *edited); }, 10);
+  PrintResult("Diff/procedure (1 attribute)", result);
+  auto patched = *left;
+  result = Measure([&patched, &patch]() { xml::ApplyPatch(patched, patch); }, 10);
+  PrintResult("ApplyPatch/procedure (1 attribute)", result);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+sup::xml::TreeData CreateAttributeTree(std::size_t n_nodes, std::size_t n_attributes,
+                                       bool reversed)
+{
+  sup::xml::TreeData result{"Root"};
+  for (std::size_t i = 0; i < n_nodes; ++i)
+  {
+    auto& node = result.EmplaceChild("Node");
+    for (std::size_t j = 0; j < n_attributes; ++j)
+    {
+      const auto idx = reversed ? n_attributes - 1 - j : j;
+      node.AddAttribute("attribute" + std::to_string(idx), "value" + std::to_string(idx));
+    }
+  }
+  return result;
+}
+}  // unnamed namespace
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/mapped_file.h>
+#include <sup/xml/tree_data_file_cache.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+sup::benchmark::BenchmarkResult MeasureColdCache(const std::string& filename,
+                                                 sup::xml::ParseMode mode,
+                                                 sup::xml::FileAccess access,
+                                                 std::size_t repetitions);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunFileBenchmarks()
+{
+  using xml::FileAccess;
+  using xml::ParseMode;
+  const auto procedure = GenerateProcedureDocument(100000);
+  const TemporaryFile file{"xml_benchmark_procedure.xml", procedure};
+  const auto& filename = file.Name();
+  if (!EvictFromPageCache(filename))
+  {
+    std::printf("Page cache eviction not supported: cold results are not meaningful\n");
+  }
+  const std::size_t repetitions = 5;
+  const std::pair<ParseMode, std::string> modes[] = {
+    { ParseMode::kDocument, "document" }, { ParseMode::kStreaming, "streaming" } };
+  const std::pair<FileAccess, std::string> accesses[] = {
+    { FileAccess::kBuffered, "buffered" }, { FileAccess::kMemoryMapped, "mmap" } };
+  for (const auto& mode : modes)
+  {
+    for (const auto& access : accesses)
+    {
+      const auto suffix = " (" + mode.second + ", " + access.second + ")";
+      auto result = MeasureColdCache(filename, mode.first, access.first, repetitions);
+      PrintResult("TreeDataFromFile/cold" + suffix, result, procedure.size());
+      result = Measure([&filename, &mode, &access]()
+                       { (void)xml::TreeDataFromFile(filename, mode.first, access.first); },
+                       repetitions);
+      PrintResult("TreeDataFromFile/warm" + suffix, result, procedure.size());
+    }
+  }
+  const xml::MappedFile mapped_file{filename};
+  auto result = Measure([&mapped_file]()
+                        { (void)xml::TreeDataFromMemory(mapped_file.Data(), mapped_file.Size()); },
+                        repetitions);
+  PrintResult("TreeDataFromMemory/premapped (document)", result, procedure.size());
+
+  // Parse cache: the first load parses and writes the entry, later loads read it back
+  const std::string cache_directory = "xml_benchmark_parse_cache";
+  std::filesystem::remove_all(cache_directory);
+  {
+    xml::TreeDataFileCache cache{cache_directory};
+    result = Measure([&cache, &filename]() { (void)cache.TreeDataFromFile(filename); }, 1);
+    PrintResult("TreeDataFileCache/miss", result, procedure.size());
+    result = Measure([&cache, &filename]() { (void)cache.TreeDataFromFile(filename); },
+                     repetitions);
+    PrintResult("TreeDataFileCache/hit", result, procedure.size());
+    const auto stats = cache.GetStatistics();
+    std::printf("(hits %zu, misses %zu)\n", stats.hits, stats.misses);
+  }
+  std::filesystem::remove_all(cache_directory);
+}
+
+void RunBatchBenchmarks()
+{
+  const std::size_t n_files = 2000;
+  const auto contents = GenerateProcedureDocument(200);
+  std::vector<std::unique_ptr<TemporaryFile>> files;
+  std::vector<std::string> filenames;
+  for (std::size_t i = 0; i < n_files; ++i)
+  {
+    files.emplace_back(
+      new TemporaryFile("xml_benchmark_batch_" + std::to_string(i) + ".xml", contents));
+    filenames.push_back(files.back()->Name());
+  }
+  // Powers of two up to the number of hardware threads, which is always included
+  const unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<unsigned> thread_counts;
+  for (unsigned threads = 1; threads < max_threads; threads *= 2)
+  {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+  double single_thread_seconds = 0.0;
+  for (auto threads : thread_counts)
+  {
+    const auto result = Measure([&filenames, threads]()
+                                { (void)xml::TreeDataFromFiles(filenames, threads); }, 3);
+    if (threads == 1)
+    {
+      single_thread_seconds = result.seconds;
+    }
+    const auto name = "TreeDataFromFiles/2000 files (" + std::to_string(threads) + " threads)";
+    PrintResult(name, result, contents.size() * n_files);
+    std::printf("%-48s %12.2f x\n", "  speedup", single_thread_seconds / result.seconds);
+  }
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+sup::benchmark::BenchmarkResult MeasureColdCache(const std::string& filename,
+                                                 sup::xml::ParseMode mode,
+                                                 sup::xml::FileAccess access,
+                                                 std::size_t repetitions)
+{
+  using namespace sup::benchmark;
+  double seconds = 0.0;
+  double allocations = 0.0;
+  for (std::size_t i = 0; i < repetitions; ++i)
+  {
+    (void)EvictFromPageCache(filename);
+    const auto result = Measure([&]() { (void)sup::xml::TreeDataFromFile(filename, mode, access); },
+                                1);
+    seconds += result.seconds;
+    allocations += result.allocations;
+  }
+  return { seconds / repetitions, allocations / repetitions };
+}
+}  // unnamed namespace
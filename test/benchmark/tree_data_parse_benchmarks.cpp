@@ -0,0 +1,134 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_parser.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <memory_resource>
+#include <vector>
+
+namespace
+{
+void PrintPeakMemory(const std::string& name, const std::string& xml_str,
+                     sup::xml::ParseMode mode);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunParseBenchmarks()
+{
+  const auto procedure = GenerateProcedureDocument(100000);
+  auto result = Measure([&procedure]() { (void)xml::TreeDataFromString(procedure); }, 5);
+  PrintResult("TreeDataFromString/procedure", result, procedure.size());
+  result = Measure([&procedure]() { (void)xml::FlatTreeDataFromString(procedure); }, 5);
+  PrintResult("FlatTreeDataFromString/procedure", result, procedure.size());
+  result = Measure(
+    [&procedure]()
+    {
+      std::pmr::monotonic_buffer_resource arena{procedure.size()};
+      (void)xml::PmrTreeDataFromString(procedure, &arena);
+    }, 5);
+  PrintResult("PmrTreeDataFromString/procedure (arena)", result, procedure.size());
+  result = Measure([&procedure]() { (void)xml::PmrTreeDataFromString(procedure); }, 5);
+  PrintResult("PmrTreeDataFromString/procedure (default)", result, procedure.size());
+  // Request-sized documents: one arena per request, reusing an initial buffer
+  const auto request = GenerateProcedureDocument(50);
+  std::vector<std::byte> buffer(1 << 20);
+  result = Measure([&request]() { (void)xml::TreeDataFromString(request); }, 2000);
+  PrintResult("TreeDataFromString/request", result, request.size());
+  result = Measure(
+    [&request, &buffer]()
+    {
+      std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+      (void)xml::PmrTreeDataFromString(request, &arena);
+    }, 2000);
+  PrintResult("PmrTreeDataFromString/request (arena)", result, request.size());
+  result = Measure([&procedure]()
+                   { (void)xml::TreeDataFromString(procedure, xml::ParseMode::kStreaming); }, 5);
+  PrintResult("TreeDataFromString/procedure (streaming)", result, procedure.size());
+  PrintPeakMemory("Peak heap/procedure (document)", procedure, xml::ParseMode::kDocument);
+  PrintPeakMemory("Peak heap/procedure (streaming)", procedure, xml::ParseMode::kStreaming);
+
+  const TemporaryFile archive{"xml_benchmark_archive.xml", GenerateArchiveDocument(200000)};
+  ResetPeakHeapBytes();
+  auto bytes_before = LiveHeapBytes();
+  std::size_t n_records = 0;
+  result = Measure([&archive, &n_records]()
+                   { xml::ParseTreeDataStream(archive.Name(), 1,
+                                              [&n_records](xml::TreeData&) { ++n_records; }); },
+                   1);
+  PrintResult("ParseTreeDataStream/archive(200k)", result);
+  std::printf("%-48s %12.3f MB\n", "Peak heap/archive (records)",
+              static_cast<double>(PeakHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+  ResetPeakHeapBytes();
+  bytes_before = LiveHeapBytes();
+  (void)xml::TreeDataFromFile(archive.Name(), xml::ParseMode::kStreaming);
+  std::printf("%-48s %12.3f MB\n", "Peak heap/archive (full tree, streaming)",
+              static_cast<double>(PeakHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+
+  const auto wide = GenerateWideDocument(10000);
+  result = Measure([&wide]() { (void)xml::TreeDataFromString(wide); }, 5);
+  PrintResult("TreeDataFromString/wide(10k)", result, wide.size());
+
+  const auto deep = GenerateDeepDocument(200);
+  result = Measure([&deep]() { (void)xml::TreeDataFromString(deep); }, 5);
+  PrintResult("TreeDataFromString/deep(200)", result, deep.size());
+
+  // Small messages, parsed one after the other
+  const auto message = GenerateProcedureDocument(20);
+  const std::size_t n_messages = 20000;
+  result = Measure([&message]() { (void)xml::TreeDataFromString(message); }, n_messages);
+  PrintResult("TreeDataFromString/message(" + std::to_string(message.size()) + " B)", result,
+              message.size());
+  std::printf("%-48s %12.0f msg/s\n", "  throughput", 1.0 / result.seconds);
+  xml::TreeDataParser parser;
+  result = Measure([&parser, &message]() { (void)parser.Parse(message); }, n_messages);
+  PrintResult("TreeDataParser/message(" + std::to_string(message.size()) + " B)", result,
+              message.size());
+  std::printf("%-48s %12.0f msg/s\n", "  throughput", 1.0 / result.seconds);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+void PrintPeakMemory(const std::string& name, const std::string& xml_str,
+                     sup::xml::ParseMode mode)
+{
+  using namespace sup::benchmark;
+  const auto bytes_before = LiveHeapBytes();
+  ResetPeakHeapBytes();
+  auto tree = sup::xml::TreeDataFromString(xml_str, mode);
+  std::printf("%-48s %12.3f MB (tree %.3f MB)\n", name.c_str(),
+              static_cast<double>(PeakHeapBytes() - bytes_before) / (1024.0 * 1024.0),
+              static_cast<double>(LiveHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+}
+}  // unnamed namespace
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_query.h>
+
+#include <cstdio>
+#include <string>
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunQueryBenchmarks()
+{
+  const auto procedure = GenerateProcedureDocument(100000);
+  const auto tree = xml::TreeDataFromString(procedure);
+  std::size_t count = 0;
+
+  // Hand-written lookup of a nested element, as done by plugins
+  auto result = Measure(
+    [&tree, &count]()
+    {
+      for (const auto& child : tree->Children())
+      {
+        if (child.GetNodeName() == "Sequence" && child.HasAttribute("name") &&
+            child.GetAttribute("name") == "seq50000")
+        {
+          for (const auto& grandchild : child.Children())
+          {
+            if (grandchild.GetNodeName() == "Message")
+            {
+              ++count;
+            }
+          }
+        }
+      }
+    }, 10);
+  PrintResult("Loop/Sequence[@name]/Message", result);
+  const xml::TreeDataQuery nested{"/Procedure/Sequence[@name='seq50000']/Message"};
+  result = Measure([&]() { count += nested.Count(*tree); }, 10);
+  PrintResult("TreeDataQuery/Sequence[@name]/Message", result);
+
+  const xml::TreeDataQuery descendants{"//Wait"};
+  result = Measure([&]() { count += descendants.Count(*tree); }, 10);
+  PrintResult("TreeDataQuery//Wait", result);
+  result = Measure([&]() { count += descendants.FindFirst(*tree) != nullptr ? 1 : 0; }, 1000);
+  PrintResult("TreeDataQuery//Wait (first)", result);
+  result = Measure([&]() { (void)xml::TreeDataTagIndex{*tree}; }, 10);
+  PrintResult("TreeDataTagIndex/procedure", result);
+  const xml::TreeDataTagIndex index{*tree};
+  result = Measure([&]() { count += descendants.Count(index); }, 10);
+  PrintResult("TreeDataQuery//Wait (tag index)", result);
+  const xml::TreeDataQuery selective{"//Wait[@name='wait50000']"};
+  result = Measure([&]() { count += selective.Count(*tree); }, 10);
+  PrintResult("TreeDataQuery//Wait[@name]", result);
+  result = Measure([&]() { count += selective.Count(index); }, 10);
+  PrintResult("TreeDataQuery//Wait[@name] (tag index)", result);
+
+  // Child lookup by tag on a wide element
+  xml::TreeData wide{"Registry"};
+  for (int i = 0; i < 10000; ++i)
+  {
+    (void)wide.EmplaceChild("Entry" + std::to_string(i));
+  }
+  const xml::InternedString last_tag{"Entry9999"};
+  result = Measure(
+    [&]()
+    {
+      for (const auto& child : wide.Children())
+      {
+        if (child.GetInternedNodeName() == last_tag)
+        {
+          ++count;
+          break;
+        }
+      }
+    }, 1000);
+  PrintResult("Loop/wide element child by tag", result);
+  result = Measure([&]() { count += wide.FindChild(last_tag) != nullptr ? 1u : 0u; }, 1000);
+  PrintResult("FindChild/wide element (indexed)", result);
+  result = Measure([&]() { count += wide.CountChildren("Entry5000"); }, 1000);
+  PrintResult("CountChildren/wide element (indexed)", result);
+  std::printf("(checksum %zu)\n", count);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
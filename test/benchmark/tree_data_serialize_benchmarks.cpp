@@ -0,0 +1,128 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_serialize.h>
+#include <sup/xml/tree_data_serialize_utils.h>
+#include <sup/xml/xml_utils.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+
+namespace
+{
+/**
+ * @brief Serialization through libxml2's text writer, as TreeDataToString did before the native
+ * writer was introduced.
+ */
+std::string SerializeWithLibXml(const sup::xml::TreeData& tree);
+
+void PrintPeakMemory(const std::string& name, const std::function<void()>& func);
+
+void PrintFileTradeoff(const std::string& name, const sup::xml::TreeData& tree,
+                       const sup::xml::SerializeOptions& options);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunSerializeBenchmarks()
+{
+  const auto procedure = xml::TreeDataFromString(GenerateProcedureDocument(100000));
+  const auto size = xml::TreeDataToString(*procedure).size();
+  auto result = Measure([&procedure]() { (void)SerializeWithLibXml(*procedure); }, 5);
+  PrintResult("xmlTextWriter/procedure", result, size);
+  result = Measure([&procedure]() { (void)xml::TreeDataToString(*procedure); }, 5);
+  PrintResult("TreeDataToString/procedure", result, size);
+  std::size_t n_bytes = 0;
+  xml::CallbackSink sink{[&n_bytes](const char*, std::size_t size) { n_bytes += size; }};
+  result = Measure([&procedure, &sink]() { xml::TreeDataToSink(sink, *procedure); }, 5);
+  PrintResult("TreeDataToSink/procedure", result, size);
+  PrintPeakMemory("Peak heap/TreeDataToString",
+                  [&procedure]() { (void)xml::TreeDataToString(*procedure); });
+  PrintPeakMemory("Peak heap/TreeDataToSink",
+                  [&procedure, &sink]() { xml::TreeDataToSink(sink, *procedure); });
+
+  // Size and time tradeoffs for writing and reading back files
+  xml::SerializeOptions options;
+  PrintFileTradeoff("indented", *procedure, options);
+  options.compact = true;
+  PrintFileTradeoff("compact", *procedure, options);
+  for (int level : { 1, 6, 9 })
+  {
+    options.compression = level;
+    PrintFileTradeoff("compact, gzip " + std::to_string(level), *procedure, options);
+  }
+
+  const auto message = xml::TreeDataFromString(GenerateProcedureDocument(20));
+  const auto message_size = xml::TreeDataToString(*message).size();
+  result = Measure([&message]() { (void)SerializeWithLibXml(*message); }, 20000);
+  PrintResult("xmlTextWriter/message", result, message_size);
+  result = Measure([&message]() { (void)xml::TreeDataToString(*message); }, 20000);
+  PrintResult("TreeDataToString/message", result, message_size);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+std::string SerializeWithLibXml(const sup::xml::TreeData& tree)
+{
+  using namespace sup::xml;
+  const XMLBufferHandle buffer{};
+  const XMLTextWriterHandle writer{xmlNewTextWriterMemory(buffer.Buffer(), 0)};
+  SerializeUsingWriter(writer.Writer(), tree);
+  (void)xmlTextWriterFlush(writer.Writer());
+  return ToString(xmlBufferContent(buffer.Buffer()));
+}
+
+void PrintPeakMemory(const std::string& name, const std::function<void()>& func)
+{
+  using namespace sup::benchmark;
+  const auto bytes_before = LiveHeapBytes();
+  ResetPeakHeapBytes();
+  func();
+  std::printf("%-48s %12.3f MB\n", name.c_str(),
+              static_cast<double>(PeakHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+}
+
+void PrintFileTradeoff(const std::string& name, const sup::xml::TreeData& tree,
+                       const sup::xml::SerializeOptions& options)
+{
+  using namespace sup::benchmark;
+  const TemporaryFile file{"xml_benchmark_serialize.xml", ""};
+  const auto write = Measure([&]() { sup::xml::TreeDataToFile(file.Name(), tree, options); }, 3);
+  const auto read = Measure([&]() { (void)sup::xml::TreeDataFromFile(file.Name()); }, 3);
+  std::ifstream file_in(file.Name(), std::ios::binary | std::ios::ate);
+  const auto file_size = static_cast<double>(file_in.tellg());
+  std::printf("%-48s %9.3f MB write %8.3f ms read %8.3f ms\n", ("File/" + name).c_str(),
+              file_size / (1024.0 * 1024.0), write.seconds * 1e3, read.seconds * 1e3);
+}
+}  // unnamed namespace
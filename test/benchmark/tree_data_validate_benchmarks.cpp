@@ -0,0 +1,144 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_validate.h>
+
+#include <cstdio>
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunValidateBenchmarks()
+{
+  const auto procedure = GenerateProcedureDocument(100000);
+  const auto bytes_before = LiveHeapBytes();
+  auto tree = xml::TreeDataFromString(procedure);
+  std::printf("%-48s %12.3f MB\n", "TreeData/procedure heap size",
+              static_cast<double>(LiveHeapBytes() - bytes_before) / (1024.0 * 1024.0));
+
+  const std::vector<std::string> allowed_tags = { "Workspace", "Sequence", "Fallback",
+                                                  "Parallel", "Repeat", "Inverter" };
+  const std::vector<std::string> allowed_children = { "Wait", "Copy", "Message", "Description",
+                                                      "Equals", "Increment", "Listen" };
+  auto result = Measure(
+    [&tree, &allowed_tags, &allowed_children]()
+    {
+      xml::ValidateAllowedChildTags(*tree, allowed_tags);
+      for (const auto& child : tree->Children())
+      {
+        if (child.GetNodeName() == "Sequence")
+        {
+          xml::ValidateAllowedChildTags(child, allowed_children);
+          xml::ValidateSingleChildWithTag(child, "Description");
+        }
+      }
+    }, 10);
+  PrintResult("Validate/procedure", result);
+
+  const std::vector<xml::InternedString> interned_tags(allowed_tags.begin(), allowed_tags.end());
+  const std::vector<xml::InternedString> interned_children(allowed_children.begin(),
+                                                           allowed_children.end());
+  const xml::InternedString sequence_tag{"Sequence"};
+  const xml::InternedString description_tag{"Description"};
+  result = Measure(
+    [&]()
+    {
+      xml::ValidateAllowedInternedChildTags(*tree, interned_tags);
+      for (const auto& child : tree->Children())
+      {
+        if (child.GetInternedNodeName() == sequence_tag)
+        {
+          xml::ValidateAllowedInternedChildTags(child, interned_children);
+          xml::ValidateSingleChildWithInternedTag(child, description_tag);
+        }
+      }
+    }, 10);
+  PrintResult("Validate/procedure (interned tags)", result);
+
+  // Same constraints and more as a compiled schema, checking every element in one pass
+  const auto unbounded = xml::ChildRule::kUnbounded;
+  xml::ElementRule procedure_rule{"Procedure", {}, false, {}, {}, xml::ContentRule::kNone};
+  for (const auto& tag : allowed_tags)
+  {
+    procedure_rule.children.push_back({tag, 0, tag == "Workspace" ? 1 : unbounded});
+  }
+  xml::ElementRule sequence_rule{"Sequence", {}, false, {"name"}, {}, xml::ContentRule::kNone};
+  for (const auto& tag : allowed_children)
+  {
+    const bool required = tag == "Description";
+    sequence_rule.children.push_back({tag, required ? 1u : 0u, required ? 1u : unbounded});
+  }
+  const xml::TreeDataSchema schema{
+    { procedure_rule,
+      {"Workspace", {{"Local", 0, unbounded}}, false, {}, {}, xml::ContentRule::kNone},
+      {"Local", {}, false, {"name", "type"}, {}, xml::ContentRule::kNone},
+      sequence_rule,
+      {"Wait", {}, false, {"name"}, {}, xml::ContentRule::kNone},
+      {"Copy", {}, false, {"inputVar", "outputVar"}, {}, xml::ContentRule::kNone},
+      {"Message", {}, false, {"text"}, {"name"}, xml::ContentRule::kNone},
+      {"Description", {}, false, {}, {"name"}, xml::ContentRule::kRequired} },
+    "Procedure"};
+  std::size_t n_violations = 0;
+  result = Measure([&]() { n_violations += schema.Validate(*tree).size(); }, 10);
+  PrintResult("TreeDataSchema::Validate/procedure", result);
+  std::printf("(violations %zu)\n", n_violations);
+}
+
+void RunLookupBenchmarks()
+{
+  // Names and values longer than the small string buffer, so copies always allocate
+  const std::string attr_name = "attribute_with_a_rather_long_name";
+  xml::TreeData tree{"NodeWithALongElementName"};
+  tree.SetContent("Content that is too long for the small string optimization");
+  tree.AddAttribute("first_attribute_with_a_long_name", "value of the first attribute");
+  tree.AddAttribute(attr_name, "value of the looked up attribute");
+  const std::size_t n_lookups = 1000000;
+
+  std::size_t total = 0;
+  auto result = Measure(
+    [&]()
+    {
+      total += tree.GetNodeName().size() + tree.GetContent().size();
+      total += tree.HasAttribute(attr_name) ? tree.GetAttribute(attr_name).size() : 0;
+    }, n_lookups);
+  PrintResult("Lookup/GetNodeName+GetContent+GetAttribute", result);
+
+  result = Measure(
+    [&]()
+    {
+      total += tree.NodeName().size() + tree.Content().size();
+      auto value = tree.FindAttribute(attr_name);
+      total += value != nullptr ? value->size() : 0;
+    }, n_lookups);
+  PrintResult("Lookup/NodeName+Content+FindAttribute", result);
+  std::printf("(checksum %zu)\n", total);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "benchmark_helper.h"
+#include "benchmarks.h"
+
+#include <sup/xml/tree_data_parser_utils.h>
+#include <sup/xml/tree_data_traversal.h>
+
+#include <libxml/parser.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Time only the conversion of an already parsed libxml2 document into TreeData.
+ *
+ * @note XML_PARSE_HUGE lifts libxml2's default nesting limit of 256 levels, which the public
+ * parse functions keep.
+ */
+sup::benchmark::BenchmarkResult MeasureWalk(const std::string& xml_str, std::size_t repetitions);
+
+/**
+ * @brief Time the traversal, copy and destruction of a tree.
+ */
+void MeasureTraversal(const std::string& name, const sup::xml::TreeData& tree);
+}  // unnamed namespace
+
+namespace sup
+{
+namespace benchmark
+{
+
+void RunWalkBenchmarks()
+{
+  const auto wide = GenerateWideDocument(100000);
+  PrintResult("ParseXMLDoc/wide(100k)", MeasureWalk(wide, 3), wide.size());
+  const auto deep = GenerateDeepDocument(10000);
+  PrintResult("ParseXMLDoc/deep(10k)", MeasureWalk(deep, 3), deep.size());
+
+  xml::TreeData wide_tree{"Root"};
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    wide_tree.EmplaceChild("Child").AddAttribute("index", std::to_string(i));
+  }
+  MeasureTraversal("wide(100k)", wide_tree);
+  xml::TreeData deep_tree{"Level"};
+  xml::TreeData* current = &deep_tree;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+    current->AddAttribute("index", std::to_string(i));
+  }
+  MeasureTraversal("deep(100k)", deep_tree);
+}
+
+}  // namespace benchmark
+
+}  // namespace sup
+
+namespace
+{
+sup::benchmark::BenchmarkResult MeasureWalk(const std::string& xml_str, std::size_t repetitions)
+{
+  sup::benchmark::BenchmarkResult total{0.0, 0.0};
+  for (std::size_t i = 0; i < repetitions; ++i)
+  {
+    auto doc = xmlReadMemory(xml_str.data(), static_cast<int>(xml_str.size()), nullptr, nullptr,
+                             XML_PARSE_NOBLANKS | XML_PARSE_HUGE);
+    auto result = sup::benchmark::Measure([doc]() { (void)sup::xml::ParseXMLDoc(doc); }, 1);
+    total.seconds += result.seconds / repetitions;
+    total.allocations += result.allocations / repetitions;
+  }
+  return total;
+}
+
+void MeasureTraversal(const std::string& name, const sup::xml::TreeData& tree)
+{
+  using namespace sup::xml;
+  std::size_t count = 0;
+  auto result = sup::benchmark::Measure(
+    [&tree, &count]()
+    {
+      for (auto it = TreeDataPreOrderIterator{tree}; it != TreeDataPreOrderIterator{}; ++it)
+      {
+        count += it->GetNumberOfAttributes();
+      }
+    }, 10);
+  sup::benchmark::PrintResult("PreOrder/" + name, result);
+  result = sup::benchmark::Measure(
+    [&tree, &count]()
+    {
+      for (const auto& node : PostOrder(tree))
+      {
+        count += node.GetNumberOfAttributes();
+      }
+    }, 10);
+  sup::benchmark::PrintResult("PostOrder/" + name, result);
+  result = sup::benchmark::Measure(
+    [&tree, &count]()
+    {
+      (void)Visit(tree, [&count](const TreeData& node, std::size_t)
+                  {
+                    count += node.GetNumberOfAttributes();
+                    return VisitAction::kContinue;
+                  });
+    }, 10);
+  sup::benchmark::PrintResult("Visit/" + name, result);
+  std::vector<TreeData> copies;
+  copies.reserve(10);
+  result = sup::benchmark::Measure([&tree, &copies]() { copies.push_back(tree); }, 10);
+  sup::benchmark::PrintResult("Copy/" + name, result);
+  result = sup::benchmark::Measure([&copies]() { copies.pop_back(); }, 10);
+  sup::benchmark::PrintResult("Destroy/" + name, result);
+  std::printf("(checksum %zu)\n", count);
+}
+}  // unnamed namespace
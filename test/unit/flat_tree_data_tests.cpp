@@ -0,0 +1,191 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "unit_test_helper.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/flat_tree_data.h>
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_serialize.h>
+
+#include <gtest/gtest.h>
+
+using namespace sup::xml;
+
+static const std::string XML_BODY = R"RAW(
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <PhoneNumber>12345</PhoneNumber>
+    <Details country="FR" membership="gold"/>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW";
+
+class FlatTreeDataTest : public ::testing::Test
+{
+protected:
+  FlatTreeDataTest();
+  virtual ~FlatTreeDataTest();
+
+  std::string AddXMLHeader(const std::string& body);
+};
+
+TEST_F(FlatTreeDataTest, Construction)
+{
+  FlatTreeData tree{"Root"};
+  EXPECT_EQ(tree.GetNumberOfNodes(), 1);
+  auto root = tree.Root();
+  EXPECT_EQ(tree.GetNodeName(root), "Root");
+  EXPECT_TRUE(tree.GetContent(root).empty());
+  EXPECT_EQ(tree.GetNumberOfAttributes(root), 0);
+  EXPECT_EQ(tree.GetNumberOfChildren(root), 0);
+  EXPECT_EQ(tree.Parent(root), FlatTreeData::kInvalidNode);
+  EXPECT_EQ(tree.FirstChild(root), FlatTreeData::kInvalidNode);
+  EXPECT_EQ(tree.NextSibling(root), FlatTreeData::kInvalidNode);
+  EXPECT_THROW(tree.GetNodeName(1), InvalidOperationException);
+}
+
+TEST_F(FlatTreeDataTest, Build)
+{
+  FlatTreeData tree{"Root"};
+  auto root = tree.Root();
+  tree.AddAttribute(root, "name", "root");
+  EXPECT_THROW(tree.AddAttribute(root, "name", "other"), InvalidOperationException);
+  auto child_1 = tree.AddChild(root, "Child");
+  tree.AddAttribute(child_1, "id", "1");
+  auto child_2 = tree.AddChild(root, "Child");
+  tree.SetContent(child_2, "content");
+  auto grandchild = tree.AddChild(child_1, "GrandChild");
+  EXPECT_THROW(tree.AddAttribute(child_1, "late", "attribute"), InvalidOperationException);
+  EXPECT_THROW(tree.AddChild(42, "Child"), InvalidOperationException);
+
+  EXPECT_EQ(tree.GetNumberOfNodes(), 4);
+  EXPECT_EQ(tree.GetNumberOfChildren(root), 2);
+  EXPECT_EQ(tree.FirstChild(root), child_1);
+  EXPECT_EQ(tree.NextSibling(child_1), child_2);
+  EXPECT_EQ(tree.NextSibling(child_2), FlatTreeData::kInvalidNode);
+  EXPECT_EQ(tree.FirstChild(child_1), grandchild);
+  EXPECT_EQ(tree.Parent(grandchild), child_1);
+  EXPECT_EQ(tree.GetAttribute(root, "name"), "root");
+  EXPECT_EQ(tree.GetAttributeName(child_1, 0), "id");
+  EXPECT_EQ(tree.GetAttributeValue(child_1, 0), "1");
+  EXPECT_THROW(tree.GetAttributeName(child_1, 1), InvalidOperationException);
+  EXPECT_THROW(tree.GetAttribute(child_1, "name"), InvalidOperationException);
+  EXPECT_FALSE(tree.HasAttribute(child_2, "id"));
+  EXPECT_EQ(tree.GetContent(child_2), "content");
+}
+
+TEST_F(FlatTreeDataTest, Conversion)
+{
+  auto tree = TreeDataFromString(AddXMLHeader(XML_BODY));
+  ASSERT_TRUE(static_cast<bool>(tree));
+  auto flat_tree = FlatTreeDataFromTreeData(*tree);
+  EXPECT_EQ(flat_tree.GetNumberOfNodes(), 8);
+  EXPECT_EQ(TreeDataFromFlatTreeData(flat_tree), *tree);
+
+  // Equality does not depend on the order in which nodes were added
+  FlatTreeData tree_1{"Root"};
+  auto a_1 = tree_1.AddChild(tree_1.Root(), "A");
+  (void)tree_1.AddChild(tree_1.Root(), "B");
+  (void)tree_1.AddChild(a_1, "C");
+  FlatTreeData tree_2{"Root"};
+  auto a_2 = tree_2.AddChild(tree_2.Root(), "A");
+  (void)tree_2.AddChild(a_2, "C");
+  (void)tree_2.AddChild(tree_2.Root(), "B");
+  EXPECT_EQ(tree_1, tree_2);
+  (void)tree_2.AddChild(a_2, "D");
+  EXPECT_NE(tree_1, tree_2);
+}
+
+TEST_F(FlatTreeDataTest, Parse)
+{
+  auto xml_str = AddXMLHeader(XML_BODY);
+  auto tree = TreeDataFromString(xml_str);
+  ASSERT_TRUE(static_cast<bool>(tree));
+  auto flat_tree = FlatTreeDataFromString(xml_str);
+  EXPECT_EQ(TreeDataFromFlatTreeData(flat_tree), *tree);
+  EXPECT_EQ(flat_tree, FlatTreeDataFromTreeData(*tree));
+
+  const std::string filename = "FlatTreeDataTest_Parse";
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
+  EXPECT_EQ(FlatTreeDataFromFile(filename), flat_tree);
+
+  EXPECT_THROW(FlatTreeDataFromFile("does_not_exist.xml"), ParseException);
+  EXPECT_THROW(FlatTreeDataFromString("<Unclosed>"), ParseException);
+}
+
+TEST_F(FlatTreeDataTest, Serialize)
+{
+  auto xml_str = AddXMLHeader(XML_BODY);
+  auto tree = TreeDataFromString(xml_str);
+  ASSERT_TRUE(static_cast<bool>(tree));
+  auto flat_tree = FlatTreeDataFromTreeData(*tree);
+  EXPECT_EQ(TreeDataToString(flat_tree), TreeDataToString(*tree));
+
+  FlatTreeData unnamed{""};
+  EXPECT_THROW(TreeDataToString(unnamed), SerializeException);
+}
+
+TEST_F(FlatTreeDataTest, OverwriteContent)
+{
+  FlatTreeData tree{"Root"};
+  auto root = tree.Root();
+  auto child = tree.AddChild(root, "Child");
+  tree.SetContent(child, "content");
+  EXPECT_EQ(tree.GetContent(child), "content");
+  tree.SetContent(child, "short");
+  EXPECT_EQ(tree.GetContent(child), "short");
+  tree.SetContent(child, "much longer content");
+  EXPECT_EQ(tree.GetContent(child), "much longer content");
+  tree.SetContent(child, tree.GetContent(child).substr(5));
+  EXPECT_EQ(tree.GetContent(child), "longer content");
+  tree.SetContent(child, "");
+  EXPECT_TRUE(tree.GetContent(child).empty());
+  EXPECT_TRUE(tree.GetContent(root).empty());
+  EXPECT_THROW(tree.SetContent(42, "content"), InvalidOperationException);
+
+  // Overwriting with content that fits does not grow the character arena
+  tree.SetContent(child, std::string(1024, 'x'));
+  const auto allocated_before = sup::unit_test_helper::AllocatedHeapBytes();
+  for (int i = 0; i < 10000; ++i)
+  {
+    tree.SetContent(child, std::string(1000 + i % 24, 'a' + i % 26));
+  }
+  const auto allocated_after = sup::unit_test_helper::AllocatedHeapBytes();
+  EXPECT_LT(allocated_after, allocated_before + 64 * 1024);
+  EXPECT_EQ(tree.GetContent(child), std::string(1000 + 9999 % 24, 'a' + 9999 % 26));
+}
+
+FlatTreeDataTest::FlatTreeDataTest() = default;
+
+FlatTreeDataTest::~FlatTreeDataTest() = default;
+
+std::string FlatTreeDataTest::AddXMLHeader(const std::string& body)
+{
+  static const std::string header{R"RAW(<?xml version="1.0" encoding="UTF-8"?>)RAW"};
+  return header + body;
+}
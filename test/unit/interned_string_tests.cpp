@@ -0,0 +1,246 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "unit_test_helper.h"
+
+#include <sup/xml/interned_string.h>
+#include <sup/xml/tree_data.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace sup::xml;
+
+//! Fill the interning table and check the handles of strings that do not fit anymore. Exits with
+//! a non-zero code on failure.
+static void CheckTableLimit();
+
+class InternedStringTest : public ::testing::Test
+{
+protected:
+  InternedStringTest();
+  virtual ~InternedStringTest();
+};
+
+TEST_F(InternedStringTest, Construction)
+{
+  InternedString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_EQ(empty, InternedString{""});
+
+  const std::string name = "InternedStringTest_Construction";
+  InternedString from_std_string{name};
+  InternedString from_c_string{name.c_str()};
+  InternedString from_view{std::string_view{name}};
+  EXPECT_EQ(from_std_string.Handle(), from_c_string.Handle());
+  EXPECT_EQ(from_std_string.Handle(), from_view.Handle());
+  EXPECT_EQ(from_std_string.Str(), name);
+  EXPECT_EQ(from_std_string.size(), name.size());
+  EXPECT_STREQ(from_std_string.c_str(), name.c_str());
+
+  InternedString copy{from_std_string};
+  EXPECT_EQ(copy, from_std_string);
+  copy = empty;
+  EXPECT_EQ(copy, empty);
+  EXPECT_NE(copy, from_std_string);
+}
+
+TEST_F(InternedStringTest, Comparison)
+{
+  InternedString first{"first"};
+  InternedString second{"second"};
+  EXPECT_EQ(first, "first");
+  EXPECT_EQ("first", first);
+  EXPECT_EQ(first, std::string{"first"});
+  EXPECT_EQ(std::string{"first"}, first);
+  EXPECT_NE(first, second);
+  EXPECT_NE(first, "second");
+  EXPECT_NE("second", first);
+  EXPECT_NE(first, std::string{"second"});
+  EXPECT_NE(std::string{"second"}, first);
+
+  std::ostringstream oss;
+  oss << first;
+  EXPECT_EQ(oss.str(), "first");
+
+  EXPECT_EQ(first + second, "firstsecond");
+  EXPECT_EQ(first + "_suffix", "first_suffix");
+  EXPECT_EQ("prefix_" + first, "prefix_first");
+  EXPECT_EQ(first + std::string{"_suffix"}, "first_suffix");
+  EXPECT_EQ(std::string{"prefix_"} + first, "prefix_first");
+}
+
+TEST_F(InternedStringTest, Find)
+{
+  InternedString result;
+  EXPECT_FALSE(InternedString::Find("InternedStringTest_Find", result));
+  EXPECT_TRUE(result.empty());
+  InternedString interned{"InternedStringTest_Find"};
+  EXPECT_TRUE(InternedString::Find("InternedStringTest_Find", result));
+  EXPECT_EQ(result, interned);
+}
+
+TEST_F(InternedStringTest, ManyStrings)
+{
+  // More strings than the per-thread cache holds: handles stay the same after it was cleared
+  std::vector<InternedString> interned;
+  for (int i = 0; i < 10000; ++i)
+  {
+    interned.emplace_back("InternedStringTest_ManyStrings_" + std::to_string(i));
+  }
+  for (int i = 0; i < 10000; ++i)
+  {
+    const auto name = "InternedStringTest_ManyStrings_" + std::to_string(i);
+    InternedString found;
+    ASSERT_TRUE(InternedString::Find(name, found));
+    EXPECT_EQ(found.Handle(), interned[i].Handle());
+    EXPECT_EQ(InternedString{name}.Handle(), interned[i].Handle());
+  }
+}
+
+TEST_F(InternedStringTest, Concurrency)
+{
+  const std::size_t n_threads = 8;
+  const std::size_t n_names = 100;
+  std::vector<std::vector<const std::string*>> handles(n_threads);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < n_threads; ++i)
+  {
+    threads.emplace_back([i, n_names, &handles]()
+                         {
+                           for (std::size_t j = 0; j < n_names; ++j)
+                           {
+                             InternedString str{"Concurrency_" + std::to_string(j)};
+                             handles[i].push_back(str.Handle());
+                           }
+                         });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (std::size_t i = 1; i < n_threads; ++i)
+  {
+    EXPECT_EQ(handles[i], handles[0]);
+  }
+}
+
+TEST_F(InternedStringTest, TableLimit)
+{
+  // Filling the table affects the whole process, so it is done in a child process
+  EXPECT_EXIT(CheckTableLimit(), ::testing::ExitedWithCode(0), "");
+}
+
+static void CheckTableLimit()
+{
+  const InternedString early{"InternedStringTest_TableLimit"};
+  auto long_name = [](const std::string& prefix, std::size_t idx)
+  {
+    auto result = prefix + std::to_string(idx) + "_";
+    result.resize(4096, 'x');
+    return result;
+  };
+  std::vector<InternedString> filled;
+  for (std::size_t i = 0; i < InternedString::kMaxInternedBytes / 4096; ++i)
+  {
+    filled.emplace_back(long_name("fill_", i));
+    if (!filled.back().IsInterned())
+    {
+      break;
+    }
+  }
+  EXPECT_FALSE(filled.back().IsInterned());
+
+  // Strings interned before remain so
+  const InternedString early_again{"InternedStringTest_TableLimit"};
+  EXPECT_TRUE(early_again.IsInterned());
+  EXPECT_EQ(early_again.Handle(), early.Handle());
+
+  // Handles to equal strings that did not fit are equal, but do not share the string
+  const auto name = long_name("owned_", 0);
+  const InternedString owned{name};
+  const InternedString owned_again{name};
+  EXPECT_FALSE(owned.IsInterned());
+  EXPECT_EQ(owned, owned_again);
+  EXPECT_NE(owned.Handle(), owned_again.Handle());
+  EXPECT_EQ(owned.Hash(), owned_again.Hash());
+  EXPECT_EQ(owned, name);
+  EXPECT_NE(owned, InternedString{long_name("owned_", 1)});
+  EXPECT_NE(owned, early);
+  EXPECT_FALSE(InternedStringOrder{}(owned, owned_again));
+  EXPECT_FALSE(InternedStringOrder{}(owned_again, owned));
+  InternedString found;
+  EXPECT_TRUE(InternedString::Find(name, found));
+  EXPECT_EQ(found, owned);
+
+  // Copies and assignments
+  InternedString copy{owned};
+  EXPECT_EQ(copy.Handle(), owned.Handle());
+  copy = early;
+  EXPECT_EQ(copy, early);
+  copy = owned_again;
+  EXPECT_EQ(copy.Handle(), owned_again.Handle());
+  InternedString moved{std::move(copy)};
+  EXPECT_EQ(moved, owned);
+  EXPECT_TRUE(copy.empty());
+
+  // Trees with names that did not fit
+  sup::xml::TreeData tree{long_name("root_", 0)};
+  sup::xml::TreeData reordered{long_name("root_", 0)};
+  const std::size_t n_names = 40;
+  for (std::size_t i = 0; i < n_names; ++i)
+  {
+    tree.AddAttribute(long_name("attr_", i), std::to_string(i));
+    reordered.AddAttribute(long_name("attr_", n_names - 1 - i), std::to_string(n_names - 1 - i));
+    tree.AddChild(sup::xml::TreeData{long_name("child_", i)});
+    reordered.AddChild(sup::xml::TreeData{long_name("child_", i)});
+  }
+  EXPECT_EQ(tree, reordered);
+  EXPECT_EQ(sup::xml::Hash(tree), sup::xml::Hash(reordered));
+  EXPECT_TRUE(tree.HasAttribute(long_name("attr_", 7)));
+  EXPECT_EQ(tree.GetAttribute(long_name("attr_", 7)), "7");
+  const auto child = tree.FindChild(long_name("child_", n_names - 1));
+  ASSERT_NE(child, nullptr);
+  EXPECT_EQ(child, &tree.Children().back());
+  EXPECT_EQ(tree.FindChild(long_name("child_", n_names)), nullptr);
+
+  // Strings that did not fit are released with their handles
+  const auto allocated_before = sup::unit_test_helper::AllocatedHeapBytes();
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    const InternedString transient{long_name("transient_", i)};
+    EXPECT_FALSE(transient.IsInterned());
+  }
+  const auto allocated_after = sup::unit_test_helper::AllocatedHeapBytes();
+  EXPECT_LT(allocated_after, allocated_before + 64 * 1024);
+
+  std::exit(::testing::Test::HasFailure() ? 1 : 0);
+}
+
+InternedStringTest::InternedStringTest() = default;
+
+InternedStringTest::~InternedStringTest() = default;
@@ -0,0 +1,244 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/persistent_tree_data.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <gtest/gtest.h>
+
+using namespace sup::xml;
+
+class PersistentTreeDataTest : public ::testing::Test
+{
+protected:
+  PersistentTreeDataTest();
+  virtual ~PersistentTreeDataTest();
+
+  std::unique_ptr<TreeData> m_tree;
+};
+
+TEST_F(PersistentTreeDataTest, Construction)
+{
+  PersistentTreeData node{"Node"};
+  EXPECT_EQ(node.GetNodeName(), "Node");
+  EXPECT_EQ(node.NodeName(), "Node");
+  EXPECT_EQ(node.GetInternedNodeName(), InternedString{"Node"});
+  EXPECT_EQ(node.GetNumberOfAttributes(), 0);
+  EXPECT_EQ(node.GetNumberOfChildren(), 0);
+  EXPECT_TRUE(node.GetContent().empty());
+
+  node.AddAttribute("name", "value");
+  EXPECT_THROW(node.AddAttribute("name", "other"), InvalidOperationException);
+  EXPECT_TRUE(node.HasAttribute("name"));
+  EXPECT_TRUE(node.HasAttribute(InternedString{"name"}));
+  EXPECT_FALSE(node.HasAttribute("other"));
+  EXPECT_EQ(node.GetAttribute("name"), "value");
+  EXPECT_THROW(node.GetAttribute("other"), InvalidOperationException);
+  EXPECT_EQ(node.FindAttribute("other"), nullptr);
+  node.SetAttribute("name", "changed");
+  node.SetAttribute("other", "new");
+  EXPECT_EQ(node.GetAttribute("name"), "changed");
+  EXPECT_EQ(node.GetAttribute("other"), "new");
+  EXPECT_EQ(node.GetNumberOfAttributes(), 2);
+
+  node.SetContent("text");
+  EXPECT_EQ(node.Content(), "text");
+  node.EmplaceChild("Child");
+  node.UpdateChild(0, [](PersistentTreeData& child) { child.SetContent("child text"); });
+  node.AddChild(PersistentTreeData{"Other"});
+  EXPECT_EQ(node.GetNumberOfChildren(), 2);
+  EXPECT_EQ(node.Children()[0].Content(), "child text");
+  EXPECT_THROW(node.UpdateChild(2, [](PersistentTreeData&) {}), InvalidOperationException);
+  EXPECT_THROW(node.UpdateNode({0, 0}, [](PersistentTreeData&) {}), InvalidOperationException);
+  EXPECT_THROW(node.RemoveChild(2), InvalidOperationException);
+  node.RemoveChild(0);
+  ASSERT_EQ(node.GetNumberOfChildren(), 1);
+  EXPECT_EQ(node.Children()[0].GetNodeName(), "Other");
+}
+
+TEST_F(PersistentTreeDataTest, Conversion)
+{
+  PersistentTreeData persistent{*m_tree};
+  EXPECT_EQ(persistent.GetNodeName(), "MemberList");
+  EXPECT_EQ(persistent.GetNumberOfChildren(), m_tree->GetNumberOfChildren());
+  EXPECT_EQ(persistent.ToTreeData(), *m_tree);
+  EXPECT_EQ(persistent, PersistentTreeData{*m_tree});
+  EXPECT_NE(persistent, PersistentTreeData{"MemberList"});
+}
+
+TEST_F(PersistentTreeDataTest, CopyOnWrite)
+{
+  const PersistentTreeData original{*m_tree};
+  auto copy = original;
+  EXPECT_TRUE(copy.SharesNodeWith(original));
+  EXPECT_EQ(copy, original);
+
+  // Modify one leaf: only the path to the root is copied
+  copy.UpdateNode({1, 0}, [](PersistentTreeData& name) { name.SetContent("Anna Smith"); });
+  EXPECT_FALSE(copy.SharesNodeWith(original));
+  EXPECT_FALSE(copy.Children()[1].SharesNodeWith(original.Children()[1]));
+  EXPECT_TRUE(copy.Children()[0].SharesNodeWith(original.Children()[0]));
+  EXPECT_TRUE(copy.Children()[1].Children()[1].SharesNodeWith(original.Children()[1].Children()[1]));
+  EXPECT_EQ(copy.Children()[1].Children()[0].Content(), "Anna Smith");
+  EXPECT_EQ(original.Children()[1].Children()[0].Content(), "Anna");
+  EXPECT_EQ(original.ToTreeData(), *m_tree);
+  EXPECT_NE(copy, original);
+
+  // Unshared nodes are modified in place
+  const auto* member = &copy.Children()[1];
+  copy.UpdateChild(1, [](PersistentTreeData& child) { child.SetAttribute("key", "24"); });
+  EXPECT_EQ(&copy.Children()[1], member);
+  EXPECT_EQ(original.Children()[1].GetAttribute("key"), "23");
+
+  // Replacing and removing children
+  copy.UpdateChild(0, [&original](PersistentTreeData& child) { child = original.Children()[1]; });
+  EXPECT_TRUE(copy.Children()[0].SharesNodeWith(original.Children()[1]));
+  copy.RemoveChild(1);
+  EXPECT_EQ(copy.GetNumberOfChildren(), 1);
+  EXPECT_EQ(original.GetNumberOfChildren(), 2);
+  EXPECT_EQ(original.ToTreeData(), *m_tree);
+
+  // Assigning a subtree of itself
+  copy = copy.Children()[0];
+  EXPECT_TRUE(copy.SharesNodeWith(original.Children()[1]));
+}
+
+TEST_F(PersistentTreeDataTest, SnapshotAfterUpdate)
+{
+  PersistentTreeData root{"Root"};
+  root.EmplaceChild("Child");
+  root.UpdateChild(0, [](PersistentTreeData& child) { child.SetContent("initial"); });
+  const auto snapshot = root;
+  root.UpdateChild(0, [](PersistentTreeData& child) { child.SetContent("changed"); });
+  EXPECT_EQ(snapshot.Children()[0].GetContent(), "initial");
+  EXPECT_EQ(root.Children()[0].GetContent(), "changed");
+
+  root.EmplaceChild("Other");
+  const auto second_snapshot = root;
+  root.UpdateChild(1, [](PersistentTreeData& child) { child.AddAttribute("name", "value"); });
+  EXPECT_EQ(second_snapshot.Children()[1].GetNumberOfAttributes(), 0);
+  EXPECT_EQ(root.Children()[1].GetAttribute("name"), "value");
+  EXPECT_EQ(snapshot.GetNumberOfChildren(), 1);
+}
+
+TEST_F(PersistentTreeDataTest, AttributeOrder)
+{
+  PersistentTreeData left{"Node"};
+  left.AddAttribute("a", "1");
+  left.AddAttribute("b", "2");
+  PersistentTreeData right{"Node"};
+  right.AddAttribute("b", "2");
+  right.AddAttribute("a", "1");
+  EXPECT_EQ(left, right);
+  right.SetAttribute("a", "3");
+  EXPECT_NE(left, right);
+}
+
+TEST_F(PersistentTreeDataTest, ShareIdenticalSubtrees)
+{
+  TreeData tree{"Channels"};
+  for (int i = 0; i < 100; ++i)
+  {
+    auto& channel = tree.EmplaceChild("Channel");
+    channel.AddAttribute("type", i % 2 == 0 ? "float64" : "uint32");
+    auto& limits = channel.EmplaceChild("Limits");
+    limits.AddAttribute("low", "0");
+    limits.AddAttribute("high", "10");
+  }
+  // One channel that differs in attribute order only is stored separately
+  auto& reordered = tree.EmplaceChild("Channel");
+  reordered.AddAttribute("type", "uint32");
+  auto& limits = reordered.EmplaceChild("Limits");
+  limits.AddAttribute("high", "10");
+  limits.AddAttribute("low", "0");
+
+  auto shared = ShareIdenticalSubtrees(tree);
+  EXPECT_EQ(shared.ToTreeData(), tree);
+  EXPECT_EQ(shared.CountNodes(), 203);
+  // Root, two channel variants, one reordered channel, two limits variants
+  EXPECT_EQ(shared.CountDistinctNodes(), 6);
+  EXPECT_TRUE(shared.Children()[0].SharesNodeWith(shared.Children()[98]));
+  EXPECT_TRUE(shared.Children()[1].Children()[0].SharesNodeWith(
+    shared.Children()[2].Children()[0]));
+  EXPECT_FALSE(shared.Children()[1].SharesNodeWith(shared.Children()[100]));
+
+  // Copy on write still applies to shared subtrees
+  auto modified = shared;
+  modified.UpdateNode({4, 0}, [](PersistentTreeData& limits) { limits.SetAttribute("high", "20"); });
+  EXPECT_EQ(shared.ToTreeData(), tree);
+  EXPECT_EQ(modified.Children()[4].Children()[0].GetAttribute("high"), "20");
+  EXPECT_EQ(modified.Children()[6].Children()[0].GetAttribute("high"), "10");
+  // New root, channel and limits; the old root is no longer part of the tree
+  EXPECT_EQ(modified.CountDistinctNodes(), 8);
+
+  // Sharing the modified tree again finds nothing new to join
+  auto reshared = ShareIdenticalSubtrees(modified);
+  EXPECT_EQ(reshared, modified);
+  EXPECT_EQ(reshared.CountDistinctNodes(), 8);
+  EXPECT_EQ(ShareIdenticalSubtrees(PersistentTreeData{tree}).CountDistinctNodes(), 6);
+}
+
+TEST_F(PersistentTreeDataTest, DeepTree)
+{
+  const std::size_t depth = 200000;
+  TreeData tree{"Node"};
+  TreeData* current = &tree;
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    current = &current->EmplaceChild("Node");
+  }
+  current->SetContent("leaf");
+  {
+    const PersistentTreeData persistent{tree};
+    auto version = persistent;
+    version.UpdateNode(std::vector<std::size_t>(depth, 0),
+                       [](PersistentTreeData& leaf) { leaf.SetContent("changed"); });
+    EXPECT_NE(version, persistent);
+    EXPECT_EQ(persistent, PersistentTreeData{persistent.ToTreeData()});
+    tree = version.ToTreeData();
+  }
+  const TreeData* node = &tree;
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    ASSERT_EQ(node->GetNumberOfChildren(), 1);
+    node = &node->Children()[0];
+  }
+  EXPECT_EQ(node->Content(), "changed");
+}
+
+PersistentTreeDataTest::PersistentTreeDataTest()
+  : m_tree{TreeDataFromString(R"RAW(
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <Details country="FR" membership="gold"/>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW")}
+{}
+
+PersistentTreeDataTest::~PersistentTreeDataTest() = default;
@@ -0,0 +1,263 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "unit_test_helper.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/pmr_tree_data.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <new>
+
+using namespace sup::xml;
+
+/**
+ * @brief Memory resource that counts the allocations it passes on to its upstream resource.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  CountingResource() = default;
+
+  std::size_t m_allocations = 0;
+  std::size_t m_live_bytes = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+static const std::string XML_CONTENTS = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson with a name too long for the small string buffer</Name>
+    <PhoneNumber>12345</PhoneNumber>
+    <Details country="FR" membership="gold"/>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW";
+
+class PmrTreeDataTest : public ::testing::Test
+{
+protected:
+  PmrTreeDataTest();
+  virtual ~PmrTreeDataTest();
+
+  //! Check that a node and all of its descendants use the given resource.
+  static bool UsesResource(const PmrTreeData& tree, std::pmr::memory_resource* resource);
+
+  CountingResource m_resource;
+};
+
+TEST_F(PmrTreeDataTest, Construction)
+{
+  PmrTreeData tree{"Node", &m_resource};
+  EXPECT_EQ(tree.GetNodeName(), "Node");
+  EXPECT_EQ(tree.NodeName(), "Node");
+  EXPECT_EQ(tree.get_allocator().resource(), &m_resource);
+  tree.AddAttribute("name", "a value that does not fit in the small string buffer");
+  EXPECT_THROW(tree.AddAttribute("name", "other"), InvalidOperationException);
+  EXPECT_TRUE(tree.HasAttribute("name"));
+  EXPECT_TRUE(tree.HasAttribute(InternedString{"name"}));
+  EXPECT_FALSE(tree.HasAttribute("other"));
+  EXPECT_EQ(tree.GetAttribute("name"), "a value that does not fit in the small string buffer");
+  EXPECT_THROW(tree.GetAttribute("other"), InvalidOperationException);
+  EXPECT_EQ(tree.FindAttribute("other"), nullptr);
+  tree.SetContent("content");
+  EXPECT_EQ(tree.Content(), "content");
+
+  auto& child = tree.EmplaceChild("Child");
+  child.AddAttribute("key", "1");
+  // Children added from elsewhere are copied or moved into the resource of the parent
+  PmrTreeData other{"Other"};
+  other.EmplaceChild("Grandchild").SetContent("text");
+  tree.AddChild(other);
+  tree.AddChild(std::move(other));
+  ASSERT_EQ(tree.GetNumberOfChildren(), 3);
+  EXPECT_EQ(tree.Children()[2].Children()[0].Content(), "text");
+  EXPECT_TRUE(UsesResource(tree, &m_resource));
+  EXPECT_GT(m_resource.m_allocations, 0);
+}
+
+TEST_F(PmrTreeDataTest, Parse)
+{
+  const auto expected = TreeDataFromString(XML_CONTENTS);
+  {
+    auto tree = PmrTreeDataFromString(XML_CONTENTS, &m_resource);
+    EXPECT_EQ(tree.ToTreeData(), *expected);
+    EXPECT_TRUE(UsesResource(tree, &m_resource));
+    EXPECT_EQ(tree.Children()[0].GetAttribute("key"), "433");
+  }
+  EXPECT_EQ(m_resource.m_live_bytes, 0);
+
+  auto tree = PmrTreeDataFromMemory(XML_CONTENTS.data(), XML_CONTENTS.size(), &m_resource);
+  EXPECT_EQ(tree.ToTreeData(), *expected);
+  const std::string filename = "pmr_tree_data_test.xml";
+  sup::unit_test_helper::TemporaryTestFile xml_file{filename, XML_CONTENTS};
+  tree = PmrTreeDataFromFile(filename, &m_resource);
+  EXPECT_EQ(tree.ToTreeData(), *expected);
+  // The default resource is used when none is given
+  EXPECT_EQ(PmrTreeDataFromString(XML_CONTENTS).get_allocator().resource(),
+            std::pmr::get_default_resource());
+
+  EXPECT_THROW(PmrTreeDataFromString("<MemberList>", &m_resource), ParseException);
+  EXPECT_THROW(PmrTreeDataFromMemory(nullptr, 0, &m_resource), ParseException);
+  EXPECT_THROW(PmrTreeDataFromFile("pmr_tree_data_missing.xml", &m_resource), ParseException);
+  EXPECT_THROW(PmrTreeDataFromString(XML_CONTENTS, std::pmr::null_memory_resource()),
+               std::bad_alloc);
+}
+
+TEST_F(PmrTreeDataTest, Arena)
+{
+  // Nothing of the tree may come from the default resource
+  auto previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  std::pmr::monotonic_buffer_resource arena{&m_resource};
+  try
+  {
+    auto tree = PmrTreeDataFromString(XML_CONTENTS, &arena);
+    auto copy = PmrTreeData{tree, &arena};
+    copy.EmplaceChild("Member").AddAttribute("key", "1");
+    EXPECT_EQ(copy.GetNumberOfChildren(), 3);
+  }
+  catch (const std::bad_alloc&)
+  {
+    ADD_FAILURE() << "Allocation from the default resource";
+  }
+  (void)std::pmr::set_default_resource(previous);
+  // The monotonic arena only returns memory to its upstream on release
+  EXPECT_GT(m_resource.m_live_bytes, 0);
+  const auto allocations = m_resource.m_allocations;
+  arena.release();
+  EXPECT_EQ(m_resource.m_live_bytes, 0);
+  EXPECT_EQ(m_resource.m_allocations, allocations);
+}
+
+TEST_F(PmrTreeDataTest, CopyAndMove)
+{
+  const auto expected = TreeDataFromString(XML_CONTENTS);
+  const PmrTreeData tree{*expected, &m_resource};
+  EXPECT_EQ(tree.ToTreeData(), *expected);
+  EXPECT_TRUE(UsesResource(tree, &m_resource));
+
+  // Copies without an allocator use the default resource
+  PmrTreeData copy{tree};
+  EXPECT_TRUE(UsesResource(copy, std::pmr::get_default_resource()));
+  EXPECT_EQ(copy.ToTreeData(), *expected);
+
+  // Moves keep the resource, unless another one is given
+  PmrTreeData moved{std::move(copy)};
+  EXPECT_TRUE(UsesResource(moved, std::pmr::get_default_resource()));
+  PmrTreeData moved_to_resource{std::move(moved), &m_resource};
+  EXPECT_TRUE(UsesResource(moved_to_resource, &m_resource));
+  EXPECT_EQ(moved_to_resource.ToTreeData(), *expected);
+
+  // Assignment keeps the resource of the target
+  PmrTreeData assigned{"Other"};
+  assigned = tree;
+  EXPECT_TRUE(UsesResource(assigned, std::pmr::get_default_resource()));
+  EXPECT_EQ(assigned.ToTreeData(), *expected);
+  assigned = assigned.Children()[1];
+  EXPECT_EQ(assigned.ToTreeData(), expected->Children()[1]);
+  moved_to_resource = std::move(assigned);
+  EXPECT_TRUE(UsesResource(moved_to_resource, &m_resource));
+  EXPECT_EQ(moved_to_resource.ToTreeData(), expected->Children()[1]);
+}
+
+TEST_F(PmrTreeDataTest, DeepTree)
+{
+  const std::size_t depth = 200000;
+  std::pmr::monotonic_buffer_resource arena;
+  {
+    PmrTreeData tree{"Node", &arena};
+    auto* current = &tree;
+    for (std::size_t i = 0; i < depth; ++i)
+    {
+      current = &current->EmplaceChild("Node");
+    }
+    current->SetContent("leaf");
+    PmrTreeData copy{tree};
+    auto converted = copy.ToTreeData();
+    PmrTreeData back{converted, &arena};
+    const auto* node = &back;
+    for (std::size_t i = 0; i < depth; ++i)
+    {
+      ASSERT_EQ(node->GetNumberOfChildren(), 1);
+      node = &node->Children()[0];
+    }
+    EXPECT_EQ(node->Content(), "leaf");
+  }
+}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  ++m_allocations;
+  m_live_bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+  m_live_bytes -= bytes;
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+  return this == &other;
+}
+
+bool PmrTreeDataTest::UsesResource(const PmrTreeData& tree, std::pmr::memory_resource* resource)
+{
+  if (tree.get_allocator().resource() != resource)
+  {
+    return false;
+  }
+  for (const auto& attr : tree.Attributes())
+  {
+    if (attr.second.get_allocator().resource() != resource)
+    {
+      return false;
+    }
+  }
+  for (const auto& child : tree.Children())
+  {
+    if (!UsesResource(child, resource))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+PmrTreeDataTest::PmrTreeDataTest()
+  : m_resource{}
+{}
+
+PmrTreeDataTest::~PmrTreeDataTest() = default;
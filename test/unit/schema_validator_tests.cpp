@@ -0,0 +1,243 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "unit_test_helper.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/schema_validator.h>
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_serialize.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace sup::xml;
+
+static const std::string XSD_SCHEMA = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<xs:schema xmlns:xs="http://www.w3.org/2001/XMLSchema">
+  <xs:element name="MemberList">
+    <xs:complexType>
+      <xs:sequence>
+        <xs:element name="Member" maxOccurs="unbounded">
+          <xs:complexType>
+            <xs:sequence>
+              <xs:element name="Name" type="xs:string"/>
+            </xs:sequence>
+            <xs:attribute name="key" type="xs:unsignedInt" use="required"/>
+          </xs:complexType>
+        </xs:element>
+      </xs:sequence>
+    </xs:complexType>
+  </xs:element>
+</xs:schema>
+)RAW";
+
+static const std::string RELAX_NG_SCHEMA = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<element name="MemberList" xmlns="http://relaxng.org/ns/structure/1.0">
+  <oneOrMore>
+    <element name="Member">
+      <attribute name="key"/>
+      <element name="Name"><text/></element>
+    </element>
+  </oneOrMore>
+</element>
+)RAW";
+
+static const std::string VALID_DOCUMENT = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<MemberList>
+  <Member key="433"><Name>Martha Thompson</Name></Member>
+  <Member key="23"><Name>Anna</Name></Member>
+</MemberList>
+)RAW";
+
+static const std::string INVALID_DOCUMENT = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<MemberList>
+  <Member key="433"><Name>Martha Thompson</Name></Member>
+  <Member><Name>Anna</Name><Phone/></Member>
+</MemberList>
+)RAW";
+
+static const std::string NAMESPACED_XSD_SCHEMA = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<xs:schema xmlns:xs="http://www.w3.org/2001/XMLSchema" targetNamespace="urn:t"
+           xmlns:t="urn:t" elementFormDefault="qualified" attributeFormDefault="unqualified">
+  <xs:attribute name="unit" type="xs:string"/>
+  <xs:element name="Root">
+    <xs:complexType>
+      <xs:sequence>
+        <xs:element name="A" type="xs:string"/>
+      </xs:sequence>
+      <xs:attribute name="id" type="xs:unsignedInt"/>
+      <xs:attribute ref="t:unit"/>
+    </xs:complexType>
+  </xs:element>
+</xs:schema>
+)RAW";
+
+const std::string SCHEMA_FILENAME = "schema_validator_test.xsd";
+
+class SchemaValidatorTest : public ::testing::Test
+{
+protected:
+  SchemaValidatorTest();
+  virtual ~SchemaValidatorTest();
+};
+
+TEST_F(SchemaValidatorTest, XmlSchema)
+{
+  const SchemaValidator validator{XSD_SCHEMA, SchemaType::kXmlSchema};
+  EXPECT_EQ(validator.GetType(), SchemaType::kXmlSchema);
+  EXPECT_TRUE(validator.Validate(VALID_DOCUMENT).empty());
+  EXPECT_TRUE(validator.Validate(*TreeDataFromString(VALID_DOCUMENT)).empty());
+  // Both the missing attribute and the unexpected element are reported
+  EXPECT_EQ(validator.Validate(INVALID_DOCUMENT).size(), 2);
+  EXPECT_EQ(validator.Validate(*TreeDataFromString(INVALID_DOCUMENT)).size(), 2);
+  TreeData wrong_type{"MemberList"};
+  wrong_type.EmplaceChild("Member").AddAttribute("key", "not a number");
+  EXPECT_FALSE(validator.Validate(wrong_type).empty());
+
+  // Validation contexts are reused
+  EXPECT_TRUE(validator.Validate(VALID_DOCUMENT).empty());
+  EXPECT_THROW(validator.Validate("<MemberList>"), ParseException);
+  EXPECT_THROW(validator.Validate(""), ParseException);
+}
+
+TEST_F(SchemaValidatorTest, Namespaces)
+{
+  const SchemaValidator validator{NAMESPACED_XSD_SCHEMA, SchemaType::kXmlSchema};
+  // Default namespace
+  TreeData tree{"Root"};
+  tree.AddAttribute("xmlns", "urn:t");
+  tree.AddAttribute("id", "1");
+  tree.EmplaceChild("A").SetContent("x");
+  EXPECT_TRUE(validator.Validate(TreeDataToString(tree)).empty());
+  EXPECT_TRUE(validator.Validate(tree).empty());
+
+  // Prefixed element and attribute names, with the declaration on the root only
+  TreeData prefixed{"p:Root"};
+  prefixed.AddAttribute("xmlns:p", "urn:t");
+  prefixed.AddAttribute("p:unit", "V");
+  prefixed.EmplaceChild("p:A").SetContent("x");
+  EXPECT_TRUE(validator.Validate(TreeDataToString(prefixed)).empty());
+  EXPECT_TRUE(validator.Validate(prefixed).empty());
+
+  // Both overloads report the same errors
+  for (const auto& invalid : {TreeData{"Root"}, TreeData{"p:Root"}})
+  {
+    auto wrong = invalid;
+    wrong.AddAttribute("xmlns:p", "urn:t");
+    wrong.AddAttribute("id", "not a number");
+    wrong.EmplaceChild("A");
+    EXPECT_FALSE(validator.Validate(wrong).empty());
+    EXPECT_EQ(validator.Validate(wrong).size(),
+              validator.Validate(TreeDataToString(wrong)).size());
+  }
+}
+
+TEST_F(SchemaValidatorTest, RelaxNG)
+{
+  const SchemaValidator validator{RELAX_NG_SCHEMA, SchemaType::kRelaxNG};
+  EXPECT_EQ(validator.GetType(), SchemaType::kRelaxNG);
+  EXPECT_TRUE(validator.Validate(VALID_DOCUMENT).empty());
+  EXPECT_TRUE(validator.Validate(*TreeDataFromString(VALID_DOCUMENT)).empty());
+  EXPECT_FALSE(validator.Validate(INVALID_DOCUMENT).empty());
+  EXPECT_FALSE(validator.Validate(*TreeDataFromString(INVALID_DOCUMENT)).empty());
+  EXPECT_TRUE(validator.Validate(VALID_DOCUMENT).empty());
+}
+
+TEST_F(SchemaValidatorTest, InvalidSchema)
+{
+  EXPECT_THROW(SchemaValidator("<xs:schema", SchemaType::kXmlSchema), ParseException);
+  EXPECT_THROW(SchemaValidator(RELAX_NG_SCHEMA, SchemaType::kXmlSchema), ParseException);
+  EXPECT_THROW(SchemaValidator(XSD_SCHEMA, SchemaType::kRelaxNG), ParseException);
+  EXPECT_THROW(SchemaValidatorFromFile("does_not_exist.xsd", SchemaType::kXmlSchema),
+               ParseException);
+}
+
+TEST_F(SchemaValidatorTest, Cache)
+{
+  ClearSchemaValidatorCache();
+  auto from_string = SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema);
+  EXPECT_EQ(SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema), from_string);
+  EXPECT_NE(SchemaValidatorFromString(RELAX_NG_SCHEMA, SchemaType::kRelaxNG), from_string);
+  std::shared_ptr<const SchemaValidator> from_file;
+  {
+    sup::unit_test_helper::TemporaryTestFile schema_file{SCHEMA_FILENAME, XSD_SCHEMA};
+    from_file = SchemaValidatorFromFile(SCHEMA_FILENAME, SchemaType::kXmlSchema);
+    EXPECT_NE(from_file, from_string);
+    EXPECT_EQ(SchemaValidatorFromFile(SCHEMA_FILENAME, SchemaType::kXmlSchema), from_file);
+  }
+  {
+    // Changed contents are compiled again
+    sup::unit_test_helper::TemporaryTestFile schema_file{SCHEMA_FILENAME, RELAX_NG_SCHEMA};
+    auto changed = SchemaValidatorFromFile(SCHEMA_FILENAME, SchemaType::kRelaxNG);
+    EXPECT_NE(changed, from_file);
+    EXPECT_EQ(changed->GetType(), SchemaType::kRelaxNG);
+    EXPECT_TRUE(changed->Validate(VALID_DOCUMENT).empty());
+  }
+  ClearSchemaValidatorCache();
+  EXPECT_NE(SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema), from_string);
+  EXPECT_TRUE(from_string->Validate(VALID_DOCUMENT).empty());
+
+  // The cache is bounded: the least recently used schema is dropped
+  ClearSchemaValidatorCache();
+  const auto first = SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema);
+  const auto second = SchemaValidatorFromString(RELAX_NG_SCHEMA, SchemaType::kRelaxNG);
+  for (int i = 0; i < 100; ++i)
+  {
+    (void)SchemaValidatorFromString(XSD_SCHEMA + "<!-- " + std::to_string(i) + " -->",
+                                    SchemaType::kXmlSchema);
+    (void)SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema);
+  }
+  EXPECT_EQ(SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema), first);
+  EXPECT_NE(SchemaValidatorFromString(RELAX_NG_SCHEMA, SchemaType::kRelaxNG), second);
+  ClearSchemaValidatorCache();
+}
+
+TEST_F(SchemaValidatorTest, MultipleThreads)
+{
+  auto validator = SchemaValidatorFromString(XSD_SCHEMA, SchemaType::kXmlSchema);
+  const auto tree = TreeDataFromString(VALID_DOCUMENT);
+  std::vector<std::thread> threads;
+  std::vector<int> failures(4, 0);
+  for (std::size_t i = 0; i < failures.size(); ++i)
+  {
+    threads.emplace_back([&validator, &tree, &failures, i]()
+    {
+      for (int j = 0; j < 100; ++j)
+      {
+        failures[i] += validator->Validate(VALID_DOCUMENT).empty() ? 0 : 1;
+        failures[i] += validator->Validate(*tree).empty() ? 0 : 1;
+        failures[i] += validator->Validate(INVALID_DOCUMENT).size() == 2 ? 0 : 1;
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  EXPECT_EQ(failures, std::vector<int>(failures.size(), 0));
+}
+
+SchemaValidatorTest::SchemaValidatorTest() = default;
+
+SchemaValidatorTest::~SchemaValidatorTest() = default;
@@ -0,0 +1,277 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/tree_data_diff.h>
+#include <sup/xml/tree_data_parser.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+using namespace sup::xml;
+
+static const std::string XML_BODY = R"RAW(
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <PhoneNumber>12345</PhoneNumber>
+    <Details country="FR" membership="gold"/>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW";
+
+class TreeDataDiffTest : public ::testing::Test
+{
+protected:
+  TreeDataDiffTest();
+  virtual ~TreeDataDiffTest();
+
+  std::unique_ptr<TreeData> m_tree;
+};
+
+TEST_F(TreeDataDiffTest, EqualTrees)
+{
+  auto copy = *m_tree;
+  EXPECT_TRUE(Diff(*m_tree, copy).empty());
+
+  // Attribute order is not significant
+  TreeData left{"Node"};
+  left.AddAttribute("a", "1");
+  left.AddAttribute("b", "2");
+  TreeData right{"Node"};
+  right.AddAttribute("b", "2");
+  right.AddAttribute("a", "1");
+  EXPECT_TRUE(Diff(left, right).empty());
+}
+
+TEST_F(TreeDataDiffTest, ChangedValues)
+{
+  auto modified = TreeDataFromString(R"RAW(
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <PhoneNumber>54321</PhoneNumber>
+    <Details country="FR" membership="platina"/>
+  </Member>
+  <Member id="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW");
+  auto patch = Diff(*m_tree, *modified);
+  ASSERT_EQ(patch.size(), 4);
+
+  // Each change is addressed by the path of the node in the modified tree
+  auto find_edit = [&patch](TreeDataEdit::Kind kind)
+  {
+    return std::find_if(patch.begin(), patch.end(),
+                        [kind](const TreeDataEdit& edit) { return edit.kind == kind; });
+  };
+  auto content_edit = find_edit(TreeDataEdit::Kind::kSetContent);
+  ASSERT_NE(content_edit, patch.end());
+  EXPECT_EQ(content_edit->path, std::vector<std::size_t>({0, 1}));
+  EXPECT_EQ(content_edit->value, "54321");
+  auto remove_edit = find_edit(TreeDataEdit::Kind::kRemoveAttribute);
+  ASSERT_NE(remove_edit, patch.end());
+  EXPECT_EQ(remove_edit->path, std::vector<std::size_t>({1}));
+  EXPECT_EQ(remove_edit->name, "key");
+  EXPECT_EQ(std::count_if(patch.begin(), patch.end(), [](const TreeDataEdit& edit)
+                          { return edit.kind == TreeDataEdit::Kind::kSetAttribute; }), 2);
+
+  ApplyPatch(*m_tree, patch);
+  EXPECT_EQ(*m_tree, *modified);
+}
+
+TEST_F(TreeDataDiffTest, ChangedChildren)
+{
+  auto modified = TreeDataFromString(R"RAW(
+<MemberList>
+  <Member key="1">
+    <Name format="full">Bob</Name>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <Details country="FR" membership="gold"/>
+  </Member>
+</MemberList>
+)RAW");
+  auto patch = Diff(*m_tree, *modified);
+  auto patched = *m_tree;
+  ApplyPatch(patched, patch);
+  EXPECT_EQ(patched, *modified);
+  // Unchanged members are not visited
+  for (const auto& edit : patch)
+  {
+    EXPECT_FALSE(edit.path.size() > 1 && edit.path.front() == 1);
+  }
+
+  // Different root node
+  TreeData other{"Other"};
+  patch = Diff(*m_tree, other);
+  ASSERT_EQ(patch.size(), 1);
+  EXPECT_EQ(patch[0].kind, TreeDataEdit::Kind::kReplaceNode);
+  EXPECT_TRUE(patch[0].path.empty());
+  ApplyPatch(*m_tree, patch);
+  EXPECT_EQ(*m_tree, other);
+}
+
+TEST_F(TreeDataDiffTest, ChildLookupAfterPatch)
+{
+  // Enough children for the parent to index them by tag
+  TreeData tree{"List"};
+  for (int i = 0; i < 50; ++i)
+  {
+    (void)tree.EmplaceChild("Item");
+  }
+  ASSERT_EQ(tree.CountChildren("Item"), 50);
+  TreeDataEdit edit;
+  edit.kind = TreeDataEdit::Kind::kReplaceNode;
+  edit.path = {10};
+  edit.node = TreeData{"Special"};
+  TreeDataEdit insert;
+  insert.kind = TreeDataEdit::Kind::kInsertNode;
+  insert.path = {0};
+  insert.node = TreeData{"First"};
+  ApplyPatch(tree, {edit, insert});
+  EXPECT_EQ(tree.CountChildren("Item"), 49);
+  EXPECT_EQ(tree.FindChild("Special"), &tree.Children()[11]);
+  EXPECT_EQ(tree.FindChild("First"), &tree.Children()[0]);
+  TreeDataEdit remove;
+  remove.kind = TreeDataEdit::Kind::kRemoveNode;
+  remove.path = {11};
+  ApplyPatch(tree, {remove});
+  EXPECT_EQ(tree.FindChild("Special"), nullptr);
+  EXPECT_EQ(tree.CountChildren("Item"), 49);
+}
+
+TEST_F(TreeDataDiffTest, RandomTrees)
+{
+  std::mt19937 generator{4321};
+  const std::vector<std::string> names = { "a", "b", "c" };
+  std::function<TreeData(std::size_t)> random_tree = [&](std::size_t depth)
+  {
+    TreeData tree{names[generator() % names.size()]};
+    const auto n_attributes = generator() % 3;
+    for (std::size_t i = 0; i < n_attributes; ++i)
+    {
+      tree.AddAttribute(names[i], std::to_string(generator() % 3));
+    }
+    if (generator() % 2 == 0)
+    {
+      tree.SetContent(std::to_string(generator() % 3));
+    }
+    const auto n_children = (depth < 4) ? generator() % 5 : 0;
+    for (std::size_t i = 0; i < n_children; ++i)
+    {
+      tree.AddChild(random_tree(depth + 1));
+    }
+    return tree;
+  };
+  // Copy of a tree where some nodes are changed, dropped or inserted
+  std::function<TreeData(const TreeData&, std::size_t)> mutate =
+    [&](const TreeData& tree, std::size_t depth)
+  {
+    if (generator() % 20 == 0)
+    {
+      return random_tree(depth);
+    }
+    TreeData result{tree.GetInternedNodeName()};
+    for (const auto& attr : tree.Attributes())
+    {
+      if (generator() % 10 != 0)
+      {
+        result.AddAttribute(attr.first,
+                            generator() % 10 == 0 ? std::string{"new"} : attr.second);
+      }
+    }
+    if (!result.HasAttribute(names[2]) && generator() % 10 == 0)
+    {
+      result.AddAttribute(names[2], "added");
+    }
+    result.SetContent(generator() % 10 == 0 ? std::string{"changed"} : tree.GetContent());
+    for (const auto& child : tree.Children())
+    {
+      if (generator() % 10 == 0)
+      {
+        result.AddChild(random_tree(depth + 1));
+      }
+      if (generator() % 10 != 0)
+      {
+        result.AddChild(generator() % 3 == 0 ? mutate(child, depth + 1) : child);
+      }
+    }
+    return result;
+  };
+  for (int i = 0; i < 500; ++i)
+  {
+    const auto old_tree = random_tree(0);
+    const auto new_tree = mutate(old_tree, 0);
+    const auto patch = Diff(old_tree, new_tree);
+    EXPECT_EQ(patch.empty(), old_tree == new_tree);
+    auto patched = old_tree;
+    ApplyPatch(patched, patch);
+    ASSERT_EQ(patched, new_tree);
+  }
+}
+
+TEST_F(TreeDataDiffTest, ApplyPatchErrors)
+{
+  TreeDataEdit edit;
+  edit.kind = TreeDataEdit::Kind::kRemoveNode;
+  EXPECT_THROW(ApplyPatch(*m_tree, {edit}), InvalidOperationException);
+  edit.path = {2};
+  EXPECT_THROW(ApplyPatch(*m_tree, {edit}), InvalidOperationException);
+  edit.kind = TreeDataEdit::Kind::kSetContent;
+  edit.path = {0, 5};
+  EXPECT_THROW(ApplyPatch(*m_tree, {edit}), InvalidOperationException);
+  edit.kind = TreeDataEdit::Kind::kRemoveAttribute;
+  edit.path = {0};
+  edit.name = "unknown";
+  EXPECT_THROW(ApplyPatch(*m_tree, {edit}), InvalidOperationException);
+  edit.kind = TreeDataEdit::Kind::kInsertNode;
+  edit.path = {1};
+  EXPECT_THROW(ApplyPatch(*m_tree, {edit}), InvalidOperationException);
+
+  // Insertion at the end of the child list is allowed
+  edit.path = {2};
+  edit.node = TreeData{"Member"};
+  EXPECT_NO_THROW(ApplyPatch(*m_tree, {edit}));
+  EXPECT_EQ(m_tree->GetNumberOfChildren(), 3);
+}
+
+TreeDataDiffTest::TreeDataDiffTest()
+  : m_tree{TreeDataFromString(XML_BODY)}
+{}
+
+TreeDataDiffTest::~TreeDataDiffTest() = default;
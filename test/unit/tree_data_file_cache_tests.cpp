@@ -0,0 +1,284 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include "unit_test_helper.h"
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/tree_data_file_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace sup::xml;
+
+static const std::string CACHE_DIRECTORY = "tree_data_file_cache_test_dir";
+static const std::string XML_FILENAME = "tree_data_file_cache_test.xml";
+
+static const std::string XML_CONTENTS = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+<MemberList>
+  <Member key="433">
+    <Name format="full">Martha Thompson</Name>
+    <PhoneNumber>12345</PhoneNumber>
+    <Details country="FR" membership="gold"/>
+  </Member>
+  <Member key="23">
+    <Name format="prename">Anna &amp; Bob</Name>
+    <Details country="DE" membership="platina"/>
+  </Member>
+</MemberList>
+)RAW";
+
+class TreeDataFileCacheTest : public ::testing::Test
+{
+protected:
+  TreeDataFileCacheTest();
+  virtual ~TreeDataFileCacheTest();
+
+  //! Names of the cache entries currently in the cache directory.
+  std::vector<std::string> EntryNames() const;
+
+  //! Overwrite a file, keeping its modification time.
+  void RewriteKeepingTime(const std::string& filename, const std::string& contents) const;
+};
+
+TEST_F(TreeDataFileCacheTest, HitsAndMisses)
+{
+  sup::unit_test_helper::TemporaryTestFile xml_file{XML_FILENAME, XML_CONTENTS};
+  auto expected = TreeDataFromFile(XML_FILENAME);
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  auto tree = cache.TreeDataFromFile(XML_FILENAME);
+  ASSERT_NE(tree, nullptr);
+  EXPECT_EQ(*tree, *expected);
+  auto stats = cache.GetStatistics();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.rejected_entries, 0);
+  EXPECT_EQ(stats.write_errors, 0);
+  EXPECT_EQ(EntryNames().size(), 1);
+
+  tree = cache.TreeDataFromFile(XML_FILENAME, ParseMode::kStreaming);
+  ASSERT_NE(tree, nullptr);
+  EXPECT_EQ(*tree, *expected);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+
+  // Entries persist across cache instances
+  TreeDataFileCache other_cache{CACHE_DIRECTORY};
+  tree = other_cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(*tree, *expected);
+  EXPECT_EQ(other_cache.GetStatistics().hits, 1);
+  EXPECT_EQ(other_cache.GetStatistics().misses, 0);
+
+  cache.ResetStatistics();
+  stats = cache.GetStatistics();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 0);
+}
+
+TEST_F(TreeDataFileCacheTest, ModifiedFile)
+{
+  sup::unit_test_helper::TemporaryTestFile xml_file{XML_FILENAME, XML_CONTENTS};
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  (void)cache.TreeDataFromFile(XML_FILENAME);
+
+  // Different size
+  const std::string changed = "<MemberList><Member key=\"1\"/></MemberList>";
+  {
+    std::ofstream out{XML_FILENAME};
+    out << changed;
+  }
+  auto tree = cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(*tree, *TreeDataFromString(changed));
+  auto stats = cache.GetStatistics();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.rejected_entries, 1);
+
+  // Same size and modification time: only the content hash differs
+  const std::string same_size = "<MemberList><Member key=\"2\"/></MemberList>";
+  RewriteKeepingTime(XML_FILENAME, same_size);
+  tree = cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(*tree, *TreeDataFromString(same_size));
+  stats = cache.GetStatistics();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.rejected_entries, 2);
+  EXPECT_EQ(stats.hits, 0);
+  (void)cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+  EXPECT_EQ(EntryNames().size(), 1);
+}
+
+TEST_F(TreeDataFileCacheTest, CorruptEntry)
+{
+  sup::unit_test_helper::TemporaryTestFile xml_file{XML_FILENAME, XML_CONTENTS};
+  auto expected = TreeDataFromFile(XML_FILENAME);
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  (void)cache.TreeDataFromFile(XML_FILENAME);
+  auto entries = EntryNames();
+  ASSERT_EQ(entries.size(), 1);
+  std::string entry_contents;
+  {
+    std::ifstream in{entries[0], std::ios::binary};
+    entry_contents.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+  }
+
+  // Damaged payload
+  auto damaged = entry_contents;
+  damaged[damaged.size() - 3] ^= 0x55;
+  RewriteKeepingTime(entries[0], damaged);
+  auto tree = cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(*tree, *expected);
+  EXPECT_EQ(cache.GetStatistics().rejected_entries, 1);
+
+  // Truncated entries of all lengths
+  for (std::size_t size = 0; size < entry_contents.size(); size += 7)
+  {
+    RewriteKeepingTime(entries[0], entry_contents.substr(0, size));
+    tree = cache.TreeDataFromFile(XML_FILENAME);
+    EXPECT_EQ(*tree, *expected);
+  }
+  EXPECT_EQ(cache.GetStatistics().hits, 0);
+
+  // The entry was rewritten by the last parse
+  (void)cache.TreeDataFromFile(XML_FILENAME);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+}
+
+TEST_F(TreeDataFileCacheTest, Errors)
+{
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  EXPECT_THROW(cache.TreeDataFromFile("tree_data_file_cache_missing.xml"), ParseException);
+  {
+    sup::unit_test_helper::TemporaryTestFile xml_file{XML_FILENAME, "<MemberList><Member>"};
+    EXPECT_THROW(cache.TreeDataFromFile(XML_FILENAME), ParseException);
+    EXPECT_THROW(cache.TreeDataFromFile(XML_FILENAME), ParseException);
+  }
+  auto stats = cache.GetStatistics();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_TRUE(EntryNames().empty());
+
+  // A file in place of the cache directory
+  sup::unit_test_helper::TemporaryTestFile blocking_file{"tree_data_file_cache_blocked", ""};
+  EXPECT_THROW(TreeDataFileCache{"tree_data_file_cache_blocked"}, InvalidOperationException);
+}
+
+TEST_F(TreeDataFileCacheTest, ConcurrentUse)
+{
+  sup::unit_test_helper::TemporaryTestFile xml_file{XML_FILENAME, XML_CONTENTS};
+  auto expected = TreeDataFromFile(XML_FILENAME);
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  const std::size_t n_threads = 8;
+  const std::size_t n_loads = 50;
+  std::vector<std::thread> threads;
+  std::vector<std::size_t> failures(n_threads, 0);
+  for (std::size_t i = 0; i < n_threads; ++i)
+  {
+    threads.emplace_back(
+      [&, i]()
+      {
+        // Separate instances behave like separate processes sharing the directory
+        TreeDataFileCache thread_cache{CACHE_DIRECTORY};
+        for (std::size_t j = 0; j < n_loads; ++j)
+        {
+          auto& used_cache = j % 2 == 0 ? cache : thread_cache;
+          if (*used_cache.TreeDataFromFile(XML_FILENAME) != *expected)
+          {
+            ++failures[i];
+          }
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (auto failure_count : failures)
+  {
+    EXPECT_EQ(failure_count, 0);
+  }
+  EXPECT_EQ(cache.GetStatistics().rejected_entries, 0);
+  EXPECT_EQ(EntryNames().size(), 1);
+}
+
+TEST_F(TreeDataFileCacheTest, StaleTemporaryEntries)
+{
+  {
+    TreeDataFileCache cache{CACHE_DIRECTORY};
+  }
+  const std::string stale_entry = CACHE_DIRECTORY + "/0123456789abcdef.tdcache.1.0.tmp";
+  const std::string fresh_entry = CACHE_DIRECTORY + "/0123456789abcdef.tdcache.1.1.tmp";
+  const std::string other_file = CACHE_DIRECTORY + "/unrelated.tmp";
+  for (const auto& filename : {stale_entry, fresh_entry, other_file})
+  {
+    std::ofstream out{filename, std::ios::binary};
+    out << "partial";
+  }
+  // Pretend the writers of stale_entry and other_file died two hours ago
+  const auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(2);
+  std::filesystem::last_write_time(stale_entry, old_time);
+  std::filesystem::last_write_time(other_file, old_time);
+
+  TreeDataFileCache cache{CACHE_DIRECTORY};
+  EXPECT_FALSE(std::filesystem::exists(stale_entry));
+  EXPECT_TRUE(std::filesystem::exists(fresh_entry));
+  EXPECT_TRUE(std::filesystem::exists(other_file));
+}
+
+std::vector<std::string> TreeDataFileCacheTest::EntryNames() const
+{
+  std::vector<std::string> result;
+  for (const auto& entry : std::filesystem::directory_iterator{CACHE_DIRECTORY})
+  {
+    result.push_back(entry.path().string());
+  }
+  return result;
+}
+
+void TreeDataFileCacheTest::RewriteKeepingTime(const std::string& filename,
+                                               const std::string& contents) const
+{
+  struct stat file_stat;
+  ASSERT_EQ(stat(filename.c_str(), &file_stat), 0);
+  {
+    std::ofstream out{filename, std::ios::binary | std::ios::trunc};
+    out << contents;
+  }
+  const struct timespec times[2] = {file_stat.st_atim, file_stat.st_mtim};
+  ASSERT_EQ(utimensat(AT_FDCWD, filename.c_str(), times, 0), 0);
+}
+
+TreeDataFileCacheTest::TreeDataFileCacheTest()
+{
+  std::filesystem::remove_all(CACHE_DIRECTORY);
+}
+
+TreeDataFileCacheTest::~TreeDataFileCacheTest()
+{
+  std::filesystem::remove_all(CACHE_DIRECTORY);
+}
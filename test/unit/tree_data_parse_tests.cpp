@@ -23,27 +23,32 @@
 #include "unit_test_helper.h"
 
 #include <sup/xml/exceptions.h>
+#include <sup/xml/mapped_file.h>
 #include <sup/xml/tree_data_parser.h>
 #include <sup/xml/tree_data_parser_utils.h>
 #include <sup/xml/tree_data_serialize.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace sup::xml;
 
 //! Check if content string is empty apart from newlines and spaces
 static bool ContentEmpty(const std::string& content);
 
-class TreeDataParserTest : public ::testing::Test
+class TreeDataParserTest : public ::testing::TestWithParam<ParseMode>
 {
 protected:
   TreeDataParserTest();
   virtual ~TreeDataParserTest();
 
   std::string AddXMLHeader(const std::string& body);
+
+  std::string ModeSuffix() const;
 };
 
-TEST_F(TreeDataParserTest, FromString)
+TEST_P(TreeDataParserTest, FromString)
 {
   std::string body = R"RAW(
     <MemberList>
@@ -61,7 +66,7 @@ TEST_F(TreeDataParserTest, FromString)
 
   // Parse XML from string
   auto xml_str = AddXMLHeader(body);
-  auto tree_data = TreeDataFromString(xml_str);
+  auto tree_data = TreeDataFromString(xml_str, GetParam());
   ASSERT_TRUE(static_cast<bool>(tree_data));
 
   // Inspect root node
@@ -137,7 +142,7 @@ TEST_F(TreeDataParserTest, FromString)
   EXPECT_TRUE(ContentEmpty(mem2_details.GetContent()));
 }
 
-TEST_F(TreeDataParserTest, FromFile)
+TEST_P(TreeDataParserTest, FromFile)
 {
   std::string body = R"RAW(
     <MemberList>
@@ -152,12 +157,12 @@ TEST_F(TreeDataParserTest, FromFile)
       </Member>
     </MemberList>
   )RAW";
-  const std::string filename = "TreeDataParserTest_FromFile";
+  const std::string filename = "TreeDataParserTest_FromFile" + ModeSuffix();
   auto xml_str = AddXMLHeader(body);
   sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
 
   // Parse XML from file
-  auto tree_data = TreeDataFromFile(filename);
+  auto tree_data = TreeDataFromFile(filename, GetParam());
   ASSERT_TRUE(static_cast<bool>(tree_data));
 
   // Inspect root node
@@ -233,31 +238,31 @@ TEST_F(TreeDataParserTest, FromFile)
   EXPECT_TRUE(ContentEmpty(mem2_details.GetContent()));
 }
 
-TEST_F(TreeDataParserTest, FromStringError)
+TEST_P(TreeDataParserTest, FromStringError)
 {
   std::string wrong_xml = R"RAW(
     <MemberList>
   )RAW";
-  EXPECT_THROW(TreeDataFromString(wrong_xml), ParseException);
+  EXPECT_THROW(TreeDataFromString(wrong_xml, GetParam()), ParseException);
 
   std::string empty_xml = AddXMLHeader("");
-  EXPECT_THROW(TreeDataFromString(empty_xml), ParseException);
+  EXPECT_THROW(TreeDataFromString(empty_xml, GetParam()), ParseException);
 }
 
-TEST_F(TreeDataParserTest, FromFileError)
+TEST_P(TreeDataParserTest, FromFileError)
 {
   const std::string non_existing_filename = "File_does_not_exist";
-  EXPECT_THROW(TreeDataFromFile(non_existing_filename), ParseException);
+  EXPECT_THROW(TreeDataFromFile(non_existing_filename, GetParam()), ParseException);
 
   std::string wrong_xml = R"RAW(
     <MemberList>
   )RAW";
-  const std::string bad_xml_filename = "TreeDataParserTest_BadXML";
+  const std::string bad_xml_filename = "TreeDataParserTest_BadXML" + ModeSuffix();
   sup::unit_test_helper::TemporaryTestFile xml_file(bad_xml_filename, wrong_xml);
-  EXPECT_THROW(TreeDataFromFile(bad_xml_filename), ParseException);
+  EXPECT_THROW(TreeDataFromFile(bad_xml_filename, GetParam()), ParseException);
 }
 
-TEST_F(TreeDataParserTest, FromStringAndRoundtrip)
+TEST_P(TreeDataParserTest, FromStringAndRoundtrip)
 {
   std::string body = R"RAW(
     <MemberList>
@@ -275,16 +280,16 @@ TEST_F(TreeDataParserTest, FromStringAndRoundtrip)
 
   // Parse XML from string
   auto xml_str = AddXMLHeader(body);
-  auto tree_data = TreeDataFromString(xml_str);
+  auto tree_data = TreeDataFromString(xml_str, GetParam());
   ASSERT_TRUE(static_cast<bool>(tree_data));
 
   // Serialize and parse again
-  auto tree_data_roundtrip = TreeDataFromString(TreeDataToString(*tree_data));
+  auto tree_data_roundtrip = TreeDataFromString(TreeDataToString(*tree_data), GetParam());
   ASSERT_TRUE(static_cast<bool>(tree_data_roundtrip));
   EXPECT_EQ(*tree_data_roundtrip, *tree_data);
 }
 
-TEST_F(TreeDataParserTest, DepthFour)
+TEST_P(TreeDataParserTest, DepthFour)
 {
   std::string body = R"RAW(
     <MemberList>
@@ -301,7 +306,7 @@ TEST_F(TreeDataParserTest, DepthFour)
 
   // Parse XML from string
   auto xml_str = AddXMLHeader(body);
-  auto tree_data = TreeDataFromString(xml_str);
+  auto tree_data = TreeDataFromString(xml_str, GetParam());
   ASSERT_TRUE(static_cast<bool>(tree_data));
 
   // Inspect root node
@@ -362,11 +367,353 @@ TEST_F(TreeDataParserTest, DepthFour)
   EXPECT_EQ(mem2_name.GetContent(), "Anna");
 }
 
-TEST_F(TreeDataParserTest, ParseExceptions)
+TEST_P(TreeDataParserTest, ContentRules)
+{
+  // Mixed content, CDATA, entities, comments and whitespace need to produce the same tree in
+  // all parse modes
+  std::string body = R"RAW(<!DOCTYPE Root [<!ENTITY company "ITER Organization">]>
+    <Root xml:space="default">
+      <Mixed>first<Child/>second<!-- comment -->third</Mixed>
+      <CData><![CDATA[only <cdata>]]></CData>
+      <TextAndCData>text<![CDATA[ and <cdata>]]></TextAndCData>
+      <Entity>Built by &company; &amp; partners</Entity>
+      <Blank>   </Blank>
+      <Preserved xml:space="preserve">
+        <Child/>
+      </Preserved>
+      <Empty/>
+    </Root>
+  )RAW";
+  auto xml_str = AddXMLHeader(body);
+  auto reference = TreeDataFromString(xml_str, ParseMode::kDocument);
+  auto tree_data = TreeDataFromString(xml_str, GetParam());
+  ASSERT_TRUE(static_cast<bool>(reference));
+  ASSERT_TRUE(static_cast<bool>(tree_data));
+  EXPECT_EQ(*tree_data, *reference);
+  auto& children = tree_data->Children();
+  ASSERT_EQ(children.size(), 7);
+  EXPECT_EQ(children[0].GetContent(), "third");
+}
+
+TEST_P(TreeDataParserTest, ManyChildren)
+{
+  std::string body = "<Root>";
+  for (int i = 0; i < 1000; ++i)
+  {
+    body += "<Child index=\"" + std::to_string(i) + "\">text<!-- comment --></Child>text";
+  }
+  body += "</Root>";
+  auto tree_data = TreeDataFromString(AddXMLHeader(body), GetParam());
+  ASSERT_TRUE(static_cast<bool>(tree_data));
+  auto& children = tree_data->Children();
+  ASSERT_EQ(children.size(), 1000);
+  for (int i = 0; i < 1000; ++i)
+  {
+    EXPECT_EQ(children[i].GetAttribute("index"), std::to_string(i));
+  }
+}
+
+TEST_P(TreeDataParserTest, MemoryMapped)
+{
+  std::string body = R"RAW(
+    <MemberList>
+      <Member key="433">
+        <Name format="full">Martha Thompson</Name>
+        <Details country="FR" membership="gold"/>
+      </Member>
+    </MemberList>
+  )RAW";
+  const std::string filename = "TreeDataParserTest_MemoryMapped" + ModeSuffix();
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, AddXMLHeader(body));
+  auto buffered = TreeDataFromFile(filename, GetParam());
+  ASSERT_TRUE(static_cast<bool>(buffered));
+
+  // Let the parser map the file
+  auto mapped = TreeDataFromFile(filename, GetParam(), FileAccess::kMemoryMapped);
+  ASSERT_TRUE(static_cast<bool>(mapped));
+  EXPECT_EQ(*mapped, *buffered);
+
+  // Map the file up front and parse the region
+  MappedFile mapped_file{filename};
+  EXPECT_GT(mapped_file.Size(), 0);
+  auto from_memory = TreeDataFromMemory(mapped_file.Data(), mapped_file.Size(), GetParam());
+  ASSERT_TRUE(static_cast<bool>(from_memory));
+  EXPECT_EQ(*from_memory, *buffered);
+
+  // Region does not need to be null-terminated
+  const std::string xml_str = AddXMLHeader("<Root>text</Root>trailing");
+  auto partial = TreeDataFromMemory(xml_str.data(), xml_str.size() - 8, GetParam());
+  ASSERT_TRUE(static_cast<bool>(partial));
+  EXPECT_EQ(partial->GetContent(), "text");
+}
+
+TEST_P(TreeDataParserTest, MemoryMappedErrors)
+{
+  const auto access = FileAccess::kMemoryMapped;
+  EXPECT_THROW(TreeDataFromFile("File_does_not_exist", GetParam(), access), ParseException);
+  EXPECT_THROW(MappedFile{"File_does_not_exist"}, ParseException);
+
+  const std::string empty_filename = "TreeDataParserTest_MemoryMappedEmpty" + ModeSuffix();
+  sup::unit_test_helper::TemporaryTestFile empty_file(empty_filename, "");
+  EXPECT_THROW(TreeDataFromFile(empty_filename, GetParam(), access), ParseException);
+  MappedFile mapped_file{empty_filename};
+  EXPECT_EQ(mapped_file.Data(), nullptr);
+  EXPECT_EQ(mapped_file.Size(), 0);
+
+  const std::string bad_xml_filename = "TreeDataParserTest_MemoryMappedBad" + ModeSuffix();
+  sup::unit_test_helper::TemporaryTestFile bad_file(bad_xml_filename, "<MemberList>");
+  EXPECT_THROW(TreeDataFromFile(bad_xml_filename, GetParam(), access), ParseException);
+
+  EXPECT_THROW(TreeDataFromMemory(nullptr, 0, GetParam()), ParseException);
+}
+
+TEST_P(TreeDataParserTest, RepeatedParsing)
+{
+  const std::string xml_str = AddXMLHeader(R"RAW(
+    <Messages>
+      <Message id="1">first text</Message>
+      <Message id="2"><![CDATA[<raw>]]> &amp; more</Message>
+    </Messages>
+  )RAW");
+  const std::string filename = "TreeDataParserTest_RepeatedParsing" + ModeSuffix();
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
+  auto parse_all = [&]()
+  {
+    EXPECT_EQ(TreeDataFromString(xml_str, GetParam())->GetNumberOfChildren(), 2);
+    EXPECT_EQ(TreeDataFromFile(filename, GetParam())->GetNumberOfChildren(), 2);
+    EXPECT_EQ(
+      TreeDataFromMemory(xml_str.data(), xml_str.size(), GetParam())->GetNumberOfChildren(), 2);
+  };
+  parse_all();
+  const auto allocated_before = sup::unit_test_helper::AllocatedHeapBytes();
+  for (int i = 0; i < 1000; ++i)
+  {
+    parse_all();
+  }
+  // Nothing of the parsed documents is retained between calls
+  const auto allocated_after = sup::unit_test_helper::AllocatedHeapBytes();
+  EXPECT_LT(allocated_after, allocated_before + 64 * 1024);
+}
+
+TEST_P(TreeDataParserTest, ParseExceptions)
 {
   EXPECT_THROW(ParseXMLDoc(nullptr), ParseException);
 }
 
+class TreeDataStreamTest : public ::testing::Test
+{
+protected:
+  TreeDataStreamTest();
+  virtual ~TreeDataStreamTest();
+};
+
+TEST_F(TreeDataStreamTest, Records)
+{
+  std::string xml_str = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+    <Archive version="2">
+      <Header>ignored</Header>
+      <Records>
+        <Record id="1"><Value>one</Value></Record>
+        <Record id="2"/>
+        <Record id="3">text<Value>three</Value></Record>
+      </Records>
+    </Archive>
+  )RAW";
+  const std::string filename = "TreeDataStreamTest_Records";
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
+  auto full_tree = TreeDataFromFile(filename);
+  ASSERT_TRUE(static_cast<bool>(full_tree));
+
+  // Root element as single record
+  std::vector<TreeData> records;
+  auto collect = [&records](TreeData& record) { records.push_back(std::move(record)); };
+  EXPECT_NO_THROW(ParseTreeDataStream(filename, 0, collect));
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0], *full_tree);
+
+  // Elements at depth two
+  records.clear();
+  EXPECT_NO_THROW(ParseTreeDataStream(filename, 2, collect));
+  const auto& expected = full_tree->Children()[1].Children();
+  ASSERT_EQ(records.size(), 3);
+  EXPECT_EQ(records[0], expected[0]);
+  EXPECT_EQ(records[1], expected[1]);
+  EXPECT_EQ(records[2], expected[2]);
+  EXPECT_EQ(records[2].GetContent(), "text");
+
+  // No elements at this depth
+  records.clear();
+  EXPECT_NO_THROW(ParseTreeDataStream(filename, 5, collect));
+  EXPECT_TRUE(records.empty());
+}
+
+TEST_F(TreeDataStreamTest, Errors)
+{
+  auto ignore = [](TreeData&) {};
+  EXPECT_THROW(ParseTreeDataStream("File_does_not_exist", 1, ignore), ParseException);
+
+  std::string xml_str = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+    <Archive>
+      <Record id="1"/>
+      <Record id="2">
+    </Archive>
+  )RAW";
+  const std::string filename = "TreeDataStreamTest_Errors";
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
+  EXPECT_THROW(ParseTreeDataStream(filename, 1, ignore), ParseException);
+}
+
+TEST_F(TreeDataStreamTest, ManyRecords)
+{
+  const std::size_t n_records = 20000;
+  std::string xml_str = R"RAW(<?xml version="1.0" encoding="UTF-8"?>
+    <!DOCTYPE Archive [<!ENTITY unit "meter">]>
+    <Archive>
+  )RAW";
+  for (std::size_t i = 0; i < n_records; ++i)
+  {
+    xml_str += "<Record id=\"" + std::to_string(i) + "\">value " + std::to_string(i) +
+               " &unit;<Note>note text</Note></Record>\n";
+  }
+  xml_str += "</Archive>\n";
+  const std::string filename = "TreeDataStreamTest_ManyRecords";
+  sup::unit_test_helper::TemporaryTestFile xml_file(filename, xml_str);
+
+  // Memory use must not grow with the number of records already processed
+  std::size_t count = 0;
+  std::size_t allocated_start = 0;
+  std::size_t max_growth = 0;
+  auto check = [&](TreeData& record)
+  {
+    EXPECT_EQ(record.GetContent(), "value " + std::to_string(count) + " meter");
+    EXPECT_EQ(record.Children()[0].GetContent(), "note text");
+    const auto allocated = sup::unit_test_helper::AllocatedHeapBytes();
+    if (count == 100)
+    {
+      allocated_start = allocated;
+    }
+    else if (count > 100 && allocated > allocated_start)
+    {
+      max_growth = std::max(max_growth, allocated - allocated_start);
+    }
+    ++count;
+  };
+  EXPECT_NO_THROW(ParseTreeDataStream(filename, 1, check));
+  EXPECT_EQ(count, n_records);
+  EXPECT_LT(max_growth, 64 * 1024);
+
+  // Nothing is retained after a stream was processed
+  const std::string small_filename = "TreeDataStreamTest_ManyRecordsSmall";
+  sup::unit_test_helper::TemporaryTestFile small_xml_file(
+    small_filename, "<Archive><Record>text<Note>more text</Note></Record></Archive>");
+  auto ignore = [](TreeData&) {};
+  EXPECT_NO_THROW(ParseTreeDataStream(small_filename, 1, ignore));
+  const auto allocated_before = sup::unit_test_helper::AllocatedHeapBytes();
+  for (int i = 0; i < 500; ++i)
+  {
+    EXPECT_NO_THROW(ParseTreeDataStream(small_filename, 1, ignore));
+  }
+  const auto allocated_after = sup::unit_test_helper::AllocatedHeapBytes();
+  EXPECT_LT(allocated_after, allocated_before + 64 * 1024);
+}
+
+class TreeDataFromFilesTest : public ::testing::Test
+{
+protected:
+  TreeDataFromFilesTest();
+  virtual ~TreeDataFromFilesTest();
+};
+
+TEST_F(TreeDataFromFilesTest, Results)
+{
+  std::vector<std::unique_ptr<sup::unit_test_helper::TemporaryTestFile>> files;
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 20; ++i)
+  {
+    const std::string filename = "TreeDataFromFilesTest_Results" + std::to_string(i);
+    const std::string xml_str = (i % 7 == 3) ? "<Broken>"
+                                             : "<Root index=\"" + std::to_string(i) + "\"/>";
+    files.emplace_back(new sup::unit_test_helper::TemporaryTestFile(filename, xml_str));
+    filenames.push_back(filename);
+  }
+  filenames.push_back("File_does_not_exist");
+  for (unsigned threads : { 0u, 1u, 4u, 64u })
+  {
+    auto results = TreeDataFromFiles(filenames, threads);
+    ASSERT_EQ(results.size(), filenames.size());
+    for (int i = 0; i < 20; ++i)
+    {
+      if (i % 7 == 3)
+      {
+        EXPECT_FALSE(static_cast<bool>(results[i].tree_data));
+        EXPECT_FALSE(results[i].error_message.empty());
+      }
+      else
+      {
+        ASSERT_TRUE(static_cast<bool>(results[i].tree_data));
+        EXPECT_EQ(results[i].tree_data->GetAttribute("index"), std::to_string(i));
+        EXPECT_TRUE(results[i].error_message.empty());
+      }
+    }
+    EXPECT_FALSE(static_cast<bool>(results.back().tree_data));
+    EXPECT_NE(results.back().error_message.find("file not found"), std::string::npos);
+  }
+  EXPECT_TRUE(TreeDataFromFiles({}, 4).empty());
+}
+
+class ReusableTreeDataParserTest : public ::testing::Test
+{
+protected:
+  ReusableTreeDataParserTest();
+  virtual ~ReusableTreeDataParserTest();
+};
+
+TEST_F(ReusableTreeDataParserTest, Parse)
+{
+  const std::vector<std::string> messages = {
+    R"RAW(<?xml version="1.0" encoding="UTF-8"?><Message id="1"><Value>one</Value></Message>)RAW",
+    R"RAW(<Message id="2">text<Value type="int">2</Value><!-- ignored --></Message>)RAW",
+    R"RAW(<Other a="&amp;" b="x">&lt;escaped&gt;<Empty/></Other>)RAW"
+  };
+  TreeDataParser parser;
+  for (int repeat = 0; repeat < 3; ++repeat)
+  {
+    for (const auto& message : messages)
+    {
+      auto expected = TreeDataFromString(message);
+      auto parsed = parser.Parse(message);
+      ASSERT_TRUE(static_cast<bool>(parsed));
+      EXPECT_EQ(*parsed, *expected);
+    }
+  }
+
+  // Parser remains usable after an error
+  EXPECT_THROW(parser.Parse("<Message>"), ParseException);
+  EXPECT_THROW(parser.Parse(""), ParseException);
+  EXPECT_THROW(parser.Parse(nullptr, 0), ParseException);
+  auto parsed = parser.Parse(messages[1]);
+  ASSERT_TRUE(static_cast<bool>(parsed));
+  EXPECT_EQ(*parsed, *TreeDataFromString(messages[1]));
+
+  // Region does not need to be null-terminated
+  const std::string padded = messages[0] + "trailing";
+  parsed = parser.Parse(padded.data(), messages[0].size());
+  ASSERT_TRUE(static_cast<bool>(parsed));
+  EXPECT_EQ(*parsed, *TreeDataFromString(messages[0]));
+}
+
+TreeDataStreamTest::TreeDataStreamTest() = default;
+
+TreeDataStreamTest::~TreeDataStreamTest() = default;
+
+TreeDataFromFilesTest::TreeDataFromFilesTest() = default;
+
+TreeDataFromFilesTest::~TreeDataFromFilesTest() = default;
+
+ReusableTreeDataParserTest::ReusableTreeDataParserTest() = default;
+
+ReusableTreeDataParserTest::~ReusableTreeDataParserTest() = default;
+
 static bool ContentEmpty(const std::string& content)
 {
   return content.find_first_not_of("\n ") == std::string::npos;
@@ -381,3 +728,11 @@ std::string TreeDataParserTest::AddXMLHeader(const std::string& body)
   static const std::string header{R"RAW(<?xml version="1.0" encoding="UTF-8"?>)RAW"};
   return header + body;
 }
+
+std::string TreeDataParserTest::ModeSuffix() const
+{
+  return GetParam() == ParseMode::kDocument ? "_Document" : "_Streaming";
+}
+
+INSTANTIATE_TEST_SUITE_P(ParseModes, TreeDataParserTest,
+                         ::testing::Values(ParseMode::kDocument, ParseMode::kStreaming));
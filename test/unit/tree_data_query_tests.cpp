@@ -0,0 +1,188 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/xml/exceptions.h>
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_query.h>
+
+#include <gtest/gtest.h>
+
+using namespace sup::xml;
+
+static const std::string XML_BODY = R"RAW(
+<Procedure>
+  <Workspace>
+    <Local name="a" type="uint32"/>
+    <Local name="b" type="string"/>
+  </Workspace>
+  <Sequence name="main">
+    <Wait name="w1" timeout="1.0"/>
+    <Sequence name="inner">
+      <Wait name="w2"/>
+      <Message text="done"/>
+    </Sequence>
+  </Sequence>
+  <Wait name="w3" timeout="2.0"/>
+</Procedure>
+)RAW";
+
+class TreeDataQueryTest : public ::testing::Test
+{
+protected:
+  TreeDataQueryTest();
+  virtual ~TreeDataQueryTest();
+
+  std::vector<std::string> Names(const std::vector<const TreeData*>& nodes);
+
+  std::unique_ptr<TreeData> m_tree;
+};
+
+TEST_F(TreeDataQueryTest, AbsolutePaths)
+{
+  EXPECT_EQ(TreeDataQuery("/Procedure").FindFirst(*m_tree), m_tree.get());
+  EXPECT_EQ(TreeDataQuery("/Other").FindFirst(*m_tree), nullptr);
+  EXPECT_EQ(Names(TreeDataQuery("/Procedure/Workspace/Local").FindAll(*m_tree)),
+            std::vector<std::string>({"a", "b"}));
+  EXPECT_EQ(Names(TreeDataQuery("/Procedure/*/Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w1"}));
+  EXPECT_EQ(TreeDataQuery("/Procedure/Wait").Count(*m_tree), 1);
+  EXPECT_EQ(TreeDataQuery("/Workspace").Count(*m_tree), 0);
+}
+
+TEST_F(TreeDataQueryTest, Descendants)
+{
+  // Results are in document order and nodes are reported once
+  EXPECT_EQ(Names(TreeDataQuery("//Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w1", "w2", "w3"}));
+  EXPECT_EQ(TreeDataQuery("//Procedure").Count(*m_tree), 1);
+  EXPECT_EQ(Names(TreeDataQuery("//Sequence//Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w1", "w2"}));
+  EXPECT_EQ(Names(TreeDataQuery("//Sequence/Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w1", "w2"}));
+  EXPECT_EQ(Names(TreeDataQuery("/Procedure/Sequence//Sequence").FindAll(*m_tree)),
+            std::vector<std::string>({"inner"}));
+  EXPECT_EQ(TreeDataQuery("//*").Count(*m_tree), 10);
+}
+
+TEST_F(TreeDataQueryTest, Predicates)
+{
+  EXPECT_EQ(Names(TreeDataQuery("//Wait[@timeout]").FindAll(*m_tree)),
+            std::vector<std::string>({"w1", "w3"}));
+  EXPECT_EQ(Names(TreeDataQuery("//Wait[@timeout='2.0']").FindAll(*m_tree)),
+            std::vector<std::string>({"w3"}));
+  EXPECT_EQ(Names(TreeDataQuery("//*[@name=\"inner\"]/Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w2"}));
+  EXPECT_EQ(Names(TreeDataQuery("//Local[ @type = 'string' ][@name]").FindAll(*m_tree)),
+            std::vector<std::string>({"b"}));
+  EXPECT_EQ(TreeDataQuery("//Local[@type='string'][@name='a']").Count(*m_tree), 0);
+  EXPECT_EQ(TreeDataQuery("//Message[@text='done']").Count(*m_tree), 1);
+}
+
+TEST_F(TreeDataQueryTest, RelativePaths)
+{
+  const auto& sequence = m_tree->Children()[1];
+  EXPECT_EQ(Names(TreeDataQuery("Wait").FindAll(sequence)), std::vector<std::string>({"w1"}));
+  EXPECT_EQ(Names(TreeDataQuery("Sequence/Wait").FindAll(sequence)),
+            std::vector<std::string>({"w2"}));
+  EXPECT_EQ(Names(TreeDataQuery("*//Wait").FindAll(*m_tree)),
+            std::vector<std::string>({"w1", "w2"}));
+  // The context node itself is not matched
+  EXPECT_EQ(TreeDataQuery("Procedure").Count(*m_tree), 0);
+}
+
+TEST_F(TreeDataQueryTest, EarlyExit)
+{
+  std::vector<std::string> names;
+  EXPECT_FALSE(TreeDataQuery("//Wait").ForEach(*m_tree, [&names](const TreeData& node)
+               {
+                 names.push_back(node.GetAttribute("name"));
+                 return names.size() < 2;
+               }));
+  EXPECT_EQ(names, std::vector<std::string>({"w1", "w2"}));
+  EXPECT_TRUE(TreeDataQuery("//Wait").ForEach(*m_tree, [](const TreeData&) { return true; }));
+}
+
+TEST_F(TreeDataQueryTest, TagIndex)
+{
+  const TreeDataTagIndex index{*m_tree};
+  EXPECT_EQ(&index.Root(), m_tree.get());
+  EXPECT_EQ(index.Find(InternedString{"Wait"}).size(), 3);
+  EXPECT_TRUE(index.Find(InternedString{"Unknown"}).empty());
+  for (const std::string expression : { "//Wait", "//Wait[@timeout]", "//Sequence/Wait",
+                                        "/Procedure/Sequence", "//*", "Sequence//Message",
+                                        "//Unknown" })
+  {
+    const TreeDataQuery query{expression};
+    EXPECT_EQ(query.FindAll(index), query.FindAll(*m_tree)) << expression;
+    EXPECT_EQ(query.FindFirst(index), query.FindFirst(*m_tree)) << expression;
+    EXPECT_EQ(query.Count(index), query.Count(*m_tree)) << expression;
+  }
+}
+
+TEST_F(TreeDataQueryTest, DeepTree)
+{
+  TreeData tree{"Level"};
+  TreeData* current = &tree;
+  for (int i = 0; i < 1000; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+  }
+  current->EmplaceChild("Leaf");
+  EXPECT_EQ(TreeDataQuery("//Leaf").Count(tree), 1);
+  EXPECT_EQ(TreeDataQuery("//Level").Count(tree), 1001);
+  EXPECT_EQ(TreeDataQuery("/Level/Level/Level").Count(tree), 1);
+}
+
+TEST_F(TreeDataQueryTest, InvalidExpressions)
+{
+  for (const std::string expression : { "", "/", "//", "/Root/", "Root//", "Root[", "Root[name]",
+                                        "Root[@]", "Root[@a=b]", "Root[@a='b]", "Root[@a='b'",
+                                        "Root]", "/Root//[@a]", "/Ro ot" })
+  {
+    EXPECT_THROW(TreeDataQuery{expression}, ParseException) << expression;
+  }
+  std::string long_expression;
+  for (int i = 0; i < 65; ++i)
+  {
+    long_expression += "/a";
+  }
+  EXPECT_THROW(TreeDataQuery{long_expression}, ParseException);
+  EXPECT_NO_THROW(TreeDataQuery{long_expression.substr(2)});
+  const TreeDataQuery query{"/a"};
+  EXPECT_EQ(query.GetExpression(), "/a");
+}
+
+TreeDataQueryTest::TreeDataQueryTest()
+  : m_tree{TreeDataFromString(XML_BODY)}
+{}
+
+TreeDataQueryTest::~TreeDataQueryTest() = default;
+
+std::vector<std::string> TreeDataQueryTest::Names(const std::vector<const TreeData*>& nodes)
+{
+  std::vector<std::string> result;
+  for (const auto node : nodes)
+  {
+    result.push_back(node->GetAttribute("name"));
+  }
+  return result;
+}
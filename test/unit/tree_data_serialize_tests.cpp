@@ -29,6 +29,14 @@
 
 #include <gtest/gtest.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <random>
+
 using namespace sup::xml;
 
 static const std::string MEMBERLIST_NODE = "MemberList";
@@ -62,6 +70,10 @@ protected:
 
   std::string AddXMLHeader(const std::string& body);
 
+  //! Serialize through libxml2's text writer, which TreeDataToString needs to match.
+  std::string SerializeWithLibXml(const TreeData& tree,
+                                  const SerializeOptions& options = SerializeOptions{});
+
   TreeData m_tree;
   XMLBufferHandle m_buffer;
   XMLTextWriterHandle m_writer;
@@ -98,6 +110,225 @@ TEST_F(TreeDataSerializeTest, SerializeExceptions)
 
 }
 
+TEST_F(TreeDataSerializeTest, MatchesLibXmlWriter)
+{
+  // Random trees with mixed content and text that needs escaping or is cut at a null character
+  std::mt19937 generator{1234};
+  const std::vector<std::string> fragments = {
+    "", "a", "text", " ", "<", ">", "&", "\"", "'", "\t", "\n", "\r", "]]>", "\xc3\xa9",
+    "\xf0\x9f\x98\x80", "\xff", "\x01", std::string(1, '\0'), "&amp;", "x y" };
+  auto random_text = [&](std::size_t max_fragments)
+  {
+    std::string result;
+    const auto n = std::uniform_int_distribution<std::size_t>{0, max_fragments}(generator);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      result += fragments[generator() % fragments.size()];
+    }
+    return result;
+  };
+  const std::vector<std::string> names = { "a", "Node", "ns:el", "x-y", "b1" };
+  std::function<TreeData(std::size_t)> random_tree = [&](std::size_t depth)
+  {
+    TreeData tree{names[generator() % names.size()]};
+    const auto n_attributes = generator() % 3;
+    for (std::size_t i = 0; i < n_attributes; ++i)
+    {
+      tree.AddAttribute(names[generator() % names.size()] + std::to_string(i), random_text(4));
+    }
+    if (generator() % 2 == 0)
+    {
+      tree.SetContent(random_text(3));
+    }
+    const auto n_children = (depth < 4) ? generator() % 4 : 0;
+    for (std::size_t i = 0; i < n_children; ++i)
+    {
+      tree.AddChild(random_tree(depth + 1));
+    }
+    return tree;
+  };
+  SerializeOptions compact;
+  compact.compact = true;
+  SerializeOptions tabs;
+  tabs.indent = "\t";
+  SerializeOptions no_indent;
+  no_indent.indent = "";
+  for (int i = 0; i < 500; ++i)
+  {
+    const auto tree = random_tree(0);
+    ASSERT_EQ(TreeDataToString(tree), SerializeWithLibXml(tree));
+    for (const auto& options : { compact, tabs, no_indent })
+    {
+      ASSERT_EQ(TreeDataToString(tree, options), SerializeWithLibXml(tree, options));
+    }
+  }
+
+  // Same exceptions for names that libxml2 rejects
+  TreeData bad_child{"root"};
+  bad_child.AddChild(TreeData{std::string(1, '\0')});
+  EXPECT_THROW(TreeDataToString(bad_child), SerializeException);
+  EXPECT_THROW(SerializeWithLibXml(bad_child), SerializeException);
+  TreeData bad_attribute{"root"};
+  bad_attribute.AddAttribute("", "value");
+  EXPECT_THROW(TreeDataToString(bad_attribute), SerializeException);
+  EXPECT_THROW(SerializeWithLibXml(bad_attribute), SerializeException);
+}
+
+TEST_F(TreeDataSerializeTest, Escaping)
+{
+  std::string output;
+  WriterOutput writer_output{output};
+  AppendEscapedContent(writer_output, "a<b>&\"'\t\n\r");
+  EXPECT_EQ(output, "a&lt;b&gt;&amp;&quot;'\t\n&#13;");
+  output.clear();
+  AppendEscapedAttribute(writer_output, "a<b>&\"'\t\n\r");
+  EXPECT_EQ(output, "a&lt;b&gt;&amp;&quot;'&#9;&#10;&#13;");
+  EXPECT_GE(EstimateSerializedSize(m_tree), TreeDataToString(m_tree).size());
+}
+
+TEST_F(TreeDataSerializeTest, Options)
+{
+  SerializeOptions compact;
+  compact.compact = true;
+  const std::string compact_body =
+    R"RAW(<MemberList><Member key="433"><Name format="full">Martha Thompson</Name>)RAW"
+    R"RAW(<Details country="FR" membership="gold"/></Member><Member key="23">)RAW"
+    R"RAW(<Name format="prename">Anna</Name><Details country="DE" membership="platina"/>)RAW"
+    R"RAW(</Member></MemberList>)RAW";
+  EXPECT_EQ(TreeDataToString(m_tree, compact), AddXMLHeader("\n" + compact_body + "\n"));
+  auto tree = TreeDataFromString(TreeDataToString(m_tree, compact));
+  EXPECT_EQ(*tree, m_tree);
+
+  SerializeOptions tabs;
+  tabs.indent = "\t";
+  auto tabbed = TreeDataToString(m_tree, tabs);
+  EXPECT_NE(tabbed.find("\n\t\t<Name format=\"full\">"), std::string::npos);
+  EXPECT_EQ(tabbed.find("  "), std::string::npos);
+}
+
+TEST_F(TreeDataSerializeTest, Compression)
+{
+  const std::string filename = "TreeDataSerializeTest_Compression";
+  sup::unit_test_helper::TemporaryTestFile tmp_file(filename, "");
+  SerializeOptions options;
+  options.compression = 9;
+  EXPECT_NO_THROW(TreeDataToFile(filename, m_tree, options));
+
+  // Check gzip magic number
+  std::ifstream file_in(filename, std::ios::binary);
+  char magic[2] = {0, 0};
+  file_in.read(magic, 2);
+  EXPECT_EQ(static_cast<unsigned char>(magic[0]), 0x1f);
+  EXPECT_EQ(static_cast<unsigned char>(magic[1]), 0x8b);
+
+  // Read back with all input methods
+  for (auto mode : { ParseMode::kDocument, ParseMode::kStreaming })
+  {
+    for (auto access : { FileAccess::kBuffered, FileAccess::kMemoryMapped })
+    {
+      auto tree = TreeDataFromFile(filename, mode, access);
+      ASSERT_TRUE(static_cast<bool>(tree));
+      EXPECT_EQ(*tree, m_tree);
+    }
+  }
+  std::vector<TreeData> records;
+  ParseTreeDataStream(filename, 1, [&records](TreeData& record) { records.push_back(record); });
+  EXPECT_EQ(records, m_tree.Children());
+  auto flat_tree = FlatTreeDataFromFile(filename);
+  EXPECT_EQ(TreeDataFromFlatTreeData(flat_tree), m_tree);
+
+  options.compression = 10;
+  EXPECT_THROW(TreeDataToFile(filename, m_tree, options), SerializeException);
+  options.compression = -1;
+  EXPECT_THROW(TreeDataToFile(filename, m_tree, options), SerializeException);
+}
+
+TEST_F(TreeDataSerializeTest, ToSink)
+{
+  const auto expected = TreeDataToString(m_tree);
+
+  // Small buffer results in many chunks, but the same output
+  std::string collected;
+  std::size_t n_chunks = 0;
+  CallbackSink callback_sink{[&collected, &n_chunks](const char* data, std::size_t size)
+                             {
+                               collected.append(data, size);
+                               ++n_chunks;
+                             }};
+  EXPECT_NO_THROW(TreeDataToSink(callback_sink, m_tree, {}, 16));
+  EXPECT_EQ(collected, expected);
+  EXPECT_GT(n_chunks, expected.size() / 16);
+
+  // Text larger than the buffer
+  TreeData large{"Large"};
+  large.SetContent(std::string(1000, 'x') + "<" + std::string(1000, 'y'));
+  large.AddAttribute("attr", std::string(500, 'z'));
+  collected.clear();
+  EXPECT_NO_THROW(TreeDataToSink(callback_sink, large, {}, 64));
+  EXPECT_EQ(collected, TreeDataToString(large));
+
+  std::ostringstream oss;
+  OStreamSink stream_sink{oss};
+  EXPECT_NO_THROW(TreeDataToSink(stream_sink, m_tree));
+  EXPECT_EQ(oss.str(), expected);
+
+  const std::string filename = "TreeDataSerializeTest_ToSink";
+  sup::unit_test_helper::TemporaryTestFile tmp_file(filename, "");
+  const int fd = open(filename.c_str(), O_WRONLY | O_TRUNC);
+  ASSERT_GE(fd, 0);
+  FileDescriptorSink fd_sink{fd};
+  EXPECT_NO_THROW(TreeDataToSink(fd_sink, m_tree, {}, 32));
+  (void)close(fd);
+  auto tree = TreeDataFromFile(filename);
+  EXPECT_EQ(*tree, m_tree);
+}
+
+TEST_F(TreeDataSerializeTest, SinkErrors)
+{
+  FileDescriptorSink bad_fd_sink{-1};
+  EXPECT_THROW(TreeDataToSink(bad_fd_sink, m_tree), SerializeException);
+
+  std::ostringstream oss;
+  oss.setstate(std::ios::badbit);
+  OStreamSink bad_stream_sink{oss};
+  EXPECT_THROW(TreeDataToSink(bad_stream_sink, m_tree), SerializeException);
+
+  std::string collected;
+  CallbackSink callback_sink{[&collected](const char* data, std::size_t size)
+                             { collected.append(data, size); }};
+  TreeData empty_node_name{""};
+  EXPECT_THROW(TreeDataToSink(callback_sink, empty_node_name), SerializeException);
+  EXPECT_TRUE(collected.empty());
+}
+
+TEST_F(TreeDataSerializeTest, DeepTree)
+{
+  // Compact output, since indentation would grow quadratically with the depth
+  const std::size_t depth = 200000;
+  TreeData tree{"Level"};
+  TreeData* current = &tree;
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+  }
+  current->SetContent("leaf");
+  SerializeOptions compact;
+  compact.compact = true;
+  const auto result = TreeDataToString(tree, compact);
+  std::string body;
+  for (std::size_t i = 0; i <= depth; ++i)
+  {
+    body += "<Level>";
+  }
+  body += "leaf";
+  for (std::size_t i = 0; i <= depth; ++i)
+  {
+    body += "</Level>";
+  }
+  EXPECT_EQ(result, AddXMLHeader("\n" + body + "\n"));
+  EXPECT_EQ(SerializeWithLibXml(tree, compact), result);
+}
+
 TreeDataSerializeTest::TreeDataSerializeTest()
   : m_tree{MEMBERLIST_NODE}
   , m_buffer{}
@@ -134,3 +365,13 @@ std::string TreeDataSerializeTest::AddXMLHeader(const std::string& body)
   static const std::string header{R"RAW(<?xml version="1.0" encoding="UTF-8"?>)RAW"};
   return header + body;
 }
+
+std::string TreeDataSerializeTest::SerializeWithLibXml(const TreeData& tree,
+                                                       const SerializeOptions& options)
+{
+  const XMLBufferHandle buffer{};
+  const XMLTextWriterHandle writer{xmlNewTextWriterMemory(buffer.Buffer(), 0)};
+  SerializeUsingWriter(writer.Writer(), tree, options);
+  (void)xmlTextWriterFlush(writer.Writer());
+  return std::string{reinterpret_cast<const char*>(xmlBufferContent(buffer.Buffer()))};
+}
@@ -27,6 +27,9 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <memory>
+
 using namespace sup::xml;
 
 const std::string MAIN_NODE_NAME = "MainNode";
@@ -211,6 +214,12 @@ TEST_F(TreeDataTest, NodeName)
   EXPECT_NE(tree_1.GetNodeName(), NODE_NAME_2);
   EXPECT_EQ(tree_2.GetNodeName(), NODE_NAME_2);
   EXPECT_NE(tree_2.GetNodeName(), NODE_NAME_1);
+
+  // Equal names share the same interned handle
+  TreeData tree_3{InternedString{NODE_NAME_1}};
+  EXPECT_EQ(tree_3.GetInternedNodeName().Handle(), tree_1.GetInternedNodeName().Handle());
+  EXPECT_NE(tree_3.GetInternedNodeName(), tree_2.GetInternedNodeName());
+  EXPECT_TRUE(tree_3.GetInternedNodeName() == NODE_NAME_1);
 }
 
 TEST_F(TreeDataTest, Attributes)
@@ -221,6 +230,7 @@ TEST_F(TreeDataTest, Attributes)
   EXPECT_EQ(tree.Attributes().size(), 0);
   EXPECT_FALSE(tree.HasAttribute(NAME_ATTRIBUTE));
   EXPECT_FALSE(tree.HasAttribute(ID_ATTRIBUTE));
+  EXPECT_FALSE(tree.HasAttribute("never_interned_attribute_name"));
   EXPECT_THROW(tree.GetAttribute(NAME_ATTRIBUTE), InvalidOperationException);
   EXPECT_THROW(tree.GetAttribute(ID_ATTRIBUTE), InvalidOperationException);
 
@@ -228,6 +238,7 @@ TEST_F(TreeDataTest, Attributes)
   EXPECT_NO_THROW(tree.AddAttribute(NAME_ATTRIBUTE, NAME_ATTRIBUTE_VALUE));
   EXPECT_EQ(tree.GetNumberOfAttributes(), 1);
   EXPECT_TRUE(tree.HasAttribute(NAME_ATTRIBUTE));
+  EXPECT_TRUE(tree.HasAttribute(InternedString{NAME_ATTRIBUTE}));
   EXPECT_FALSE(tree.HasAttribute(ID_ATTRIBUTE));
   auto name_val = tree.GetAttribute(NAME_ATTRIBUTE);
   EXPECT_EQ(name_val, NAME_ATTRIBUTE_VALUE);
@@ -247,6 +258,16 @@ TEST_F(TreeDataTest, Attributes)
   EXPECT_THROW(tree.AddAttribute(NAME_ATTRIBUTE, "does not matter"), InvalidOperationException);
   EXPECT_THROW(tree.AddAttribute(ID_ATTRIBUTE, "does not matter"), InvalidOperationException);
   EXPECT_EQ(tree.GetNumberOfAttributes(), 2);
+
+  // Reserved attributes are not reallocated while they are added
+  TreeData reserved{NODE_NAME_1};
+  reserved.ReserveAttributes(3);
+  reserved.AddAttribute("a", "1");
+  const auto* first = reserved.Attributes().data();
+  reserved.AddAttribute("b", "2");
+  reserved.AddAttribute("c", "3");
+  EXPECT_EQ(reserved.Attributes().data(), first);
+  EXPECT_EQ(reserved.GetNumberOfAttributes(), 3);
 }
 
 TEST_F(TreeDataTest, Children)
@@ -276,6 +297,218 @@ TEST_F(TreeDataTest, Children)
   EXPECT_EQ(children[1], child_2);
 }
 
+TEST_F(TreeDataTest, Views)
+{
+  TreeData tree{NODE_NAME_1};
+  EXPECT_EQ(tree.NodeName(), NODE_NAME_1);
+  EXPECT_TRUE(tree.Content().empty());
+  EXPECT_EQ(tree.FindAttribute(NAME_ATTRIBUTE), nullptr);
+
+  tree.SetContent("Content");
+  tree.AddAttribute(NAME_ATTRIBUTE, NAME_ATTRIBUTE_VALUE);
+  tree.AddAttribute(ID_ATTRIBUTE, ID_ATTRIBUTE_VALUE);
+  EXPECT_EQ(tree.Content(), "Content");
+  auto name_val = tree.FindAttribute(NAME_ATTRIBUTE);
+  ASSERT_NE(name_val, nullptr);
+  EXPECT_EQ(*name_val, NAME_ATTRIBUTE_VALUE);
+  auto id_val = tree.FindAttribute(std::string_view{ID_ATTRIBUTE});
+  ASSERT_NE(id_val, nullptr);
+  EXPECT_EQ(*id_val, ID_ATTRIBUTE_VALUE);
+  EXPECT_EQ(tree.FindAttribute("Unknown"), nullptr);
+}
+
+TEST_F(TreeDataTest, MoveChildren)
+{
+  TreeData tree{NODE_NAME_1};
+
+  // Add moved child
+  TreeData child_1{CHILD_NODE_NAME};
+  child_1.AddAttribute(NAME_ATTRIBUTE, NAME_ATTRIBUTE_VALUE);
+  TreeData child_1_copy{child_1};
+  tree.AddChild(std::move(child_1));
+  ASSERT_EQ(tree.GetNumberOfChildren(), 1);
+  EXPECT_EQ(tree.Children()[0], child_1_copy);
+
+  // Emplace child and modify it in place
+  auto& child_2 = tree.EmplaceChild(CHILD_NODE_NAME);
+  std::string content = "child 2 content";
+  child_2.SetContent(std::move(content));
+  child_2.AddAttribute(std::string{ID_ATTRIBUTE}, std::string{ID_ATTRIBUTE_VALUE});
+  ASSERT_EQ(tree.GetNumberOfChildren(), 2);
+  const auto& emplaced = tree.Children()[1];
+  EXPECT_EQ(emplaced.GetNodeName(), CHILD_NODE_NAME);
+  EXPECT_EQ(emplaced.GetContent(), "child 2 content");
+  EXPECT_EQ(emplaced.GetAttribute(ID_ATTRIBUTE), ID_ATTRIBUTE_VALUE);
+  EXPECT_THROW(child_2.AddAttribute(ID_ATTRIBUTE, "does not matter"), InvalidOperationException);
+}
+
+TEST_F(TreeDataTest, Hash)
+{
+  TreeData left{"Root"};
+  left.AddAttribute("a", "1");
+  left.AddAttribute("b", "2");
+  left.AddAttribute("c", "3");
+  left.SetContent("content");
+  left.EmplaceChild("Child").AddAttribute("x", "y");
+  left.AddChild(TreeData{"Other"});
+
+  // Attribute order does not matter
+  TreeData right{"Root"};
+  right.AddAttribute("c", "3");
+  right.AddAttribute("a", "1");
+  right.AddAttribute("b", "2");
+  right.SetContent("content");
+  right.EmplaceChild("Child").AddAttribute("x", "y");
+  right.AddChild(TreeData{"Other"});
+  EXPECT_EQ(left, right);
+  EXPECT_EQ(Hash(left), Hash(right));
+  EXPECT_EQ(std::hash<TreeData>{}(left), Hash(left));
+
+  // Changes anywhere in the tree
+  auto changed_attribute = right;
+  changed_attribute.AddAttribute("d", "4");
+  EXPECT_NE(left, changed_attribute);
+  EXPECT_NE(Hash(left), Hash(changed_attribute));
+  TreeData swapped_values{"Root"};
+  swapped_values.AddAttribute("a", "2");
+  swapped_values.AddAttribute("b", "1");
+  swapped_values.AddAttribute("c", "3");
+  swapped_values.SetContent("content");
+  swapped_values.EmplaceChild("Child").AddAttribute("x", "y");
+  swapped_values.AddChild(TreeData{"Other"});
+  EXPECT_NE(left, swapped_values);
+  EXPECT_NE(Hash(left), Hash(swapped_values));
+  TreeData changed_child{"Root"};
+  changed_child.AddAttribute("a", "1");
+  changed_child.AddAttribute("b", "2");
+  changed_child.AddAttribute("c", "3");
+  changed_child.SetContent("content");
+  changed_child.EmplaceChild("Child").AddAttribute("x", "z");
+  changed_child.AddChild(TreeData{"Other"});
+  EXPECT_NE(left, changed_child);
+  EXPECT_NE(Hash(left), Hash(changed_child));
+
+  // Child order matters, as does the nesting
+  TreeData ab{"Root"};
+  ab.AddChild(TreeData{"A"});
+  ab.AddChild(TreeData{"B"});
+  TreeData ba{"Root"};
+  ba.AddChild(TreeData{"B"});
+  ba.AddChild(TreeData{"A"});
+  EXPECT_NE(ab, ba);
+  EXPECT_NE(Hash(ab), Hash(ba));
+  TreeData nested{"Root"};
+  nested.EmplaceChild("A").AddChild(TreeData{"B"});
+  EXPECT_NE(ab, nested);
+  EXPECT_NE(Hash(ab), Hash(nested));
+}
+
+TEST_F(TreeDataTest, DeepEquality)
+{
+  TreeData left{"Level"};
+  TreeData* current = &left;
+  for (int i = 0; i < 5000; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+  }
+  const TreeData right{left};
+  EXPECT_EQ(left, right);
+  EXPECT_EQ(Hash(left), Hash(right));
+  current->SetContent("changed");
+  EXPECT_NE(left, right);
+  EXPECT_NE(Hash(left), Hash(right));
+}
+
+TEST_F(TreeDataTest, DeepTree)
+{
+  // Deep enough to overflow the stack if copying, comparing or destroying recursed
+  const std::size_t depth = 200000;
+  auto tree = std::make_unique<TreeData>("Level");
+  TreeData* current = tree.get();
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+    current->AddAttribute("index", std::to_string(i));
+  }
+  auto copy = std::make_unique<TreeData>(*tree);
+  EXPECT_EQ(*copy, *tree);
+  TreeData assigned{"Other"};
+  assigned = *copy;
+  EXPECT_EQ(assigned, *tree);
+  // Self-assignment and assignment from a subtree
+  assigned = assigned;
+  EXPECT_EQ(assigned, *tree);
+  assigned = assigned.Children()[0];
+  EXPECT_EQ(assigned, tree->Children()[0]);
+  EXPECT_NE(assigned, *tree);
+  copy.reset();
+  tree.reset();
+}
+
+TEST_F(TreeDataTest, FindChildren)
+{
+  // Few children: lookups scan the list
+  TreeData small{"Small"};
+  small.AddChild(TreeData{"a"});
+  small.AddChild(TreeData{"b"});
+  small.AddChild(TreeData{"a"});
+  ASSERT_NE(small.FindChild("a"), nullptr);
+  EXPECT_EQ(small.FindChild("a"), &small.Children()[0]);
+  EXPECT_EQ(small.FindChild(InternedString{"b"}), &small.Children()[1]);
+  EXPECT_EQ(small.FindChild("c"), nullptr);
+  EXPECT_EQ(small.FindChild("TreeDataTest_never_interned_tag"), nullptr);
+  EXPECT_EQ(small.CountChildren("a"), 2);
+  EXPECT_EQ(small.CountChildren("TreeDataTest_never_interned_tag"), 0);
+  auto found = small.FindChildren("a");
+  ASSERT_EQ(found.size(), 2);
+  EXPECT_EQ(found[0], &small.Children()[0]);
+  EXPECT_EQ(found[1], &small.Children()[2]);
+
+  // Many children: lookups use the index, which must follow later additions
+  TreeData large{"Large"};
+  for (int i = 0; i < 1000; ++i)
+  {
+    (void)large.EmplaceChild("item" + std::to_string(i % 10));
+  }
+  EXPECT_EQ(large.CountChildren("item3"), 100);
+  EXPECT_EQ(large.FindChild("item3"), &large.Children()[3]);
+  EXPECT_EQ(large.FindChild("extra"), nullptr);
+  large.AddChild(TreeData{"extra"});
+  EXPECT_EQ(large.FindChild("extra"), &large.Children()[1000]);
+  (void)large.EmplaceChild("item3");
+  EXPECT_EQ(large.CountChildren("item3"), 101);
+  found = large.FindChildren("item3");
+  ASSERT_EQ(found.size(), 101);
+  EXPECT_EQ(found.back(), &large.Children().back());
+
+  // Replacing the last emplaced child through its reference, after the index was built
+  TreeData renamed{"Renamed"};
+  for (int i = 0; i < 20; ++i)
+  {
+    (void)renamed.EmplaceChild("a");
+  }
+  auto& last = renamed.EmplaceChild("a");
+  EXPECT_EQ(renamed.CountChildren("a"), 21);
+  last = TreeData{"b"};
+  EXPECT_EQ(renamed.CountChildren("a"), 20);
+  EXPECT_EQ(renamed.CountChildren("b"), 1);
+  EXPECT_EQ(renamed.FindChild("b"), &renamed.Children()[20]);
+  EXPECT_EQ(renamed.FindChildren("a").size(), 20);
+
+  // Copies and moves keep lookups consistent with their own children
+  TreeData copy{large};
+  EXPECT_EQ(copy.FindChild("extra"), &copy.Children()[1000]);
+  TreeData moved{std::move(copy)};
+  EXPECT_EQ(moved.FindChild("extra"), &moved.Children()[1000]);
+  EXPECT_EQ(moved.CountChildren("item3"), 101);
+  moved = small;
+  EXPECT_EQ(moved.CountChildren("item3"), 0);
+  EXPECT_EQ(moved.CountChildren("a"), 2);
+  large = std::move(moved);
+  EXPECT_EQ(large.FindChild("extra"), nullptr);
+  EXPECT_EQ(large.FindChild("b"), &large.Children()[1]);
+}
+
 TreeDataTest::TreeDataTest() = default;
 
 TreeDataTest::~TreeDataTest() = default;
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * $HeadURL: $
+ * $Id: $
+ *
+ * Project       : Supervision and Automation System Utilities
+ *
+ * Description   : SUP XML utilities
+ *
+ * Author        : Walter Van Herck (IO)
+ *
+ * Copyright (c) : 2010-2026 ITER Organization,
+ *                 CS 90 046
+ *                 13067 St. Paul-lez-Durance Cedex
+ *                 France
+ * SPDX-License-Identifier: MIT
+ *
+ * This file is part of ITER CODAC software.
+ * For the terms and conditions of redistribution or use of this software
+ * refer to the file LICENSE located in the top level directory
+ * of the distribution package.
+ ******************************************************************************/
+
+#include <sup/xml/tree_data_parser.h>
+#include <sup/xml/tree_data_traversal.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace sup::xml;
+
+static const std::string XML_BODY = R"RAW(
+<A>
+  <B>
+    <D/>
+    <E><F/></E>
+  </B>
+  <C>
+    <G/>
+  </C>
+</A>
+)RAW";
+
+class TreeDataTraversalTest : public ::testing::Test
+{
+protected:
+  TreeDataTraversalTest();
+  virtual ~TreeDataTraversalTest();
+
+  std::unique_ptr<TreeData> m_tree;
+};
+
+TEST_F(TreeDataTraversalTest, PreOrder)
+{
+  std::string names;
+  std::vector<std::size_t> depths;
+  for (auto it = TreeDataPreOrderIterator{*m_tree}; it != TreeDataPreOrderIterator{}; ++it)
+  {
+    names += it->GetNodeName();
+    depths.push_back(it.Depth());
+  }
+  EXPECT_EQ(names, "ABDEFCG");
+  EXPECT_EQ(depths, std::vector<std::size_t>({0, 1, 2, 2, 3, 1, 2}));
+
+  names.clear();
+  for (const auto& node : PreOrder(*m_tree))
+  {
+    names += node.GetNodeName();
+  }
+  EXPECT_EQ(names, "ABDEFCG");
+
+  // Skip the children of B and E
+  names.clear();
+  for (auto it = TreeDataPreOrderIterator{*m_tree}; it != TreeDataPreOrderIterator{}; ++it)
+  {
+    names += it->GetNodeName();
+    if (it->GetNodeName() == "B" || it->GetNodeName() == "G")
+    {
+      it.SkipChildren();
+    }
+  }
+  EXPECT_EQ(names, "ABCG");
+
+  TreeData leaf{"leaf"};
+  auto it = TreeDataPreOrderIterator{leaf};
+  EXPECT_EQ(&*it++, &leaf);
+  EXPECT_EQ(it, TreeDataPreOrderIterator{});
+}
+
+TEST_F(TreeDataTraversalTest, PostOrder)
+{
+  std::string names;
+  std::vector<std::size_t> depths;
+  for (auto it = TreeDataPostOrderIterator{*m_tree}; it != TreeDataPostOrderIterator{}; ++it)
+  {
+    names += it->GetNodeName();
+    depths.push_back(it.Depth());
+  }
+  EXPECT_EQ(names, "DFEBGCA");
+  EXPECT_EQ(depths, std::vector<std::size_t>({2, 3, 2, 1, 2, 1, 0}));
+
+  names.clear();
+  for (const auto& node : PostOrder(*m_tree))
+  {
+    names += node.GetNodeName();
+  }
+  EXPECT_EQ(names, "DFEBGCA");
+
+  TreeData leaf{"leaf"};
+  auto it = TreeDataPostOrderIterator{leaf};
+  EXPECT_EQ(&*it++, &leaf);
+  EXPECT_EQ(it, TreeDataPostOrderIterator{});
+}
+
+TEST_F(TreeDataTraversalTest, Visit)
+{
+  std::string trace;
+  auto on_enter = [&trace](const TreeData& node, std::size_t depth)
+  {
+    trace += "<" + node.GetNodeName() + std::to_string(depth);
+    return node.GetNodeName() == "E" ? VisitAction::kSkipChildren : VisitAction::kContinue;
+  };
+  auto on_leave = [&trace](const TreeData& node, std::size_t)
+  {
+    trace += ">" + node.GetNodeName();
+    return VisitAction::kContinue;
+  };
+  EXPECT_TRUE(Visit(*m_tree, on_enter, on_leave));
+  EXPECT_EQ(trace, "<A0<B1<D2>D<E2>E>B<C1<G2>G>C>A");
+
+  // Early exit, from either callback
+  trace.clear();
+  auto stop_at_c = [&trace](const TreeData& node, std::size_t)
+  {
+    trace += node.GetNodeName();
+    return node.GetNodeName() == "C" ? VisitAction::kStop : VisitAction::kContinue;
+  };
+  EXPECT_FALSE(Visit(*m_tree, stop_at_c));
+  EXPECT_EQ(trace, "ABDEFC");
+  trace.clear();
+  EXPECT_FALSE(Visit(*m_tree, {}, stop_at_c));
+  EXPECT_EQ(trace, "DFEBGC");
+
+  // Skipping the root
+  trace.clear();
+  EXPECT_TRUE(Visit(*m_tree, [](const TreeData&, std::size_t)
+                    { return VisitAction::kSkipChildren; }, on_leave));
+  EXPECT_EQ(trace, ">A");
+}
+
+TEST_F(TreeDataTraversalTest, DeepTree)
+{
+  const std::size_t depth = 200000;
+  TreeData tree{"Level"};
+  TreeData* current = &tree;
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    current = &current->EmplaceChild("Level");
+  }
+  std::size_t count = 0;
+  std::size_t max_depth = 0;
+  for (auto it = TreeDataPreOrderIterator{tree}; it != TreeDataPreOrderIterator{}; ++it)
+  {
+    ++count;
+    max_depth = std::max(max_depth, it.Depth());
+  }
+  EXPECT_EQ(count, depth + 1);
+  EXPECT_EQ(max_depth, depth);
+  count = 0;
+  for (const auto& node : PostOrder(tree))
+  {
+    (void)node;
+    ++count;
+  }
+  EXPECT_EQ(count, depth + 1);
+  count = 0;
+  EXPECT_TRUE(Visit(tree, [&count](const TreeData&, std::size_t)
+                    {
+                      ++count;
+                      return VisitAction::kContinue;
+                    }));
+  EXPECT_EQ(count, depth + 1);
+}
+
+TreeDataTraversalTest::TreeDataTraversalTest()
+  : m_tree{TreeDataFromString(XML_BODY)}
+{}
+
+TreeDataTraversalTest::~TreeDataTraversalTest() = default;
@@ -54,9 +54,29 @@ TEST_F(TreeDataValidateTest, AllowedChildTags)
   TreeData child{CHILD_ELEMENT_NAME};
   tree.AddChild(child);
   EXPECT_NO_THROW(ValidateAllowedChildTags(tree, allowed_tags));
+  EXPECT_NO_THROW(ValidateAllowedChildTags(tree, {"Other", "child"}));
   TreeData wrong_child{"NotAllowed"};
   tree.AddChild(wrong_child);
   EXPECT_THROW(ValidateAllowedChildTags(tree, allowed_tags), ValidationException);
+  EXPECT_THROW(ValidateAllowedChildTags(tree, {"Other", "child"}), ValidationException);
+}
+
+TEST_F(TreeDataValidateTest, InternedTags)
+{
+  const InternedString child_tag{CHILD_ELEMENT_NAME};
+  std::vector<InternedString> allowed_tags = { child_tag };
+  TreeData tree{ROOT_ELEMENT_NAME};
+  EXPECT_THROW(ValidateSingleChildWithInternedTag(tree, child_tag), ValidationException);
+  EXPECT_NO_THROW(ValidateAllowedInternedChildTags(tree, allowed_tags));
+  TreeData child{CHILD_ELEMENT_NAME};
+  tree.AddChild(child);
+  EXPECT_NO_THROW(ValidateSingleChildWithInternedTag(tree, child_tag));
+  EXPECT_NO_THROW(ValidateAllowedInternedChildTags(tree, allowed_tags));
+  tree.AddChild(child);
+  EXPECT_THROW(ValidateSingleChildWithInternedTag(tree, child_tag), ValidationException);
+  TreeData wrong_child{"NotAllowed"};
+  tree.AddChild(wrong_child);
+  EXPECT_THROW(ValidateAllowedInternedChildTags(tree, allowed_tags), ValidationException);
 }
 
 TEST_F(TreeDataValidateTest, NoAttributes)
@@ -84,6 +104,69 @@ TEST_F(TreeDataValidateTest, NoContent)
   EXPECT_THROW(ValidateNoContent(tree), ValidationException);
 }
 
+TEST_F(TreeDataValidateTest, Schema)
+{
+  ElementRule root_rule;
+  root_rule.tag = ROOT_ELEMENT_NAME;
+  root_rule.children = { { CHILD_ELEMENT_NAME, 1, 2 }, { "optional", 0, 1 } };
+  root_rule.required_attributes = { "name" };
+  root_rule.content = ContentRule::kNone;
+  ElementRule child_rule;
+  child_rule.tag = CHILD_ELEMENT_NAME;
+  child_rule.allow_other_children = true;
+  child_rule.forbidden_attributes = { "name" };
+  child_rule.content = ContentRule::kRequired;
+  const TreeDataSchema schema{{ root_rule, child_rule }, ROOT_ELEMENT_NAME};
+
+  TreeData tree{ROOT_ELEMENT_NAME};
+  tree.AddAttribute("name", "valid");
+  auto& child = tree.EmplaceChild(CHILD_ELEMENT_NAME);
+  child.SetContent("content");
+  (void)child.EmplaceChild("anything");
+  EXPECT_TRUE(schema.Validate(tree).empty());
+  EXPECT_NO_THROW(ValidateTreeData(tree, schema));
+
+  // All violations are reported, each with the path of the offending element
+  TreeData invalid{ROOT_ELEMENT_NAME};
+  invalid.SetContent("not allowed");
+  auto& first = invalid.EmplaceChild(CHILD_ELEMENT_NAME);
+  first.AddAttribute("name", "forbidden");
+  first.SetContent("content");
+  (void)invalid.EmplaceChild("unknown");
+  (void)invalid.EmplaceChild(CHILD_ELEMENT_NAME);
+  (void)invalid.EmplaceChild(CHILD_ELEMENT_NAME);
+  const auto violations = schema.Validate(invalid);
+  ASSERT_EQ(violations.size(), 7);
+  const std::vector<std::size_t> root_path{};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(violations[i].path, root_path);
+  }
+  EXPECT_EQ(violations[4].path, std::vector<std::size_t>({0}));
+  EXPECT_EQ(violations[5].path, std::vector<std::size_t>({2}));
+  EXPECT_EQ(violations[6].path, std::vector<std::size_t>({3}));
+  EXPECT_THROW(ValidateTreeData(invalid, schema), ValidationException);
+
+  TreeData wrong_root{CHILD_ELEMENT_NAME};
+  wrong_root.SetContent("content");
+  ASSERT_EQ(schema.Validate(wrong_root).size(), 1);
+}
+
+TEST_F(TreeDataValidateTest, SchemaCompileErrors)
+{
+  ElementRule rule;
+  rule.tag = ROOT_ELEMENT_NAME;
+  EXPECT_THROW(TreeDataSchema({ rule, rule }), InvalidOperationException);
+  rule.children = { { CHILD_ELEMENT_NAME, 2, 1 } };
+  EXPECT_THROW(TreeDataSchema({ rule }), InvalidOperationException);
+  rule.children = { { CHILD_ELEMENT_NAME }, { CHILD_ELEMENT_NAME } };
+  EXPECT_THROW(TreeDataSchema({ rule }), InvalidOperationException);
+  rule.children.clear();
+  rule.required_attributes = { "name" };
+  rule.forbidden_attributes = { "name" };
+  EXPECT_THROW(TreeDataSchema({ rule }), InvalidOperationException);
+}
+
 TreeDataValidateTest::TreeDataValidateTest() = default;
 
 TreeDataValidateTest::~TreeDataValidateTest() = default;
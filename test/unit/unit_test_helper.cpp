@@ -25,6 +25,8 @@
 #include <fstream>
 #include <sstream>
 
+#include <malloc.h>
+
 namespace sup
 {
 namespace unit_test_helper
@@ -42,6 +44,11 @@ TemporaryTestFile::~TemporaryTestFile()
   std::remove(m_filename.c_str());
 }
 
+std::size_t AllocatedHeapBytes()
+{
+  return mallinfo2().uordblks;
+}
+
 }  // namespace unit_test_helper
 
 }  // namespace sup
@@ -24,6 +24,7 @@
 #define SUP_XML_UNIT_TEST_HELPER_H_
 
 #include <chrono>
+#include <cstddef>
 #include <string>
 #include <thread>
 
@@ -41,6 +42,13 @@ public:
   ~TemporaryTestFile();
 };
 
+/**
+ * @brief Number of bytes currently allocated on the heap by the process.
+ *
+ * @note Sanitizer builds replace the heap and report zero; they detect leaks themselves.
+ */
+std::size_t AllocatedHeapBytes();
+
 }  // namespace unit_test_helper
 
 }  // namespace sup